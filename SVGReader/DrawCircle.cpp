@@ -5,16 +5,15 @@ using namespace Gdiplus;
 
 void GdiPlusRenderer::DrawCircle(const SvgCircle &circle)
 {
-    GraphicsState state = graphics.Save();
-    ApplyTransform(graphics, circle.transformAttribute);
-    Pen pen(circle.strokeColor, circle.strokeWidth);
+    GraphicsState state = BeginElement(circle);
+    const SvgStyle &style = StyleOf(circle);
+    Pen pen(style.strokeColor, style.strokeWidth);
     
     float d = circle.r * 2.0f;
-    RectF bounds(circle.cx - circle.r, circle.cy - circle.r, d, d);
-    auto brush = CreateFillBrush(circle.fillUrl, circle.fillColor, circle.fillOpacity, bounds);
+    auto brush = CreateFillBrush(style, circle.fillBox);
 
     if (brush)
         graphics.FillEllipse(brush.get(), circle.cx - circle.r, circle.cy - circle.r, d, d);
     graphics.DrawEllipse(&pen, circle.cx - circle.r, circle.cy - circle.r, d, d);
-    graphics.Restore(state);
+    EndElement(state);
 }
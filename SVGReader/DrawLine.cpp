@@ -5,9 +5,9 @@ using namespace Gdiplus;
 
 void GdiPlusRenderer::DrawLine(const SvgLine &line)
 {
-    GraphicsState state = graphics.Save();
-    ApplyTransform(graphics, line.transformAttribute);
-    Pen pen(line.strokeColor, line.strokeWidth);
+    GraphicsState state = BeginElement(line);
+    const SvgStyle &style = StyleOf(line);
+    Pen pen(style.strokeColor, style.strokeWidth);
     graphics.DrawLine(&pen, line.x1, line.y1, line.x2, line.y2);
-    graphics.Restore(state);
+    EndElement(state);
 }
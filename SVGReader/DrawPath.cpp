@@ -3,31 +3,80 @@
 
 using namespace Gdiplus;
 
+namespace
+{
+    // Lays PathData out as the point/type arrays GraphicsPath is built from.
+    // A MoveTo only becomes a start point once something is drawn from it,
+    // so stray movetos do not leave one-point figures behind.
+    void ToGdiPlusPoints(const PathData &data, std::vector<PointF> &points, std::vector<BYTE> &types)
+    {
+        const float *c = data.Coords().data();
+        bool figureOpen = false;
+        PointF start;
+        for (PathVerb verb : data.Verbs())
+        {
+            switch (verb)
+            {
+            case PathVerb::MoveTo:
+                start = PointF(c[0], c[1]);
+                figureOpen = false;
+                break;
+            case PathVerb::LineTo:
+            case PathVerb::CubicTo:
+            {
+                if (!figureOpen)
+                {
+                    points.push_back(start);
+                    types.push_back(PathPointTypeStart);
+                    figureOpen = true;
+                }
+                const BYTE type = verb == PathVerb::LineTo ? PathPointTypeLine : PathPointTypeBezier;
+                for (size_t i = 0; i < PathData::CoordCount(verb); i += 2)
+                {
+                    points.push_back(PointF(c[i], c[i + 1]));
+                    types.push_back(type);
+                }
+                break;
+            }
+            case PathVerb::Close:
+                if (figureOpen)
+                    types.back() |= PathPointTypeCloseSubpath;
+                figureOpen = false;
+                break;
+            }
+            c += PathData::CoordCount(verb);
+        }
+    }
+}
+
 void GdiPlusRenderer::DrawPath(const SvgPath &path)
 {
-    if (!path.pathData)
+    std::vector<PointF> points;
+    std::vector<BYTE> types;
+    ToGdiPlusPoints(path.pathData, points, types);
+    if (points.empty())
         return;
+    const SvgStyle &style = StyleOf(path);
+    GraphicsPath gdiPath(points.data(), types.data(), static_cast<INT>(points.size()),
+                         style.evenOddFill ? FillModeAlternate : FillModeWinding);
+
+    GraphicsState state = BeginElement(path);
+    Pen pen(style.strokeColor, style.strokeWidth);
 
-    GraphicsState state = graphics.Save();
-    ApplyTransform(graphics, path.transformAttribute);
-    Pen pen(path.strokeColor, path.strokeWidth);
-    
-    RectF bounds;
-    path.pathData->GetBounds(&bounds);
-    auto brush = CreateFillBrush(path.fillUrl, path.fillColor, path.fillOpacity, bounds);
+    auto brush = CreateFillBrush(style, path.fillBox);
 
-    if (brush && (path.fillColor.GetAlpha() > 0 || !path.fillUrl.empty()))
+    if (brush && (style.fillColor.GetAlpha() > 0 || style.fillUrl != 0))
     {
-        graphics.FillPath(brush.get(), path.pathData.get());
+        graphics.FillPath(brush.get(), &gdiPath);
     }
 
-    if (path.strokeColor.GetAlpha() > 0 && path.strokeWidth > 0.0f)
+    if (style.strokeColor.GetAlpha() > 0 && style.strokeWidth > 0.0f)
     {
         pen.SetLineJoin(LineJoinRound);
         pen.SetStartCap(LineCapRound);
         pen.SetEndCap(LineCapRound);
         pen.SetAlignment(PenAlignmentInset);
-        graphics.DrawPath(&pen, path.pathData.get());
+        graphics.DrawPath(&pen, &gdiPath);
     }
-    graphics.Restore(state);
+    EndElement(state);
 }
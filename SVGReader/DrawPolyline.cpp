@@ -7,14 +7,14 @@ void GdiPlusRenderer::DrawPolyline(const SvgPolyline& polyline)
 {
     if (polyline.points.size() < 2)
         return;
-    GraphicsState state = graphics.Save();
-    ApplyTransform(graphics, polyline.transformAttribute);
-    Pen pen(polyline.strokeColor, polyline.strokeWidth);
-    SolidBrush brush(polyline.fillColor);
+    GraphicsState state = BeginElement(polyline);
+    const SvgStyle &style = StyleOf(polyline);
+    Pen pen(style.strokeColor, style.strokeWidth);
+    SolidBrush brush(style.fillColor);
     graphics.FillPolygon(&brush, polyline.points.data(), static_cast<INT>(polyline.points.size()));
-    if (polyline.strokeColor.GetAlpha() > 0)
+    if (style.strokeColor.GetAlpha() > 0)
     {
         graphics.DrawLines(&pen, polyline.points.data(), static_cast<INT>(polyline.points.size()));
     }
-    graphics.Restore(state);
+    EndElement(state);
 }
\ No newline at end of file
@@ -5,15 +5,14 @@ using namespace Gdiplus;
 
 void GdiPlusRenderer::DrawRect(const SvgRect &rect)
 {
-    GraphicsState state = graphics.Save();
-    ApplyTransform(graphics, rect.transformAttribute);
-    Pen pen(rect.strokeColor, rect.strokeWidth);
+    GraphicsState state = BeginElement(rect);
+    const SvgStyle &style = StyleOf(rect);
+    Pen pen(style.strokeColor, style.strokeWidth);
     
-    RectF bounds(rect.x, rect.y, rect.w, rect.h);
-    auto brush = CreateFillBrush(rect.fillUrl, rect.fillColor, rect.fillOpacity, bounds);
+    auto brush = CreateFillBrush(style, rect.fillBox);
     
     if (brush)
         graphics.FillRectangle(brush.get(), rect.x, rect.y, rect.w, rect.h);
     graphics.DrawRectangle(&pen, rect.x, rect.y, rect.w, rect.h);
-    graphics.Restore(state);
+    EndElement(state);
 }
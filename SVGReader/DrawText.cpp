@@ -4,7 +4,7 @@
 using namespace Gdiplus;
 
 // Make sure at least one font is loaded....... I HATE THIS BUG
-static std::wstring ResolveSvgFontFamily(const std::wstring& svgFont)
+static std::wstring ResolveSvgFontFamily(std::wstring_view svgFont)
 {
     // Default fallback
     if (svgFont.empty())
@@ -15,10 +15,10 @@ static std::wstring ResolveSvgFontFamily(const std::wstring& svgFont)
     while (start < svgFont.size())
     {
         size_t end = svgFont.find(L',', start);
-        if (end == std::wstring::npos)
+        if (end == std::wstring_view::npos)
             end = svgFont.size();
 
-        std::wstring f = svgFont.substr(start, end - start);
+        std::wstring f(svgFont.substr(start, end - start));
 
         // Remove quotes
         f.erase(std::remove(f.begin(), f.end(), L'\"'), f.end());
@@ -53,10 +53,12 @@ static std::wstring ResolveSvgFontFamily(const std::wstring& svgFont)
 
 void GdiPlusRenderer::DrawText(const SvgText& text)
 {
-    GraphicsState state = graphics.Save();
-    ApplyTransform(graphics, text.transformAttribute);
+    GraphicsState state = BeginElement(text);
+    const SvgStyle &style = StyleOf(text);
 
-    std::wstring family = ResolveSvgFontFamily(text.fontFamily);
+    // Family names are ASCII; they were read byte for byte.
+    std::string_view named = styles ? styles->GetString(style.fontFamily) : std::string_view();
+    std::wstring family = ResolveSvgFontFamily(std::wstring(named.begin(), named.end()));
 
     std::unique_ptr<FontFamily> fontFamily =
         std::make_unique<FontFamily>(family.c_str());
@@ -66,16 +68,16 @@ void GdiPlusRenderer::DrawText(const SvgText& text)
         fontFamily = std::make_unique<FontFamily>(L"Arial");
     }
 
-    Gdiplus::Font font(fontFamily.get(), text.fontSize,
+    Gdiplus::Font font(fontFamily.get(), style.fontSize,
         FontStyleRegular, UnitPixel);
 
-    SolidBrush brush(text.fillColor);
+    SolidBrush brush(style.fillColor);
 
     // Create a string format to respect text anchor
     Gdiplus::StringFormat format;       
-    if (text.textAnchor == "middle")
+    if (style.textAnchor == SvgTextAnchor::Middle)
         format.SetAlignment(StringAlignmentCenter);
-    else if (text.textAnchor == "end" || text.textAnchor == "right")
+    else if (style.textAnchor == SvgTextAnchor::End)
         format.SetAlignment(StringAlignmentFar);
     else
         format.SetAlignment(StringAlignmentNear);
@@ -88,23 +90,23 @@ void GdiPlusRenderer::DrawText(const SvgText& text)
         ascent = static_cast<REAL>(fontFamily->GetCellAscent(FontStyleRegular));
         emHeight = static_cast<REAL>(fontFamily->GetEmHeight(FontStyleRegular));
     }
-    REAL ascentPx = (emHeight != 0.0f) ? (text.fontSize * ascent / emHeight) : 0.0f;
+    REAL ascentPx = (emHeight != 0.0f) ? (style.fontSize * ascent / emHeight) : 0.0f;
 
    
     Gdiplus::GraphicsPath path;
     path.AddString(text.text.c_str(), -1, fontFamily.get(), FontStyleRegular,
-        text.fontSize, PointF(text.x, text.y - ascentPx), &format);
+        style.fontSize, PointF(text.x, text.y - ascentPx), &format);
 
    
-    if (text.fillColor.GetAlpha() > 0)
+    if (style.fillColor.GetAlpha() > 0)
         graphics.FillPath(&brush, &path);
 
-    if (text.strokeColor.GetAlpha() > 0 && text.strokeWidth > 0.0f)
+    if (style.strokeColor.GetAlpha() > 0 && style.strokeWidth > 0.0f)
     {
-        Gdiplus::Pen pen(text.strokeColor, text.strokeWidth);
+        Gdiplus::Pen pen(style.strokeColor, style.strokeWidth);
         pen.SetLineJoin(LineJoinRound);
         graphics.DrawPath(&pen, &path);
     }               
             
-    graphics.Restore(state);
+    EndElement(state);
 }
\ No newline at end of file
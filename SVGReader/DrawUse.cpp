@@ -0,0 +1,20 @@
+#include "stdafx.h"
+#include "GdiPlusRenderer.h"
+
+using namespace Gdiplus;
+
+void GdiPlusRenderer::DrawUse(const SvgUse &use)
+{
+    if (!use.target)
+        return;
+    GraphicsState state = graphics.Save();
+    ApplyTransform(graphics, use.transform);
+    // The target is shared by all its uses, so this use's paint is only
+    // applied while it is drawn (see StyleOf), never stored in it.
+    const SvgStyle &handed = styles ? (*styles)[use.style] : SvgStyle();
+    const SvgInheritedStyle outer = instances.empty() ? SvgInheritedStyle() : instances.back();
+    instances.push_back(PassPaint(handed, outer));
+    use.target->Draw(*this);
+    instances.pop_back();
+    graphics.Restore(state);
+}
@@ -4,8 +4,9 @@
 
 using namespace Gdiplus;
 
-std::unique_ptr<Brush> GdiPlusGradientRenderer::CreateBrush(const std::shared_ptr<SvgGradient> &gradient, const RectF &bounds, float opacity)
+std::unique_ptr<Brush> GdiPlusGradientRenderer::CreateBrush(const Graphics &graphics, const SvgGradient &gradient,
+                                                           const RectF &bounds, float opacity)
 {
     // Delegate to the new SvgPaintResolver class
-    return SvgPaintResolver::CreateBrush(gradient, bounds, opacity);
+    return SvgPaintResolver::CreateBrush(graphics, gradient, bounds, opacity);
 }
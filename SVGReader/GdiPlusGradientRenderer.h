@@ -7,7 +7,8 @@
 class GdiPlusGradientRenderer
 {
 public:
-    static std::unique_ptr<Gdiplus::Brush> CreateBrush(const std::shared_ptr<SvgGradient> &gradient, const Gdiplus::RectF &bounds, float opacity = 1.0f);
+    static std::unique_ptr<Gdiplus::Brush> CreateBrush(const Gdiplus::Graphics &graphics, const SvgGradient &gradient,
+                                                       const Gdiplus::RectF &bounds, float opacity = 1.0f);
 };
 
 #endif
@@ -8,15 +8,32 @@
 // DrawX methods and ApplyTransform are provided in separate Draw*.cpp and
 // ApplyTransform.cpp files to keep the code modular.
 
-std::unique_ptr<Gdiplus::Brush> GdiPlusRenderer::CreateFillBrush(const std::string& fillUrl, Gdiplus::Color fillColor, float fillOpacity, const Gdiplus::RectF& bounds)
+const SvgStyle &GdiPlusRenderer::StyleOf(const ISvgElement &element)
 {
-    if (!fillUrl.empty())
+    if (resolved)
+        return *resolvedStyle;
+    static const SvgStyle unstyled;
+    const SvgStyle &own = styles ? (*styles)[element.style] : unstyled;
+    if (instances.empty())
+        return own;
+    instanceStyle = own;
+    InheritPaint(instanceStyle, instances.back());
+    return instanceStyle;
+}
+
+std::unique_ptr<Gdiplus::Brush> GdiPlusRenderer::CreateFillBrush(const SvgStyle &style, const SvgBounds &box)
+{
+    const SvgGradient *gradient = resolved ? resolvedFill : nullptr;
+    if (!resolved && style.fillUrl != 0 && styles && gradients)
+    {
+        auto it = gradients->find(std::string(styles->GetString(style.fillUrl)));
+        if (it != gradients->end())
+            gradient = it->second.get();
+    }
+    if (gradient && !box.Empty())
     {
-        auto it = gradients.find(fillUrl);
-        if (it != gradients.end())
-        {
-             return GdiPlusGradientRenderer::CreateBrush(it->second, bounds, fillOpacity);
-        }
+        RectF bounds(box.minX, box.minY, box.maxX - box.minX, box.maxY - box.minY);
+        return GdiPlusGradientRenderer::CreateBrush(graphics, *gradient, bounds, style.fillOpacity);
     }
     // Fallback
     // Ensure fillColor is applied with opacity if not already (SvgElementFactory applies input opacity to color, but maybe we want to double check logic)
@@ -24,5 +41,50 @@ std::unique_ptr<Gdiplus::Brush> GdiPlusRenderer::CreateFillBrush(const std::stri
     // So fillColor ALREADY has fillOp applied. 
     // BUT what about inheritance? If I used 'fillUrl', fillColor was set to "black" (fallback) with opacity applied.
     // If I revert to solid fallback, I use that fillColor.
-    return std::make_unique<SolidBrush>(fillColor);
+    return std::make_unique<SolidBrush>(style.fillColor);
+}
+
+Gdiplus::GraphicsState GdiPlusRenderer::BeginElement(const ISvgElement &element)
+{
+    if (resolved)
+        return 0;
+    GraphicsState state = graphics.Save();
+    ApplyTransform(graphics, element.transform);
+    return state;
+}
+
+void GdiPlusRenderer::EndElement(Gdiplus::GraphicsState state)
+{
+    if (!resolved)
+        graphics.Restore(state);
+}
+
+const SvgMatrix &GdiPlusRenderer::BeginResolved()
+{
+    resolvedState = graphics.Save();
+    Matrix base;
+    graphics.GetTransform(&base);
+    REAL m[6];
+    base.GetElements(m);
+    resolvedBase = {m[0], m[1], m[2], m[3], m[4], m[5]};
+    resolved = true;
+    return resolvedBase;
+}
+
+void GdiPlusRenderer::SetResolved(const SvgMatrix &toDevice, const SvgStyle &style, const SvgGradient *fill)
+{
+    // One absolute transform per element instead of a save, a multiply
+    // and a restore.
+    Matrix m(toDevice.a, toDevice.b, toDevice.c, toDevice.d, toDevice.e, toDevice.f);
+    graphics.SetTransform(&m);
+    resolvedStyle = &style;
+    resolvedFill = fill;
+}
+
+void GdiPlusRenderer::EndResolved()
+{
+    resolved = false;
+    resolvedStyle = nullptr;
+    resolvedFill = nullptr;
+    graphics.Restore(resolvedState);
 }
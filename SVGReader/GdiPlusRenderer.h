@@ -3,8 +3,6 @@
 
 #include <gdiplus.h>
 #include <string>
-#include <regex>
-#include <sstream>
 #include <vector>
 
 using namespace Gdiplus;
@@ -19,8 +17,13 @@ class SvgPolygon;
 class SvgText;
 class SvgPath;
 class SvgGroup;
+class SvgUse;
+class ISvgElement;
 
 #include "IRenderer.h"
+#include "SvgElement.h"
+#include "SvgStyle.h"
+#include "SvgTransform.h"
 
 class GdiPlusRenderer : public IRenderer
 {
@@ -29,7 +32,12 @@ public:
 
     void SetGradients(const std::unordered_map<std::string, std::shared_ptr<SvgGradient>>& gradients) override
     {
-        this->gradients = gradients;
+        this->gradients = &gradients;
+    }
+
+    void SetStyles(const SvgStyleTable &styles) override
+    {
+        this->styles = &styles;
     }
 
     void DrawLine(const SvgLine &line) override;
@@ -39,14 +47,47 @@ public:
     void DrawPolyline(const SvgPolyline &polyline) override;
     void DrawPolygon(const SvgPolygon &polygon) override;
     void DrawText(const SvgText &text) override;
-    void ApplyTransform(Gdiplus::Graphics& graphics, const std::string& transformStr);
+    void ApplyTransform(Gdiplus::Graphics& graphics, const SvgMatrix& transform);
     void DrawPath(const SvgPath& path) override;
     void DrawGroup(const SvgGroup& group) override;
+    void DrawUse(const SvgUse &use) override;
+    void PushTransform(const SvgMatrix &transform) override;
+    void PopTransform() override;
+    const SvgMatrix &BeginResolved() override;
+    void SetResolved(const SvgMatrix &toDevice, const SvgStyle &style, const SvgGradient *fill) override;
+    void EndResolved() override;
 private:
     Gdiplus::Graphics &graphics;
-    std::unordered_map<std::string, std::shared_ptr<SvgGradient>> gradients;
+    std::vector<Gdiplus::GraphicsState> pushedStates;
+    // Borrowed from the document drawn, never copied, so renderers on other
+    // threads can share it.
+    const std::unordered_map<std::string, std::shared_ptr<SvgGradient>> *gradients = nullptr;
+    const SvgStyleTable *styles = nullptr;
+
+    // What the <use> elements being drawn hand down, innermost last.
+    std::vector<SvgInheritedStyle> instances;
+    SvgStyle instanceStyle;
+
+    // Between BeginResolved and EndResolved: what SetResolved gave, and the
+    // transform the graphics had when replay began.
+    bool resolved = false;
+    Gdiplus::GraphicsState resolvedState = 0;
+    SvgMatrix resolvedBase;
+    const SvgStyle *resolvedStyle = nullptr;
+    const SvgGradient *resolvedFill = nullptr;
+
+    // Puts the element's transform on the graphics for one draw; the
+    // state goes back to EndElement. Resolved, the transform is in place
+    // already and both do nothing.
+    Gdiplus::GraphicsState BeginElement(const ISvgElement &element);
+    void EndElement(Gdiplus::GraphicsState state);
 
-    std::unique_ptr<Gdiplus::Brush> CreateFillBrush(const std::string& fillUrl, Gdiplus::Color fillColor, float fillOpacity, const Gdiplus::RectF& bounds);
+    // The element's record in the table given to SetStyles (the default
+    // style if none was), completed by the innermost use being drawn. Valid
+    // until the next call.
+    const SvgStyle &StyleOf(const ISvgElement &element);
+    // box is the element's fillBox, which sizes gradients.
+    std::unique_ptr<Gdiplus::Brush> CreateFillBrush(const SvgStyle &style, const SvgBounds &box);
 };
 
 #endif
@@ -1,6 +1,10 @@
 #ifndef _IRENDERER_H_
 #define _IRENDERER_H_
 
+// First: on Windows this brings in <windows.h>, whose DrawText macro
+// renames the method below, and every file has to see it renamed alike.
+#include "SvgPlatform.h"
+
 // Forward declarations of SVG element classes to avoid heavy includes
 class SvgLine;
 class SvgRect;
@@ -11,7 +15,11 @@ class SvgPolygon;
 class SvgText;
 class SvgPath;
 class SvgGroup;
+class SvgUse;
 class SvgGradient;
+class SvgStyleTable;
+struct SvgMatrix;
+struct SvgStyle;
 #include <unordered_map>
 #include <memory>
 #include <string>
@@ -21,7 +29,10 @@ class IRenderer
 public:
     virtual ~IRenderer() {}
 
+    // Where the elements drawn next look up their gradients and style
+    // indexes. Both are only read, and must outlive the drawing.
     virtual void SetGradients(const std::unordered_map<std::string, std::shared_ptr<SvgGradient>>& gradients) = 0;
+    virtual void SetStyles(const SvgStyleTable &styles) = 0;
 
     virtual void DrawLine(const SvgLine &line) = 0;
     virtual void DrawRect(const SvgRect &rect) = 0;
@@ -32,6 +43,30 @@ public:
     virtual void DrawText(const SvgText &text) = 0;
     virtual void DrawPath(const SvgPath& path) = 0;
     virtual void DrawGroup(const SvgGroup& group) = 0;
+    // Draws use.target, if any, under the use's transform, with the paint
+    // the use hands down filling in what the target's own style leaves open.
+    virtual void DrawUse(const SvgUse &use) = 0;
+
+    // Flat traversals (SvgScene) bracket a group's children with these
+    // instead of calling DrawGroup: whatever is drawn in between goes
+    // through transform first.
+    virtual void PushTransform(const SvgMatrix &transform) = 0;
+    virtual void PopTransform() = 0;
+
+    // Display lists (SvgDisplayList) replay between these, with everything
+    // resolved up front. BeginResolved returns the matrix from the space
+    // the renderer is in to its device. Before each Draw* call, SetResolved
+    // gives toDevice, from the element's own space (its transform included)
+    // to the device, the element's final style, and the gradient that style
+    // fills with (nullptr for its colour). The element's transform, style
+    // index and fill url are not looked at.
+    //
+    // For the pixels of a tree walk, toDevice has to be that base times the
+    // transforms from the root down, multiplied in that order as the walk's
+    // nested PushTransform and DrawGroup calls would.
+    virtual const SvgMatrix &BeginResolved() = 0;
+    virtual void SetResolved(const SvgMatrix &toDevice, const SvgStyle &style, const SvgGradient *fill) = 0;
+    virtual void EndResolved() = 0;
 };
 
 #endif
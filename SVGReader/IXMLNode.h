@@ -1,23 +1,64 @@
 #ifndef _IXMLNODE_H_
 #define _IXMLNODE_H_
 
-#include <string>
-#include <vector>
+#include <string_view>
 #include <memory>
+#include <type_traits>
 
 class IXMLNode;
 
-using IXMLNodePtr = std::unique_ptr<IXMLNode>;
+template <typename Signature>
+class XMLFunctionRef;
 
+// Non-owning reference to a callable used to visit children or attributes.
+// Unlike std::function it never allocates, so walking the tree does not
+// create any per-node heap objects. The callable must outlive the call
+// it is passed to (a lambda temporary is fine).
+template <typename... Args>
+class XMLFunctionRef<void(Args...)>
+{
+public:
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, XMLFunctionRef>)
+    XMLFunctionRef(F &&f)
+        : m_object(const_cast<void *>(static_cast<const void *>(std::addressof(f)))),
+          m_invoke(&Invoke<std::remove_reference_t<F>>)
+    {
+    }
+
+    void operator()(Args... args) const { m_invoke(m_object, args...); }
+
+private:
+    template <typename F>
+    static void Invoke(void *object, Args... args)
+    {
+        (*static_cast<F *>(object))(args...);
+    }
+
+    void *m_object;
+    void (*m_invoke)(void *, Args...);
+};
+
+using XMLChildVisitor = XMLFunctionRef<void(const IXMLNode &)>;
+using XMLAttributeVisitor = XMLFunctionRef<void(std::string_view name, std::string_view value)>;
+
+// Read-only view of an XML element. All returned string views point into the
+// parsed document buffer and stay valid for as long as that buffer lives.
 class IXMLNode
 {
 public:
     virtual ~IXMLNode() = default;
 
-    virtual std::string getTagName() const = 0;
-    virtual std::string getAttribute(const std::string &name) const = 0;
-    virtual std::string getTextContent() const = 0;
-    virtual std::vector<IXMLNodePtr> getChildren() const = 0;
+    virtual std::string_view getTagName() const = 0;
+    virtual std::string_view getAttribute(std::string_view name) const = 0;
+    virtual std::string_view getTextContent() const = 0;
+
+    // Calls visitor once per child element, in document order. The node
+    // passed to the visitor is only valid during that call.
+    virtual void forEachChild(XMLChildVisitor visitor) const = 0;
+
+    // Calls visitor once per attribute, in document order.
+    virtual void forEachAttribute(XMLAttributeVisitor visitor) const = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
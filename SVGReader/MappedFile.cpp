@@ -0,0 +1,158 @@
+#include "stdafx.h"
+#include "MappedFile.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    size_t PageSize()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path &path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < 0 ||
+        static_cast<unsigned long long>(fileSize.QuadPart) > SIZE_MAX - 1)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    size_t size = static_cast<size_t>(fileSize.QuadPart);
+
+    // A page-aligned (or empty) file has no spare zero byte after its end.
+    if (size == 0 || size % PageSize() == 0)
+    {
+        CloseHandle(file);
+        return ReadIntoHeap(path);
+    }
+
+    // PAGE_WRITECOPY + FILE_MAP_COPY: pages are shared with the file cache
+    // until rapidxml writes to them, then privately copied.
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return ReadIntoHeap(path);
+    }
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return ReadIntoHeap(path);
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<char *>(view);
+    m_size = size;
+    m_mapped = true;
+    return true;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0)
+    {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    if (size == 0 || size % PageSize() == 0)
+    {
+        close(fd);
+        return ReadIntoHeap(path);
+    }
+
+    // MAP_PRIVATE gives a copy-on-write view; the remainder of the last page
+    // past end-of-file is guaranteed to read as zero.
+    void *view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return ReadIntoHeap(path);
+
+    m_data = static_cast<char *>(view);
+    m_size = size;
+    m_mapped = true;
+    return true;
+#endif
+}
+
+void MappedFile::Close()
+{
+    if (m_mapped && m_data)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = nullptr;
+#else
+        munmap(m_data, m_size);
+#endif
+    }
+    m_heap.clear();
+    m_heap.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+bool MappedFile::ReadIntoHeap(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    std::streamoff end = file.tellg();
+    if (end < 0)
+        return false;
+    size_t size = static_cast<size_t>(end);
+
+    m_heap.resize(size + 1);
+    file.seekg(0, std::ios::beg);
+    if (size > 0 && !file.read(m_heap.data(), static_cast<std::streamsize>(size)))
+    {
+        m_heap.clear();
+        return false;
+    }
+    m_heap[size] = '\0';
+
+    m_data = m_heap.data();
+    m_size = size;
+    m_mapped = false;
+    return true;
+}
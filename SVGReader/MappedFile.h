@@ -0,0 +1,48 @@
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Read-only file opened as a single private, writable buffer that is always
+// followed by a terminating '\0', so rapidxml can parse it in place.
+//
+// When the file size is not a multiple of the page size the file is memory
+// mapped copy-on-write and the zero-filled tail of the last page serves as
+// the terminator; otherwise the contents are read once into a heap buffer.
+// Writes to the buffer never reach the file on disk.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Open(const std::filesystem::path &path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    bool IsMapped() const { return m_mapped; }
+
+    // File contents plus the trailing '\0' (size is GetSize() + 1).
+    std::span<char> GetBuffer() { return std::span<char>(m_data, m_data ? m_size + 1 : 0); }
+    size_t GetSize() const { return m_size; }
+
+private:
+    bool ReadIntoHeap(const std::filesystem::path &path);
+
+    char *m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<char> m_heap;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+#endif
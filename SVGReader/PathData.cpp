@@ -0,0 +1,511 @@
+#include "stdafx.h"
+#include "PathData.h"
+#include "SvgNumber.h"
+#include <algorithm>
+#include <cmath>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void PathData::MoveTo(float x, float y)
+{
+    m_verbs.push_back(PathVerb::MoveTo);
+    m_coords.insert(m_coords.end(), {x, y});
+}
+
+void PathData::LineTo(float x, float y)
+{
+    m_verbs.push_back(PathVerb::LineTo);
+    m_coords.insert(m_coords.end(), {x, y});
+}
+
+void PathData::CubicTo(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+    m_verbs.push_back(PathVerb::CubicTo);
+    m_coords.insert(m_coords.end(), {x1, y1, x2, y2, x3, y3});
+}
+
+void PathData::Reserve(size_t verbs, size_t coords)
+{
+    m_verbs.reserve(verbs);
+    m_coords.reserve(coords);
+}
+
+void PathData::Clear()
+{
+    m_verbs.clear();
+    m_coords.clear();
+}
+
+namespace
+{
+    // Where one coordinate of the cubic p0..p3 turns, as parameters in
+    // (0, 1); returns how many of t it filled. The derivative is the
+    // quadratic a t^2 + b t + c below, scaled by 3.
+    int CubicExtrema(float p0, float p1, float p2, float p3, float t[2])
+    {
+        const float a = -p0 + 3.0f * p1 - 3.0f * p2 + p3;
+        const float b = 2.0f * (p0 - 2.0f * p1 + p2);
+        const float c = p1 - p0;
+        int count = 0;
+        auto keep = [&](float root)
+        {
+            if (root > 0.0f && root < 1.0f)
+                t[count++] = root;
+        };
+        if (std::fabs(a) < 1e-12f)
+        {
+            if (std::fabs(b) > 1e-12f)
+                keep(-c / b);
+            return count;
+        }
+        const float discriminant = b * b - 4.0f * a * c;
+        if (discriminant < 0.0f)
+            return 0;
+        const float root = std::sqrt(discriminant);
+        keep((-b + root) / (2.0f * a));
+        keep((-b - root) / (2.0f * a));
+        return count;
+    }
+
+    float CubicAt(float p0, float p1, float p2, float p3, float t)
+    {
+        const float u = 1.0f - t;
+        return u * u * u * p0 + 3.0f * u * u * t * p1 + 3.0f * u * t * t * p2 + t * t * t * p3;
+    }
+}
+
+SvgBounds PathData::Bounds() const
+{
+    SvgBounds box;
+    const float *c = m_coords.data();
+    float x = 0.0f, y = 0.0f;
+    for (PathVerb verb : m_verbs)
+    {
+        switch (verb)
+        {
+        case PathVerb::MoveTo:
+            break;
+        case PathVerb::LineTo:
+            box.Add(x, y);
+            box.Add(c[0], c[1]);
+            break;
+        case PathVerb::CubicTo:
+        {
+            // The ends always count; the curve between them only bulges
+            // past them where it turns.
+            box.Add(x, y);
+            box.Add(c[4], c[5]);
+            float t[2];
+            for (int k = CubicExtrema(x, c[0], c[2], c[4], t); k-- > 0;)
+                box.Add(CubicAt(x, c[0], c[2], c[4], t[k]), y);
+            for (int k = CubicExtrema(y, c[1], c[3], c[5], t); k-- > 0;)
+                box.Add(x, CubicAt(y, c[1], c[3], c[5], t[k]));
+            break;
+        }
+        case PathVerb::Close:
+            break;
+        }
+        const size_t n = CoordCount(verb);
+        if (n)
+        {
+            x = c[n - 2];
+            y = c[n - 1];
+        }
+        c += n;
+    }
+    return box;
+}
+
+namespace
+{
+    bool IsSeparator(char c) { return c == ' ' || c == ',' || c == '\n' || c == '\t' || c == '\r'; }
+    bool IsAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+    class PathParser
+    {
+    public:
+        PathParser(std::string_view d, PathData &out) : m_rest(d), m_out(out) {}
+
+        void Run();
+
+    private:
+        void SkipSeparators()
+        {
+            size_t i = 0;
+            while (i < m_rest.size() && IsSeparator(m_rest[i]))
+                ++i;
+            m_rest.remove_prefix(i);
+        }
+
+        bool Number(float &out)
+        {
+            SkipSeparators();
+            return SvgNumber::Parse(m_rest, out);
+        }
+
+        bool Flag(float &out)
+        {
+            SkipSeparators();
+            if (m_rest.empty() || (m_rest[0] != '0' && m_rest[0] != '1'))
+                return false;
+            out = static_cast<float>(m_rest[0] - '0');
+            m_rest.remove_prefix(1);
+            return true;
+        }
+
+        // A closed figure that is drawn on again restarts at its start point.
+        void BeginSegment()
+        {
+            if (m_needMove)
+            {
+                m_out.MoveTo(m_x, m_y);
+                m_needMove = false;
+            }
+        }
+
+        void LineTo(float x, float y)
+        {
+            BeginSegment();
+            m_out.LineTo(x, y);
+            m_x = x;
+            m_y = y;
+        }
+
+        void CubicTo(float x1, float y1, float x2, float y2, float x3, float y3)
+        {
+            BeginSegment();
+            m_out.CubicTo(x1, y1, x2, y2, x3, y3);
+            m_x = x3;
+            m_y = y3;
+        }
+
+        // Quadratic through (qx, qy) from the current point, as a cubic.
+        void QuadTo(float qx, float qy, float x, float y)
+        {
+            CubicTo(m_x + 2.0f / 3.0f * (qx - m_x), m_y + 2.0f / 3.0f * (qy - m_y),
+                    x + 2.0f / 3.0f * (qx - x), y + 2.0f / 3.0f * (qy - y),
+                    x, y);
+            m_ctrlX = qx;
+            m_ctrlY = qy;
+        }
+
+        void ArcTo(double rx, double ry, double xAxisRotationDeg, int largeArcFlag, int sweepFlag, double x, double y);
+
+        std::string_view m_rest;
+        PathData &m_out;
+        float m_x = 0, m_y = 0;          // current point
+        float m_startX = 0, m_startY = 0;
+        float m_ctrlX = 0, m_ctrlY = 0;  // last control point, for S and T
+        bool m_needMove = true;
+    };
+
+    // Endpoint-to-center conversion from the SVG implementation notes, then
+    // one cubic per quarter turn or less.
+    void PathParser::ArcTo(double rx, double ry, double xAxisRotationDeg, int largeArcFlag, int sweepFlag, double x, double y)
+    {
+        const double x0 = m_x, y0 = m_y;
+        if (x0 == x && y0 == y)
+            return; // no-op
+        if (rx == 0.0 || ry == 0.0)
+        {
+            LineTo((float)x, (float)y);
+            return;
+        }
+
+        double phi = xAxisRotationDeg * M_PI / 180.0;
+        double cosPhi = cos(phi), sinPhi = sin(phi);
+
+        // Step 1: compute (x1', y1')
+        double dx2 = (x0 - x) / 2.0;
+        double dy2 = (y0 - y) / 2.0;
+        double x1p = cosPhi * dx2 + sinPhi * dy2;
+        double y1p = -sinPhi * dx2 + cosPhi * dy2;
+
+        // Ensure radii are large enough
+        double rxAbs = fabs(rx);
+        double ryAbs = fabs(ry);
+        double rxSq = rxAbs * rxAbs;
+        double rySq = ryAbs * ryAbs;
+        double x1pSq = x1p * x1p;
+        double y1pSq = y1p * y1p;
+
+        double lambda = x1pSq / rxSq + y1pSq / rySq;
+        if (lambda > 1.0)
+        {
+            double factor = sqrt(lambda);
+            rxAbs *= factor;
+            ryAbs *= factor;
+            rxSq = rxAbs * rxAbs;
+            rySq = ryAbs * ryAbs;
+        }
+
+        // Step 2: compute center
+        double sign = (largeArcFlag == sweepFlag) ? -1.0 : 1.0;
+        double sq = ((rxSq * rySq) - (rxSq * y1pSq) - (rySq * x1pSq)) / (rxSq * y1pSq + rySq * x1pSq);
+        sq = (sq < 0) ? 0 : sq;
+        double coef = sign * sqrt(sq);
+        double cxp = coef * ((rxAbs * y1p) / ryAbs);
+        double cyp = coef * (-(ryAbs * x1p) / rxAbs);
+
+        // Step 3: compute center in original coords
+        double cx = cosPhi * cxp - sinPhi * cyp + (x0 + x) / 2.0;
+        double cy = sinPhi * cxp + cosPhi * cyp + (y0 + y) / 2.0;
+
+        // Step 4: compute start and delta angles
+        auto vectorAngle = [&](double ux, double uy, double vx, double vy)
+        {
+            double dot = ux * vx + uy * vy;
+            double len = sqrt((ux * ux + uy * uy) * (vx * vx + vy * vy));
+            // Use parenthesized std::min/std::max to avoid Windows min/max macro collision
+            double clamped = (std::max)(-1.0, (std::min)(1.0, dot / len));
+            double ang = acos(clamped);
+            if (ux * vy - uy * vx < 0)
+                ang = -ang;
+            return ang;
+        };
+
+        double ux = (x1p - cxp) / rxAbs;
+        double uy = (y1p - cyp) / ryAbs;
+        double vx = (-x1p - cxp) / rxAbs;
+        double vy = (-y1p - cyp) / ryAbs;
+        double startAngle = atan2(uy, ux);
+        double deltaAngle = vectorAngle(ux, uy, vx, vy);
+
+        if (!sweepFlag && deltaAngle > 0)
+            deltaAngle -= 2 * M_PI;
+        else if (sweepFlag && deltaAngle < 0)
+            deltaAngle += 2 * M_PI;
+
+        // Split into segments of max PI/2
+        int segments = static_cast<int>(ceil(fabs(deltaAngle) / (M_PI / 2.0)));
+        double delta = deltaAngle / segments;
+
+        for (int iSeg = 0; iSeg < segments; ++iSeg)
+        {
+            double t1 = startAngle + iSeg * delta;
+            double t2 = t1 + delta;
+            double cosT1 = cos(t1), sinT1 = sin(t1);
+            double cosT2 = cos(t2), sinT2 = sin(t2);
+
+            // endpoints
+            double x1 = cx + rxAbs * cosPhi * cosT1 - ryAbs * sinPhi * sinT1;
+            double y1 = cy + rxAbs * sinPhi * cosT1 + ryAbs * cosPhi * sinT1;
+            double x4 = cx + rxAbs * cosPhi * cosT2 - ryAbs * sinPhi * sinT2;
+            double y4 = cy + rxAbs * sinPhi * cosT2 + ryAbs * cosPhi * sinT2;
+
+            // control points, along the tangents at both ends
+            double tanDelta = tan((t2 - t1) / 2.0);
+            double alpha = (sin(t2 - t1) * (sqrt(4.0 + 3.0 * tanDelta * tanDelta) - 1.0)) / 3.0;
+
+            double x2 = x1 - alpha * (rxAbs * cosPhi * sinT1 + ryAbs * sinPhi * cosT1);
+            double y2 = y1 - alpha * (rxAbs * sinPhi * sinT1 - ryAbs * cosPhi * cosT1);
+
+            double x3 = x4 + alpha * (rxAbs * cosPhi * sinT2 + ryAbs * sinPhi * cosT2);
+            double y3 = y4 + alpha * (rxAbs * sinPhi * sinT2 - ryAbs * cosPhi * cosT2);
+
+            // Land exactly on the requested end point
+            if (iSeg == segments - 1)
+            {
+                x4 = x;
+                y4 = y;
+            }
+
+            // For the first segment, join the current point to the arc start
+            if (iSeg == 0)
+                LineTo((float)x1, (float)y1);
+            CubicTo((float)x2, (float)y2, (float)x3, (float)y3, (float)x4, (float)y4);
+        }
+        m_x = (float)x;
+        m_y = (float)y;
+    }
+
+    void PathParser::Run()
+    {
+        char lastCmd = 0;
+        while (true)
+        {
+            SkipSeparators();
+            if (m_rest.empty())
+                break;
+
+            const size_t before = m_rest.size();
+            char ch = m_rest[0];
+            if (IsAlpha(ch))
+            {
+                m_rest.remove_prefix(1);
+            }
+            else if (lastCmd == 0)
+            {
+                // invalid
+                m_rest.remove_prefix(1);
+                continue;
+            }
+            else
+            {
+                ch = lastCmd; // implicit command repeat
+            }
+
+            const bool rel = ch >= 'a' && ch <= 'z';
+
+            switch (ch & ~0x20)
+            {
+            case 'Z':
+                m_out.Close();
+                m_x = m_startX;
+                m_y = m_startY;
+                m_ctrlX = m_ctrlY = 0;
+                m_needMove = true;
+                // Z does not become the command to repeat or to reflect from.
+                continue;
+            case 'M':
+            {
+                float x, y;
+                if (!Number(x) || !Number(y))
+                    return;
+                m_x = m_startX = rel ? m_x + x : x;
+                m_y = m_startY = rel ? m_y + y : y;
+                m_out.MoveTo(m_x, m_y);
+                m_needMove = false;
+                // subsequent pairs without command are treated as implicit L
+                while (true)
+                {
+                    const std::string_view save = m_rest;
+                    if (!Number(x) || !Number(y))
+                    {
+                        m_rest = save;
+                        break;
+                    }
+                    if (rel)
+                        LineTo(m_x + x, m_y + y);
+                    else
+                        LineTo(x, y);
+                }
+                break;
+            }
+            case 'L':
+            {
+                float x, y;
+                while (Number(x) && Number(y))
+                {
+                    if (rel)
+                        LineTo(m_x + x, m_y + y);
+                    else
+                        LineTo(x, y);
+                }
+                break;
+            }
+            case 'H':
+            {
+                float x;
+                while (Number(x))
+                    LineTo(rel ? m_x + x : x, m_y);
+                break;
+            }
+            case 'V':
+            {
+                float y;
+                while (Number(y))
+                    LineTo(m_x, rel ? m_y + y : y);
+                break;
+            }
+            case 'C':
+            {
+                float x1, y1, x2, y2, x3, y3;
+                while (Number(x1) && Number(y1) && Number(x2) && Number(y2) && Number(x3) && Number(y3))
+                {
+                    const float dx = rel ? m_x : 0.0f, dy = rel ? m_y : 0.0f;
+                    CubicTo(x1 + dx, y1 + dy, x2 + dx, y2 + dy, x3 + dx, y3 + dy);
+                    m_ctrlX = x2 + dx;
+                    m_ctrlY = y2 + dy;
+                }
+                break;
+            }
+            case 'S':
+            {
+                float x2, y2, x3, y3;
+                const bool reflect = (lastCmd & ~0x20) == 'C' || (lastCmd & ~0x20) == 'S';
+                bool first = true;
+                while (Number(x2) && Number(y2) && Number(x3) && Number(y3))
+                {
+                    float x1 = m_x, y1 = m_y;
+                    if (reflect || !first)
+                    {
+                        // reflect last control
+                        x1 = m_x + (m_x - m_ctrlX);
+                        y1 = m_y + (m_y - m_ctrlY);
+                    }
+                    const float dx = rel ? m_x : 0.0f, dy = rel ? m_y : 0.0f;
+                    CubicTo(x1, y1, x2 + dx, y2 + dy, x3 + dx, y3 + dy);
+                    m_ctrlX = x2 + dx;
+                    m_ctrlY = y2 + dy;
+                    first = false;
+                }
+                break;
+            }
+            case 'Q':
+            {
+                float qx, qy, x, y;
+                while (Number(qx) && Number(qy) && Number(x) && Number(y))
+                {
+                    const float dx = rel ? m_x : 0.0f, dy = rel ? m_y : 0.0f;
+                    QuadTo(qx + dx, qy + dy, x + dx, y + dy);
+                }
+                break;
+            }
+            case 'T':
+            {
+                float x, y;
+                const bool reflect = (lastCmd & ~0x20) == 'Q' || (lastCmd & ~0x20) == 'T';
+                bool first = true;
+                while (Number(x) && Number(y))
+                {
+                    float qx = m_x, qy = m_y;
+                    if (reflect || !first)
+                    {
+                        qx = m_x + (m_x - m_ctrlX);
+                        qy = m_y + (m_y - m_ctrlY);
+                    }
+                    const float dx = rel ? m_x : 0.0f, dy = rel ? m_y : 0.0f;
+                    QuadTo(qx, qy, x + dx, y + dy);
+                    first = false;
+                }
+                break;
+            }
+            case 'A':
+            {
+                // params: rx ry x-axis-rotation large-arc-flag sweep-flag x y
+                float rx, ry, xrot, laf, sf, x, y;
+                while (Number(rx) && Number(ry) && Number(xrot) && Flag(laf) && Flag(sf) && Number(x) && Number(y))
+                {
+                    const float dx = rel ? m_x : 0.0f, dy = rel ? m_y : 0.0f;
+                    ArcTo(rx, ry, xrot, static_cast<int>(laf), static_cast<int>(sf), x + dx, y + dy);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+
+            // An unknown command, or a repeat that could not read anything,
+            // would otherwise spin on the same character.
+            if (m_rest.size() == before)
+                m_rest.remove_prefix(1);
+            lastCmd = ch;
+        }
+    }
+}
+
+PathData ParsePathData(std::string_view d, const PathData::allocator_type &alloc)
+{
+    // Built in a per-thread scratch path and copied out once it is
+    // complete, so an arena allocator sees one exact-size block per array
+    // instead of every regrowth.
+    thread_local PathData scratch;
+    scratch.Clear();
+    // Exported path data runs about six bytes per coordinate and four
+    // coordinates per verb, which saves the first few regrowths.
+    scratch.Reserve(d.size() / 24, d.size() / 6);
+    PathParser(d, scratch).Run();
+    return PathData(scratch, alloc);
+}
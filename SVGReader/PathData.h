@@ -0,0 +1,69 @@
+#ifndef _PATHDATA_H_
+#define _PATHDATA_H_
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "SvgTransform.h"
+
+enum class PathVerb : uint8_t
+{
+    MoveTo,     // 1 point
+    LineTo,     // 1 point
+    CubicTo,    // 2 control points, then the end point
+    Close       // no points
+};
+
+// Compact geometry of a <path>: one byte per verb and the points of all
+// verbs packed into a single float array (x, y, x, y, ...). Arcs and
+// quadratic curves are already converted to cubics, so this is all a
+// backend has to understand.
+//
+// Every drawing verb follows a MoveTo in its figure; a figure that is
+// closed and drawn on again gets a fresh MoveTo at its start point.
+class PathData
+{
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit PathData(const allocator_type &alloc = {}) : m_verbs(alloc), m_coords(alloc) {}
+    PathData(const PathData &other, const allocator_type &alloc)
+        : m_verbs(other.m_verbs, alloc), m_coords(other.m_coords, alloc)
+    {
+    }
+
+    void MoveTo(float x, float y);
+    void LineTo(float x, float y);
+    void CubicTo(float x1, float y1, float x2, float y2, float x3, float y3);
+    void Close() { m_verbs.push_back(PathVerb::Close); }
+
+    allocator_type get_allocator() const { return m_verbs.get_allocator(); }
+
+    void Reserve(size_t verbs, size_t coords);
+    void Clear();
+
+    bool Empty() const { return m_verbs.empty(); }
+    // Tight box around what is drawn: curves by their extrema, not their
+    // control points, and movetos nothing is drawn from left out.
+    SvgBounds Bounds() const;
+    const std::pmr::vector<PathVerb> &Verbs() const { return m_verbs; }
+    const std::pmr::vector<float> &Coords() const { return m_coords; }
+
+    // Number of floats a verb consumes from Coords().
+    static constexpr size_t CoordCount(PathVerb verb)
+    {
+        return verb == PathVerb::CubicTo ? 6 : verb == PathVerb::Close ? 0 : 2;
+    }
+
+private:
+    std::pmr::vector<PathVerb> m_verbs;
+    std::pmr::vector<float> m_coords;
+};
+
+// Parses the "d" attribute of a <path> in a single pass. Bytes that cannot
+// start a command are skipped, and a moveto without both coordinates ends
+// the path. The result is allocated with alloc, at its exact size.
+PathData ParsePathData(std::string_view d, const PathData::allocator_type &alloc = {});
+
+#endif
@@ -1,34 +1,41 @@
 #include "stdafx.h"
 #include "RapidXmlNodeAdapter.h"
-#include <algorithm> 
-#include <sstream>   
 
 RapidXmlNodeAdapter::RapidXmlNodeAdapter(rapidxml::xml_node<>* node) : m_node(node) {}
 
-std::string RapidXmlNodeAdapter::getTagName() const {
-    return m_node ? m_node->name() : "";
+std::string_view RapidXmlNodeAdapter::getTagName() const {
+    if (!m_node) return {};
+    return std::string_view(m_node->name(), m_node->name_size());
 }
 
-std::string RapidXmlNodeAdapter::getAttribute(const std::string& name) const {
-    if (!m_node) return "";
-    rapidxml::xml_attribute<>* attr = m_node->first_attribute(name.c_str());
-    return attr ? attr->value() : "";
+std::string_view RapidXmlNodeAdapter::getAttribute(std::string_view name) const {
+    if (!m_node || name.empty()) return {};
+    rapidxml::xml_attribute<>* attr = m_node->first_attribute(name.data(), name.size());
+    return attr ? std::string_view(attr->value(), attr->value_size()) : std::string_view();
 }
 
-std::string RapidXmlNodeAdapter::getTextContent() const {
-    if (!m_node) return "";
+std::string_view RapidXmlNodeAdapter::getTextContent() const {
+    if (!m_node) return {};
     rapidxml::xml_node<>* text_node = m_node->first_node(0); 
-    return text_node ? text_node->value() : "";
+    return text_node ? std::string_view(text_node->value(), text_node->value_size()) : std::string_view();
 }
 
-std::vector<IXMLNodePtr> RapidXmlNodeAdapter::getChildren() const {
-    std::vector<IXMLNodePtr> children;
-    if (!m_node) return children;
+void RapidXmlNodeAdapter::forEachChild(XMLChildVisitor visitor) const {
+    if (!m_node) return;
 
     for (rapidxml::xml_node<>* child = m_node->first_node(); child; child = child->next_sibling()) {
         if (child->type() == rapidxml::node_element) { 
-            children.push_back(std::make_unique<RapidXmlNodeAdapter>(child));
+            RapidXmlNodeAdapter adapter(child);
+            visitor(adapter);
         }
     }
-    return children;
-}
\ No newline at end of file
+}
+
+void RapidXmlNodeAdapter::forEachAttribute(XMLAttributeVisitor visitor) const {
+    if (!m_node) return;
+
+    for (rapidxml::xml_attribute<>* attr = m_node->first_attribute(); attr; attr = attr->next_attribute()) {
+        visitor(std::string_view(attr->name(), attr->name_size()),
+                std::string_view(attr->value(), attr->value_size()));
+    }
+}
@@ -3,6 +3,8 @@
 #include "IXMLNode.h"
 #include "rapidxml.hpp" 
 
+// Lightweight handle over a rapidxml node: it only stores the node pointer,
+// so adapters are created on the stack while walking the tree.
 class RapidXmlNodeAdapter : public IXMLNode {
 private:
     rapidxml::xml_node<>* m_node;
@@ -11,10 +13,11 @@ public:
     RapidXmlNodeAdapter(rapidxml::xml_node<>* node);
     ~RapidXmlNodeAdapter() override = default;
 
-    std::string getTagName() const override;
-    std::string getAttribute(const std::string& name) const override;
-    std::string getTextContent() const override;
-    std::vector<IXMLNodePtr> getChildren() const override;
+    std::string_view getTagName() const override;
+    std::string_view getAttribute(std::string_view name) const override;
+    std::string_view getTextContent() const override;
+    void forEachChild(XMLChildVisitor visitor) const override;
+    void forEachAttribute(XMLAttributeVisitor visitor) const override;
 };
 
-#endif
\ No newline at end of file
+#endif
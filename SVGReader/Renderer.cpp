@@ -1,24 +1,38 @@
 ﻿#include "stdafx.h"
 #include "Renderer.h"
 #include "SvgParser.h"
+#include "SvgStreamParser.h"
+#include "MappedFile.h"
 
-bool SvgRenderer::Load(const std::wstring &filePath)
+namespace
 {
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, filePath.c_str(), -1, NULL, 0, NULL, NULL);
-    if (size_needed <= 0)
-        return false;
-
-    std::vector<char> narrowPath(size_needed);
-    WideCharToMultiByte(CP_UTF8, 0, filePath.c_str(), -1, &narrowPath[0], size_needed, NULL, NULL);
+    // Above this size the DOM rapidxml builds next to the file costs more
+    // than the document itself, so the file is streamed instead.
+    constexpr size_t kStreamingThreshold = 16 * 1024 * 1024;
+}
 
-    std::ifstream file(&narrowPath[0], std::ios::binary);
-    if (!file)
+bool SvgRenderer::Load(const std::wstring &filePath)
+{
+    // Map the file once and let rapidxml parse that buffer in place instead
+    // of copying it through a stream and a string first.
+    MappedFile file;
+    if (!file.Open(std::filesystem::path(filePath)))
         return false;
 
-    std::stringstream ss;
-    ss << file.rdbuf();
-    std::string xml = ss.str();
-
     SvgParser parser;
-    return parser.Parse(xml, document);
+    SvgDocument document;
+    bool loaded;
+    if (file.GetSize() >= kStreamingThreshold)
+    {
+        std::span<char> buffer = file.GetBuffer();
+        SvgStreamParser stream(parser);
+        loaded = stream.Feed(std::string_view(buffer.data(), file.GetSize())) && stream.Finish(document);
+    }
+    else
+    {
+        loaded = parser.Parse(file.GetBuffer(), document);
+    }
+    if (loaded)
+        snapshot = SvgSnapshot::Freeze(std::move(document));
+    return loaded;
 }
@@ -2,7 +2,7 @@
 #define _RENDERER_H_
 
 #include "stdafx.h"
-#include "SvgDocument.h"
+#include "SvgSnapshot.h"
 
 class SvgRenderer 
 {
@@ -11,10 +11,17 @@ public:
 
     bool Load(const std::wstring &filePath);
 
-    const SvgDocument &GetDocument() const { return document; }
+    // Call only after a successful Load.
+    const SvgDocument &GetDocument() const { return snapshot->GetDocument(); }
+    // The loaded document, flattened for culled rendering.
+    const SvgScene &GetScene() const { return snapshot->GetScene(); }
+    // The same compiled for repainting: what the viewer draws.
+    const SvgDisplayList &GetDisplayList() const { return snapshot->GetDisplayList(); }
+    // Shared with whoever else draws the document, on any thread.
+    std::shared_ptr<const SvgSnapshot> GetSnapshot() const { return snapshot; }
 
 private:
-    SvgDocument document;
+    std::shared_ptr<const SvgSnapshot> snapshot;
 };
 
 #endif
\ No newline at end of file
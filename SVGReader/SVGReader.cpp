@@ -2,7 +2,6 @@
 #include "SvgReader.h"
 #include "SvgElementFactory.h"
 #include "GdiPlusRenderer.h"
-#include "SvgColors.h"
 #include <windows.h>
 #include <objidl.h>
 #include <gdiplus.h>
@@ -103,7 +102,22 @@ VOID OnPaint(HDC hdc, HWND hWnd)
 
         graphics.TranslateTransform(-g_CenterX, -g_CenterY);
 
-        globalRenderer->GetDocument().Render(renderer);
+        // Only draw what lands in the window: map its corners back into
+        // document space and let the display list cull against that box.
+        // Pan, zoom and rotation live in the graphics transform, so the
+        // list compiled at load is replayed as is.
+        Matrix view;
+        graphics.GetTransform(&view);
+        if (view.Invert() == Ok)
+        {
+            PointF corners[4] = {PointF(0, 0), PointF((REAL)width, 0), PointF((REAL)width, (REAL)height),
+                                 PointF(0, (REAL)height)};
+            view.TransformPoints(corners, 4);
+            SvgBounds visible;
+            for (const PointF &corner : corners)
+                visible.Add(corner.X, corner.Y);
+            globalRenderer->GetDisplayList().Replay(renderer, visible);
+        }
         graphics.ResetTransform();
     }
 
@@ -141,8 +155,6 @@ INT WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, PSTR, INT iCmdShow)
     // Init GDI+
     GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
 
-    SvgColors::LoadColors("Colors.txt");
-
     // Register Window Class
     wndClass.style = CS_HREDRAW | CS_VREDRAW;
     wndClass.lpfnWndProc = WndProc;
@@ -521,6 +533,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 }
                 else
                 {
+                    // Nothing was loaded, so there is nothing to draw.
+                    delete globalRenderer;
+                    globalRenderer = nullptr;
                     MessageBox(hWnd, L"Failed to load SVG file", L"Error", MB_OK);
                 }
             }
@@ -0,0 +1,109 @@
+#include "SoftwareBlend.h"
+#include <initializer_list>
+
+namespace
+{
+    // x * a / 255, rounded, for the two channels in the 0x00FF00FF lanes
+    // of x. Each lane has room for the product and the rounding, so this
+    // is exact.
+    inline uint32_t ScaleLanes(uint32_t x, uint32_t a)
+    {
+        const uint32_t t = x * a + 0x00800080u;
+        return ((t + ((t >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+    }
+
+    inline uint32_t Scale(uint32_t pixel, uint32_t a)
+    {
+        return ScaleLanes(pixel & 0x00FF00FFu, a) | (ScaleLanes((pixel >> 8) & 0x00FF00FFu, a) << 8);
+    }
+
+    // A premultiplied channel never exceeds its alpha, so no channel of
+    // the sum can carry into the next.
+    inline uint32_t Over(uint32_t src, uint32_t dst)
+    {
+        return src + Scale(dst, 255 - (src >> 24));
+    }
+
+    // The reference the vector kernels are held to.
+    void ScalarSolidSpan(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage)
+    {
+        const bool opaque = (color >> 24) == 255;
+        for (int i = 0; i < count; ++i)
+        {
+            const uint32_t c = coverage[i];
+            if (c == 255)
+                dst[i] = opaque ? color : Over(color, dst[i]);
+            else
+                dst[i] = Over(Scale(color, c), dst[i]);
+        }
+    }
+
+    void ScalarSpan(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const uint32_t c = coverage[i];
+            dst[i] = Over(c == 255 ? src[i] : Scale(src[i], c), dst[i]);
+        }
+    }
+
+    constexpr SoftwareBlend::Kernels kScalar{ScalarSolidSpan, ScalarSpan};
+
+    const SoftwareBlend::Kernels &Active()
+    {
+        static const SoftwareBlend::Kernels &active = *SoftwareBlend::KernelsFor(SoftwareBlend::ActiveIsa());
+        return active;
+    }
+}
+
+void SoftwareBlend::SolidSpan(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage)
+{
+    Active().solidSpan(dst, count, color, coverage);
+}
+
+void SoftwareBlend::Span(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage)
+{
+    Active().span(dst, count, src, coverage);
+}
+
+uint32_t SoftwareBlend::Premultiply(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    const uint32_t straight = r | (static_cast<uint32_t>(g) << 8) | (static_cast<uint32_t>(b) << 16);
+    return Scale(straight, a) | (static_cast<uint32_t>(a) << 24);
+}
+
+const SoftwareBlend::Kernels *SoftwareBlend::KernelsFor(Isa isa)
+{
+    return isa == Isa::Scalar ? &kScalar : X86Kernels(isa);
+}
+
+SoftwareBlend::Isa SoftwareBlend::ActiveIsa()
+{
+    static const Isa active = []
+    {
+        for (Isa isa : {Isa::Avx512, Isa::Avx2, Isa::Sse41, Isa::Sse2})
+        {
+            if (X86Kernels(isa))
+                return isa;
+        }
+        return Isa::Scalar;
+    }();
+    return active;
+}
+
+const char *SoftwareBlend::IsaName(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Sse2:
+        return "SSE2";
+    case Isa::Sse41:
+        return "SSE4.1";
+    case Isa::Avx2:
+        return "AVX2";
+    case Isa::Avx512:
+        return "AVX-512";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef _SOFTWAREBLEND_H_
+#define _SOFTWAREBLEND_H_
+
+#include <cstdint>
+
+// Source-over compositing of premultiplied RGBA spans, eight bits per
+// channel, packed with R in the lowest byte (see SoftwarePixmap). Each
+// source pixel is scaled by its coverage, then laid over the destination:
+//   dst = src * cov + dst * (1 - src.a * cov)
+// with every product rounded to the nearest 255th.
+//
+// The spans run on the widest kernels the CPU has, picked once on first
+// use. Every kernel computes exactly what the scalar one does, so which
+// one ran never shows in the pixels.
+namespace SoftwareBlend
+{
+    // color over count pixels of dst, coverage[i] of it at pixel i.
+    void SolidSpan(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage);
+    // src[i] over dst[i], coverage[i] of it.
+    void Span(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage);
+
+    // Packs a straight (not premultiplied) colour.
+    uint32_t Premultiply(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+
+    // Instruction sets there are kernels for, narrowest first.
+    enum class Isa : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Sse41,
+        Avx2,
+        Avx512
+    };
+
+    struct Kernels
+    {
+        void (*solidSpan)(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage);
+        void (*span)(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage);
+    };
+
+    // The kernels for isa, or nullptr if this build or this CPU has none;
+    // lets a benchmark or a check run each set against the others.
+    const Kernels *KernelsFor(Isa isa);
+    // The set SolidSpan and Span use: the widest KernelsFor has.
+    Isa ActiveIsa();
+    const char *IsaName(Isa isa);
+
+    // The vector kernels, in SoftwareBlendX86.cpp; nullptr for Scalar, for
+    // a set the CPU lacks, and on other processors.
+    const Kernels *X86Kernels(Isa isa);
+}
+
+#endif
@@ -0,0 +1,406 @@
+#include "SoftwareBlend.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <cstring>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// MSVC takes any intrinsic anywhere; GCC and Clang want each function told
+// which instructions it may use, helpers included.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BLEND_TARGET(isa)
+#else
+#define BLEND_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// Every kernel widens pixels to one 16-bit lane per channel and works out
+// ScaleLanes from SoftwareBlend.cpp in each: t = x * a + 128, then
+// (t + (t >> 8)) >> 8. t stays below 65536 all the way, so the lanes give
+// the scalar result bit for bit. Coverage is spread into the same shape,
+// each pixel's byte in all four of its channels. Blocks of coverage that
+// are all zero leave dst as it is and are skipped, and an opaque colour
+// at full coverage is stored as it is; both are what the arithmetic gives.
+// The pixels past the last whole block go to the scalar kernel.
+namespace
+{
+    using SoftwareBlend::Isa;
+    using SoftwareBlend::Kernels;
+
+    const Kernels &Scalar()
+    {
+        return *SoftwareBlend::KernelsFor(Isa::Scalar);
+    }
+
+    // SSE2: four pixels a block.
+
+    BLEND_TARGET("sse2") inline __m128i ScaleSse2(__m128i x, __m128i a)
+    {
+        const __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, a), _mm_set1_epi16(0x80));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    // Two widened pixels of src, coverage c of them, over two of dst.
+    BLEND_TARGET("sse2") inline __m128i OverSse2(__m128i s, __m128i d, __m128i c)
+    {
+        s = ScaleSse2(s, c);
+        const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm_add_epi16(s, ScaleSse2(d, _mm_sub_epi16(_mm_set1_epi16(255), a)));
+    }
+
+    BLEND_TARGET("sse2") inline __m128i BlendSse2(__m128i s, __m128i d, __m128i c)
+    {
+        const __m128i z = _mm_setzero_si128();
+        const __m128i lo = OverSse2(_mm_unpacklo_epi8(s, z), _mm_unpacklo_epi8(d, z), _mm_unpacklo_epi8(c, z));
+        const __m128i hi = OverSse2(_mm_unpackhi_epi8(s, z), _mm_unpackhi_epi8(d, z), _mm_unpackhi_epi8(c, z));
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    BLEND_TARGET("sse2") inline __m128i SpreadSse2(uint32_t c4)
+    {
+        const __m128i c = _mm_cvtsi32_si128(static_cast<int>(c4));
+        const __m128i c2 = _mm_unpacklo_epi8(c, c);
+        return _mm_unpacklo_epi16(c2, c2);
+    }
+
+    BLEND_TARGET("sse2") void SolidSpanSse2(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage)
+    {
+        const __m128i s = _mm_set1_epi32(static_cast<int>(color));
+        const bool opaque = (color >> 24) == 255;
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t c4;
+            std::memcpy(&c4, coverage + i, sizeof c4);
+            if (c4 == 0)
+                continue;
+            __m128i *p = reinterpret_cast<__m128i *>(dst + i);
+            if (opaque && c4 == 0xFFFFFFFFu)
+                _mm_storeu_si128(p, s);
+            else
+                _mm_storeu_si128(p, BlendSse2(s, _mm_loadu_si128(p), SpreadSse2(c4)));
+        }
+        Scalar().solidSpan(dst + i, count - i, color, coverage + i);
+    }
+
+    BLEND_TARGET("sse2") void SpanSse2(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage)
+    {
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t c4;
+            std::memcpy(&c4, coverage + i, sizeof c4);
+            if (c4 == 0)
+                continue;
+            __m128i *p = reinterpret_cast<__m128i *>(dst + i);
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_si128(p, BlendSse2(s, _mm_loadu_si128(p), SpreadSse2(c4)));
+        }
+        Scalar().span(dst + i, count - i, src + i, coverage + i);
+    }
+
+    // SSE4.1: four pixels a block, with byte shuffles (SSSE3) spreading
+    // coverage and alpha and zero extension (SSE4.1) widening.
+
+    BLEND_TARGET("sse4.1") inline __m128i ScaleSse41(__m128i x, __m128i a)
+    {
+        const __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, a), _mm_set1_epi16(0x80));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    BLEND_TARGET("sse4.1") inline __m128i OverSse41(__m128i s, __m128i d, __m128i c)
+    {
+        s = ScaleSse41(s, c);
+        const __m128i alpha = _mm_setr_epi8(6, -1, 6, -1, 6, -1, 6, -1, 14, -1, 14, -1, 14, -1, 14, -1);
+        const __m128i a = _mm_shuffle_epi8(s, alpha);
+        return _mm_add_epi16(s, ScaleSse41(d, _mm_sub_epi16(_mm_set1_epi16(255), a)));
+    }
+
+    BLEND_TARGET("sse4.1") inline __m128i BlendSse41(__m128i s, __m128i d, __m128i c)
+    {
+        const __m128i z = _mm_setzero_si128();
+        const __m128i lo = OverSse41(_mm_cvtepu8_epi16(s), _mm_cvtepu8_epi16(d), _mm_cvtepu8_epi16(c));
+        const __m128i hi = OverSse41(_mm_unpackhi_epi8(s, z), _mm_unpackhi_epi8(d, z), _mm_unpackhi_epi8(c, z));
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    BLEND_TARGET("sse4.1") inline __m128i SpreadSse41(uint32_t c4)
+    {
+        const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+        return _mm_shuffle_epi8(_mm_cvtsi32_si128(static_cast<int>(c4)), spread);
+    }
+
+    BLEND_TARGET("sse4.1") void SolidSpanSse41(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage)
+    {
+        const __m128i s = _mm_set1_epi32(static_cast<int>(color));
+        const bool opaque = (color >> 24) == 255;
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t c4;
+            std::memcpy(&c4, coverage + i, sizeof c4);
+            if (c4 == 0)
+                continue;
+            __m128i *p = reinterpret_cast<__m128i *>(dst + i);
+            if (opaque && c4 == 0xFFFFFFFFu)
+                _mm_storeu_si128(p, s);
+            else
+                _mm_storeu_si128(p, BlendSse41(s, _mm_loadu_si128(p), SpreadSse41(c4)));
+        }
+        Scalar().solidSpan(dst + i, count - i, color, coverage + i);
+    }
+
+    BLEND_TARGET("sse4.1") void SpanSse41(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage)
+    {
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t c4;
+            std::memcpy(&c4, coverage + i, sizeof c4);
+            if (c4 == 0)
+                continue;
+            __m128i *p = reinterpret_cast<__m128i *>(dst + i);
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_si128(p, BlendSse41(s, _mm_loadu_si128(p), SpreadSse41(c4)));
+        }
+        Scalar().span(dst + i, count - i, src + i, coverage + i);
+    }
+
+    // AVX2: eight pixels a block. Widening and packing stay within each
+    // 128-bit half, so pixels come back where they were.
+
+    BLEND_TARGET("avx2") inline __m256i ScaleAvx2(__m256i x, __m256i a)
+    {
+        const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(x, a), _mm256_set1_epi16(0x80));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    BLEND_TARGET("avx2") inline __m256i OverAvx2(__m256i s, __m256i d, __m256i c)
+    {
+        s = ScaleAvx2(s, c);
+        const __m256i alpha = _mm256_setr_epi8(6, -1, 6, -1, 6, -1, 6, -1, 14, -1, 14, -1, 14, -1, 14, -1,
+                                               6, -1, 6, -1, 6, -1, 6, -1, 14, -1, 14, -1, 14, -1, 14, -1);
+        const __m256i a = _mm256_shuffle_epi8(s, alpha);
+        return _mm256_add_epi16(s, ScaleAvx2(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a)));
+    }
+
+    BLEND_TARGET("avx2") inline __m256i BlendAvx2(__m256i s, __m256i d, __m256i c)
+    {
+        const __m256i z = _mm256_setzero_si256();
+        const __m256i lo =
+            OverAvx2(_mm256_unpacklo_epi8(s, z), _mm256_unpacklo_epi8(d, z), _mm256_unpacklo_epi8(c, z));
+        const __m256i hi =
+            OverAvx2(_mm256_unpackhi_epi8(s, z), _mm256_unpackhi_epi8(d, z), _mm256_unpackhi_epi8(c, z));
+        return _mm256_packus_epi16(lo, hi);
+    }
+
+    BLEND_TARGET("avx2") inline __m256i SpreadAvx2(const uint8_t *coverage)
+    {
+        const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+                                                0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+        const __m128i c8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(coverage));
+        return _mm256_shuffle_epi8(_mm256_cvtepu8_epi32(c8), spread);
+    }
+
+    BLEND_TARGET("avx2") void SolidSpanAvx2(uint32_t *dst, int count, uint32_t color, const uint8_t *coverage)
+    {
+        const __m256i s = _mm256_set1_epi32(static_cast<int>(color));
+        const bool opaque = (color >> 24) == 255;
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint64_t c8;
+            std::memcpy(&c8, coverage + i, sizeof c8);
+            if (c8 == 0)
+                continue;
+            __m256i *p = reinterpret_cast<__m256i *>(dst + i);
+            if (opaque && c8 == ~0ull)
+                _mm256_storeu_si256(p, s);
+            else
+                _mm256_storeu_si256(p, BlendAvx2(s, _mm256_loadu_si256(p), SpreadAvx2(coverage + i)));
+        }
+        Scalar().solidSpan(dst + i, count - i, color, coverage + i);
+    }
+
+    BLEND_TARGET("avx2") void SpanAvx2(uint32_t *dst, int count, const uint32_t *src, const uint8_t *coverage)
+    {
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint64_t c8;
+            std::memcpy(&c8, coverage + i, sizeof c8);
+            if (c8 == 0)
+                continue;
+            __m256i *p = reinterpret_cast<__m256i *>(dst + i);
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            _mm256_storeu_si256(p, BlendAvx2(s, _mm256_loadu_si256(p), SpreadAvx2(coverage + i)));
+        }
+        Scalar().span(dst + i, count - i, src + i, coverage + i);
+    }
+
+    // AVX-512 (F and BW): sixteen pixels a block, four 128-bit quarters
+    // each working as AVX2's halves do.
+
+    BLEND_TARGET("avx512f,avx512bw") inline __m512i ScaleAvx512(__m512i x, __m512i a)
+    {
+        const __m512i t = _mm512_add_epi16(_mm512_mullo_epi16(x, a), _mm512_set1_epi16(0x80));
+        return _mm512_srli_epi16(_mm512_add_epi16(t, _mm512_srli_epi16(t, 8)), 8);
+    }
+
+    BLEND_TARGET("avx512f,avx512bw") inline __m512i OverAvx512(__m512i s, __m512i d, __m512i c)
+    {
+        s = ScaleAvx512(s, c);
+        // Per quarter, as AVX2's: bytes 6 and 14 zero-extended into each
+        // word of their pixel. (Set per quarter, not broadcast: GCC 12's
+        // broadcast reads an undefined register and warns.)
+        const __m512i alpha = _mm512_set4_epi32(static_cast<int>(0xFF0EFF0Eu), static_cast<int>(0xFF0EFF0Eu),
+                                                static_cast<int>(0xFF06FF06u), static_cast<int>(0xFF06FF06u));
+        const __m512i a = _mm512_shuffle_epi8(s, alpha);
+        return _mm512_add_epi16(s, ScaleAvx512(d, _mm512_sub_epi16(_mm512_set1_epi16(255), a)));
+    }
+
+    BLEND_TARGET("avx512f,avx512bw") inline __m512i BlendAvx512(__m512i s, __m512i d, __m512i c)
+    {
+        const __m512i z = _mm512_setzero_si512();
+        const __m512i lo =
+            OverAvx512(_mm512_unpacklo_epi8(s, z), _mm512_unpacklo_epi8(d, z), _mm512_unpacklo_epi8(c, z));
+        const __m512i hi =
+            OverAvx512(_mm512_unpackhi_epi8(s, z), _mm512_unpackhi_epi8(d, z), _mm512_unpackhi_epi8(c, z));
+        return _mm512_packus_epi16(lo, hi);
+    }
+
+    BLEND_TARGET("avx512f,avx512bw") inline __m512i SpreadAvx512(const uint8_t *coverage)
+    {
+        // Each pixel's coverage byte into all four of its bytes; widened
+        // under a full mask, as the unmasked form warns the same way.
+        const __m512i spread = _mm512_set4_epi32(0x0C0C0C0C, 0x08080808, 0x04040404, 0);
+        const __m128i c16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(coverage));
+        return _mm512_shuffle_epi8(_mm512_maskz_cvtepu8_epi32(0xFFFF, c16), spread);
+    }
+
+    BLEND_TARGET("avx512f,avx512bw") void SolidSpanAvx512(uint32_t *dst, int count, uint32_t color,
+                                                          const uint8_t *coverage)
+    {
+        const __m512i s = _mm512_set1_epi32(static_cast<int>(color));
+        const bool opaque = (color >> 24) == 255;
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            uint64_t c16[2];
+            std::memcpy(c16, coverage + i, sizeof c16);
+            if ((c16[0] | c16[1]) == 0)
+                continue;
+            uint32_t *p = dst + i;
+            if (opaque && (c16[0] & c16[1]) == ~0ull)
+                _mm512_storeu_si512(p, s);
+            else
+                _mm512_storeu_si512(p, BlendAvx512(s, _mm512_loadu_si512(p), SpreadAvx512(coverage + i)));
+        }
+        Scalar().solidSpan(dst + i, count - i, color, coverage + i);
+    }
+
+    BLEND_TARGET("avx512f,avx512bw") void SpanAvx512(uint32_t *dst, int count, const uint32_t *src,
+                                                     const uint8_t *coverage)
+    {
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            uint64_t c16[2];
+            std::memcpy(c16, coverage + i, sizeof c16);
+            if ((c16[0] | c16[1]) == 0)
+                continue;
+            uint32_t *p = dst + i;
+            _mm512_storeu_si512(p, BlendAvx512(_mm512_loadu_si512(src + i), _mm512_loadu_si512(p),
+                                               SpreadAvx512(coverage + i)));
+        }
+        Scalar().span(dst + i, count - i, src + i, coverage + i);
+    }
+
+    void CpuId(int leaf, int subleaf, uint32_t regs[4])
+    {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, leaf, subleaf);
+        for (int i = 0; i < 4; ++i)
+            regs[i] = static_cast<uint32_t>(r[i]);
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    // Which register state the OS saves across task switches (XCR0).
+    uint64_t SavedState()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+    }
+
+    struct Features
+    {
+        bool sse2 = false, sse41 = false, avx2 = false, avx512 = false;
+    };
+
+    // The wide sets also need the OS to save their registers: YMM state
+    // for AVX2, and the mask and ZMM state as well for AVX-512.
+    Features Detect()
+    {
+        Features cpu;
+        uint32_t r[4];
+        CpuId(0, 0, r);
+        const uint32_t maxLeaf = r[0];
+        if (maxLeaf < 1)
+            return cpu;
+        CpuId(1, 0, r);
+        cpu.sse2 = (r[3] >> 26) & 1;
+        cpu.sse41 = cpu.sse2 && ((r[2] >> 19) & 1);
+        const bool osxsave = (r[2] >> 27) & 1;
+        const uint64_t state = osxsave ? SavedState() : 0;
+        if (maxLeaf < 7 || (state & 0x6) != 0x6)
+            return cpu;
+        CpuId(7, 0, r);
+        cpu.avx2 = cpu.sse41 && ((r[1] >> 5) & 1);
+        cpu.avx512 = cpu.avx2 && ((r[1] >> 16) & 1) && ((r[1] >> 30) & 1) && (state & 0xE6) == 0xE6;
+        return cpu;
+    }
+
+    constexpr Kernels kSse2{SolidSpanSse2, SpanSse2};
+    constexpr Kernels kSse41{SolidSpanSse41, SpanSse41};
+    constexpr Kernels kAvx2{SolidSpanAvx2, SpanAvx2};
+    constexpr Kernels kAvx512{SolidSpanAvx512, SpanAvx512};
+}
+
+const SoftwareBlend::Kernels *SoftwareBlend::X86Kernels(Isa isa)
+{
+    static const Features cpu = Detect();
+    switch (isa)
+    {
+    case Isa::Sse2:
+        return cpu.sse2 ? &kSse2 : nullptr;
+    case Isa::Sse41:
+        return cpu.sse41 ? &kSse41 : nullptr;
+    case Isa::Avx2:
+        return cpu.avx2 ? &kAvx2 : nullptr;
+    case Isa::Avx512:
+        return cpu.avx512 ? &kAvx512 : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+#else
+
+const SoftwareBlend::Kernels *SoftwareBlend::X86Kernels(Isa)
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,234 @@
+#include "SoftwareFont.h"
+#include "SvgNumber.h"
+#include <vector>
+
+namespace
+{
+    // Glyphs are drawn on a grid of units, y up from the baseline: capitals
+    // and ascenders reach 12, the x-height is 8, descenders go to -4.
+    constexpr float kCapHeight = 0.7f;      // of the font size
+    constexpr float kUnitsPerCap = 12.0f;
+    constexpr float kWeight = 1.3f;         // pen width, in units
+    constexpr float kSpacing = 3.0f;        // added to each glyph's width
+    constexpr float kLineHeight = 1.15f;    // of the font size
+
+    struct GlyphSource
+    {
+        float width;
+        // Strokes separated by ';', each x,y points.
+        const char *strokes;
+    };
+
+    // ' ' to '~', in order.
+    const GlyphSource kGlyphs[] = {
+        {1.5f, ""},
+        {2, "1,12 1,3.5;1,0 1,0.6"},
+        {4, "1,12 1,9;3,12 3,9"},
+        {8, "2.5,0 3.5,12;5.5,0 6.5,12;0.5,4 8,4;0,8 7.5,8"},
+        {8, "8,10 7,11.5 5,12 3,12 1,11.5 0,10 0,8.5 1,7 3,6.3 5,5.7 7,5 8,3.5 8,2 7,0.5 5,0 3,0 1,0.5 0,2;"
+            "4,13.5 4,-1.5"},
+        {10, "10,12 0,0;2.5,12 1,11.5 0.5,10 1,8.5 2.5,8 4,8.5 4.5,10 4,11.5 2.5,12;"
+             "7.5,4 6,3.5 5.5,2 6,0.5 7.5,0 9,0.5 9.5,2 9,3.5 7.5,4"},
+        {9, "9,0 2,8.5 1.5,10 2,11.5 3.5,12 5,11.5 5.5,10 5,8.5 1,5.5 0,4 0,2 1,0.5 3,0 5,0.3 7,2 8,4"},
+        {2, "1,12 1,9"},
+        {4, "4,13 2,11 0.7,8 0.5,4 1,1 2,-1.5 4,-3"},
+        {4, "0,13 2,11 3.3,8 3.5,4 3,1 2,-1.5 0,-3"},
+        {6, "3,12 3,6;0.5,10.5 5.5,7.5;5.5,10.5 0.5,7.5"},
+        {8, "4,1 4,9;0,5 8,5"},
+        {2, "1,0.6 1,0 0,-2.5"},
+        {6, "0,5 6,5"},
+        {2, "1,0 1,0.6"},
+        {6, "6,13 0,-2"},
+        // 0 to 9.
+        {7, "3.5,0 1.5,0.7 0.3,3 0,6 0.3,9 1.5,11.3 3.5,12 5.5,11.3 6.7,9 7,6 6.7,3 5.5,0.7 3.5,0"},
+        {7, "1,9.5 4,12 4,0"},
+        {7, "0,10 1,11.5 3,12 5,12 6.5,11 7,9.5 6.5,7.5 0,0 7,0"},
+        {7, "0.5,12 7,12 3.5,7.5 5,7.5 6.5,6.7 7,5 7,3 6,1 4,0 2,0 0.5,1"},
+        {7, "5,0 5,12 0,3.5 7,3.5"},
+        {7, "6.5,12 1,12 0.5,6.7 2,7.5 4,7.7 6,7 7,5 7,3 6,1 4,0 2,0 0.5,1"},
+        {7, "6,12 4,12 2,11 0.5,9 0,6 0,3 1,1 3,0 4.5,0 6,0.7 7,2.5 7,4.5 6,6.3 4.5,7 3,7 1,6.3 0,4.5"},
+        {7, "0,12 7,12 2,0"},
+        {7, "3.5,6.5 1.5,7.2 0.7,9 1.5,11.3 3.5,12 5.5,11.3 6.3,9 5.5,7.2 3.5,6.5 1.5,5.8 0,4 0,2 1.5,0.5 "
+            "3.5,0 5.5,0.5 7,2 7,4 5.5,5.8 3.5,6.5"},
+        {7, "7,7.5 6,5.7 4,5 3,5 1,5.7 0,7.5 0,9.5 1,11.3 3,12 4,12 6,11.3 7,9 7,6 6.5,3 5,1 3,0 1,0"},
+        {2, "1,7.4 1,8;1,0 1,0.6"},
+        {2, "1,7.4 1,8;1,0.6 1,0 0,-2.5"},
+        {8, "8,10 0,5 8,0"},
+        {8, "0,7 8,7;0,3 8,3"},
+        {8, "0,10 8,5 0,0"},
+        {7, "0,9.5 0.7,11.2 2.5,12 4.5,12 6.3,11.2 7,9.5 6.3,7.8 3.5,6 3.5,3.5;3.5,0 3.5,0.6"},
+        {11, "8,4 7.5,7 6,8 4.5,8 3,7 2.5,5 3,3 4.5,2 6,2.5 7.5,4;"
+             "8,8 8,3 9,2 10,2.5 11,4.5 11,7 10,9.5 8,11.5 5.5,12 3,11.5 1,9.5 0,7 0,4 1,1.5 3,0 6,-0.3 8,0.5"},
+        // A to Z.
+        {8, "0,0 4,12 8,0;1.5,4 6.5,4"},
+        {8, "0,0 0,12 5,12 7,11 8,9.5 7,7 5,6 0,6;5,6 7,5 8,3 7,1 5,0 0,0"},
+        {8, "8,10 7,11.5 5,12 3,12 1,11 0,9 0,3 1,1 3,0 5,0 7,0.5 8,2"},
+        {8, "0,0 0,12 4,12 7,11 8,9 8,3 7,1 4,0 0,0"},
+        {7, "7,12 0,12 0,0 7,0;0,6 5,6"},
+        {7, "7,12 0,12 0,0;0,6 5,6"},
+        {8, "8,10 7,11.5 5,12 3,12 1,11 0,9 0,3 1,1 3,0 5,0 7,1 8,3 8,5 5,5"},
+        {8, "0,0 0,12;8,0 8,12;0,6 8,6"},
+        {2, "1,0 1,12"},
+        {6, "6,12 6,3 5,1 3,0 1,1 0,3"},
+        {8, "0,0 0,12;8,12 0,4;2.5,6.5 8,0"},
+        {7, "0,12 0,0 7,0"},
+        {10, "0,0 0,12 5,2 10,12 10,0"},
+        {8, "0,0 0,12 8,0 8,12"},
+        {8, "3,0 1,1 0,3 0,9 1,11 3,12 5,12 7,11 8,9 8,3 7,1 5,0 3,0"},
+        {8, "0,0 0,12 5,12 7,11 8,9.5 8,8.5 7,7 5,6 0,6"},
+        {8, "3,0 1,1 0,3 0,9 1,11 3,12 5,12 7,11 8,9 8,3 7,1 5,0 3,0;5,3 8.5,-1"},
+        {8, "0,0 0,12 5,12 7,11 8,9.5 8,8.5 7,7 5,6 0,6;4,6 8,0"},
+        {8, "8,10 7,11.5 5,12 3,12 1,11.5 0,10 0,8.5 1,7 3,6.3 5,5.7 7,5 8,3.5 8,2 7,0.5 5,0 3,0 1,0.5 0,2"},
+        {8, "0,12 8,12;4,12 4,0"},
+        {8, "0,12 0,3 1,1 3,0 5,0 7,1 8,3 8,12"},
+        {8, "0,12 4,0 8,12"},
+        {12, "0,12 3,0 6,9 9,0 12,12"},
+        {8, "0,12 8,0;8,12 0,0"},
+        {8, "0,12 4,6 8,12;4,6 4,0"},
+        {8, "0,12 8,12 0,0 8,0"},
+        {4, "4,13 1,13 1,-3 4,-3"},
+        {6, "0,13 6,-2"},
+        {4, "0,13 3,13 3,-3 0,-3"},
+        {8, "1,8 4,12 7,8"},
+        {8, "0,-3 8,-3"},
+        {3, "0,12 2,10"},
+        // a to z.
+        {7, "7,8 7,0;7,6 5.5,7.7 3.5,8 1.5,7.3 0,5.5 0,2.5 1.5,0.7 3.5,0 5.5,0.3 7,2"},
+        {7, "0,12 0,0;0,6 1.5,7.7 3.5,8 5.5,7.3 7,5.5 7,2.5 5.5,0.7 3.5,0 1.5,0.3 0,2"},
+        {7, "7,6.5 5.5,7.7 3.5,8 1.5,7.3 0,5.5 0,2.5 1.5,0.7 3.5,0 5.5,0.3 7,1.5"},
+        {7, "7,12 7,0;7,6 5.5,7.7 3.5,8 1.5,7.3 0,5.5 0,2.5 1.5,0.7 3.5,0 5.5,0.3 7,2"},
+        {7, "0,4 7,4 7,5.5 6,7.3 3.5,8 1.5,7.3 0,5.5 0,2.5 1.5,0.7 3.5,0 5.5,0.3 7,1.5"},
+        {5, "5,12 3.5,12 2,11 2,0;0,8 5,8"},
+        {7, "7,8 7,-1 6,-3 4,-4 2,-4 0.5,-3;7,6 5.5,7.7 3.5,8 1.5,7.3 0,5.5 0,2.5 1.5,0.7 3.5,0 5.5,0.3 7,2"},
+        {7, "0,12 0,0;0,6 1.5,7.7 3.5,8 5.5,7.7 7,6 7,0"},
+        {2, "1,0 1,8;1,10.8 1,11.4"},
+        {4, "3,8 3,-2 2,-3.7 0,-4;3,10.8 3,11.4"},
+        {7, "0,12 0,0;7,8 0,3;2.5,4.5 7,0"},
+        {2, "1,12 1,0"},
+        {11, "0,8 0,0;0,6 1.5,7.7 3,8 4.5,7.7 5.5,6 5.5,0;5.5,6 7,7.7 8.5,8 10,7.7 11,6 11,0"},
+        {7, "0,8 0,0;0,6 1.5,7.7 3.5,8 5.5,7.7 7,6 7,0"},
+        {7, "3.5,0 1.5,0.7 0,2.5 0,5.5 1.5,7.3 3.5,8 5.5,7.3 7,5.5 7,2.5 5.5,0.7 3.5,0"},
+        {7, "0,8 0,-4;0,6 1.5,7.7 3.5,8 5.5,7.3 7,5.5 7,2.5 5.5,0.7 3.5,0 1.5,0.3 0,2"},
+        {7, "7,8 7,-4;7,6 5.5,7.7 3.5,8 1.5,7.3 0,5.5 0,2.5 1.5,0.7 3.5,0 5.5,0.3 7,2"},
+        {5, "0,8 0,0;0,5 1,7 3,8 5,8"},
+        {7, "7,6.5 5.5,7.7 3.5,8 1.5,7.7 0,6.5 0.5,5 2,4.3 5,3.7 6.5,3 7,1.5 5.5,0.3 3.5,0 1.5,0.3 0,1.5"},
+        {5, "2,11 2,1 3,0 5,0;0,8 5,8"},
+        {7, "0,8 0,2 1.5,0.3 3.5,0 5.5,0.3 7,2;7,8 7,0"},
+        {7, "0,8 3.5,0 7,8"},
+        {10, "0,8 2.5,0 5,6 7.5,0 10,8"},
+        {7, "0,8 7,0;7,8 0,0"},
+        {7, "0,8 3.5,0;7,8 3.5,0 2,-3 0.5,-4"},
+        {7, "0,8 7,8 0,0 7,0"},
+        {5, "5,13 3.5,12.5 3,11 3,7 2.5,5.5 1,5 2.5,4.5 3,3 3,-1 3.5,-2.5 5,-3"},
+        {2, "1,13 1,-3"},
+        {5, "0,13 1.5,12.5 2,11 2,7 2.5,5.5 4,5 2.5,4.5 2,3 2,-1 1.5,-2.5 0,-3"},
+        {8, "0,5 1,6.3 2.5,6.8 4,6 5.5,5.2 7,5.7 8,7"},
+    };
+    constexpr wchar_t kFirst = L' ', kLast = L'~';
+    static_assert(sizeof kGlyphs / sizeof kGlyphs[0] == kLast - kFirst + 1, "a glyph for each of ' ' to '~'");
+
+    // What characters without a glyph show.
+    const GlyphSource kMissing = {7, "0,0 0,12 7,12 7,0 0,0"};
+
+    struct Glyph
+    {
+        float width;
+        // Each stroke's points, as x, y pairs in units.
+        std::vector<std::vector<float>> strokes;
+    };
+
+    Glyph Parse(const GlyphSource &source)
+    {
+        Glyph glyph{source.width, {}};
+        std::string_view rest(source.strokes);
+        while (!rest.empty())
+        {
+            const size_t end = rest.find(';');
+            SvgNumberList numbers(rest.substr(0, end));
+            std::vector<float> stroke;
+            for (float value; numbers.Next(value);)
+                stroke.push_back(value);
+            if (stroke.size() >= 4)
+                glyph.strokes.push_back(std::move(stroke));
+            rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+        }
+        return glyph;
+    }
+
+    // The glyphs, read from their sources once.
+    struct Font
+    {
+        std::vector<Glyph> glyphs;
+        Glyph missing;
+
+        Font() : missing(Parse(kMissing))
+        {
+            for (const GlyphSource &source : kGlyphs)
+                glyphs.push_back(Parse(source));
+        }
+
+        const Glyph &operator[](wchar_t ch) const
+        {
+            return ch >= kFirst && ch <= kLast ? glyphs[ch - kFirst] : missing;
+        }
+    };
+
+    const Font &TheFont()
+    {
+        static const Font font;
+        return font;
+    }
+
+    float LineWidth(const Font &font, std::wstring_view line)
+    {
+        float width = 0.0f;
+        for (wchar_t ch : line)
+            width += font[ch].width + kSpacing;
+        return width;
+    }
+}
+
+namespace SoftwareFont
+{
+    void AddText(SoftwareOutline &outline, std::wstring_view text, float x, float y, float size,
+                 SvgTextAnchor anchor)
+    {
+        const Font &font = TheFont();
+        const float unit = size * kCapHeight / kUnitsPerCap;
+        std::vector<float> xy;
+        for (float baseline = y; !text.empty(); baseline += size * kLineHeight)
+        {
+            const size_t end = text.find(L'\n');
+            const std::wstring_view line = text.substr(0, end);
+            text = end == std::wstring_view::npos ? std::wstring_view() : text.substr(end + 1);
+
+            float pen = x;
+            if (anchor == SvgTextAnchor::Middle)
+                pen -= LineWidth(font, line) * unit * 0.5f;
+            else if (anchor == SvgTextAnchor::End)
+                pen -= LineWidth(font, line) * unit;
+            for (wchar_t ch : line)
+            {
+                const Glyph &glyph = font[ch];
+                // Half the spacing each side of the glyph.
+                const float left = pen + kSpacing * 0.5f * unit;
+                for (const std::vector<float> &stroke : glyph.strokes)
+                {
+                    xy.resize(stroke.size());
+                    for (size_t i = 0; i < stroke.size(); i += 2)
+                    {
+                        xy[i] = left + stroke[i] * unit;
+                        xy[i + 1] = baseline - stroke[i + 1] * unit;
+                    }
+                    outline.AddPolyline(xy.data(), xy.size() / 2, false);
+                }
+                pen += (glyph.width + kSpacing) * unit;
+            }
+        }
+    }
+
+    float Weight(float size)
+    {
+        return size * kCapHeight / kUnitsPerCap * kWeight;
+    }
+}
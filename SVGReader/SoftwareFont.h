@@ -0,0 +1,30 @@
+#ifndef _SOFTWAREFONT_H_
+#define _SOFTWAREFONT_H_
+
+#include "SoftwareOutline.h"
+#include "SvgStyle.h"
+#include <string_view>
+
+// The font SoftwareRenderer draws text with: a built-in stroke font, so
+// text renders the same on every platform with no font files or font
+// engine. Each glyph is a few centre lines drawn with a round pen; the
+// printable ASCII characters have glyphs of their own, anything else
+// shows as an empty box.
+//
+// Metrics follow a sans-serif font of the given size: capitals reach 0.7
+// of it above the baseline, descenders 0.23 below, lines are 1.15 apart,
+// and no glyph is wider than 0.9 of it, inside the box SvgText::
+// UpdateFillBox allows.
+namespace SoftwareFont
+{
+    // Adds the centre lines of text's glyphs to outline as open figures:
+    // the first line's baseline at y, each line placed about x as anchor
+    // says, lines broken at '\n'.
+    void AddText(SoftwareOutline &outline, std::wstring_view text, float x, float y, float size,
+                 SvgTextAnchor anchor);
+
+    // Width of the pen the glyphs are drawn with at that size.
+    float Weight(float size);
+}
+
+#endif
@@ -0,0 +1,282 @@
+#include "SoftwareOutline.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    using Point = SoftwareOutline::Point;
+
+    Point Rotate(Point p, float angle)
+    {
+        const float c = std::cos(angle), s = std::sin(angle);
+        return {p.x * c - p.y * s, p.x * s + p.y * c};
+    }
+
+    // Largest angle one chord of a circle of radius r may span and stay
+    // within tolerance of the arc.
+    float ArcStep(float r, float tolerance)
+    {
+        return 2.0f * std::acos((std::max)(1.0f - tolerance / r, -1.0f));
+    }
+}
+
+void SoftwareOutline::Clear()
+{
+    m_points.clear();
+    m_figures.clear();
+    m_figureStart = 0;
+}
+
+void SoftwareOutline::MoveTo(float x, float y)
+{
+    EndFigure(false);
+    m_points.push_back({x, y});
+}
+
+void SoftwareOutline::LineTo(float x, float y)
+{
+    m_points.push_back({x, y});
+}
+
+void SoftwareOutline::CubicTo(float x1, float y1, float x2, float y2, float x3, float y3, float tolerance)
+{
+    const Point p0 = m_points.back();
+    // How far the curve can stray from its chords shrinks with the square
+    // of the number of pieces (Wang's formula).
+    const float ddx = (std::max)(std::fabs(p0.x - 2.0f * x1 + x2), std::fabs(x1 - 2.0f * x2 + x3));
+    const float ddy = (std::max)(std::fabs(p0.y - 2.0f * y1 + y2), std::fabs(y1 - 2.0f * y2 + y3));
+    const float dd = std::sqrt(ddx * ddx + ddy * ddy);
+    const float pieces = std::ceil(std::sqrt(0.75f * dd / tolerance));
+    const int n = std::isfinite(pieces) ? std::clamp(static_cast<int>(pieces), 1, 1000) : 1;
+    for (int i = 1; i < n; ++i)
+    {
+        const float t = static_cast<float>(i) / static_cast<float>(n);
+        const float u = 1.0f - t;
+        const float b0 = u * u * u, b1 = 3.0f * u * u * t, b2 = 3.0f * u * t * t, b3 = t * t * t;
+        LineTo(b0 * p0.x + b1 * x1 + b2 * x2 + b3 * x3, b0 * p0.y + b1 * y1 + b2 * y2 + b3 * y3);
+    }
+    LineTo(x3, y3);
+}
+
+void SoftwareOutline::EndFigure(bool closed)
+{
+    const uint32_t end = static_cast<uint32_t>(m_points.size());
+    if (end > m_figureStart)
+        m_figures.push_back({m_figureStart, end, closed});
+    m_figureStart = end;
+}
+
+void SoftwareOutline::AddPath(const PathData &path, float tolerance)
+{
+    // Movetos only start a figure once something is drawn from them, as in
+    // GdiPlusRenderer::DrawPath.
+    const float *c = path.Coords().data();
+    bool open = false;
+    Point start{};
+    for (PathVerb verb : path.Verbs())
+    {
+        switch (verb)
+        {
+        case PathVerb::MoveTo:
+            if (open)
+                EndFigure(false);
+            open = false;
+            start = {c[0], c[1]};
+            break;
+        case PathVerb::LineTo:
+        case PathVerb::CubicTo:
+            if (!open)
+            {
+                MoveTo(start.x, start.y);
+                open = true;
+            }
+            if (verb == PathVerb::LineTo)
+                LineTo(c[0], c[1]);
+            else
+                CubicTo(c[0], c[1], c[2], c[3], c[4], c[5], tolerance);
+            break;
+        case PathVerb::Close:
+            if (open)
+                EndFigure(true);
+            open = false;
+            break;
+        }
+        c += PathData::CoordCount(verb);
+    }
+    if (open)
+        EndFigure(false);
+}
+
+void SoftwareOutline::AddRect(float x, float y, float w, float h)
+{
+    if (w <= 0.0f || h <= 0.0f)
+        return;
+    MoveTo(x, y);
+    LineTo(x + w, y);
+    LineTo(x + w, y + h);
+    LineTo(x, y + h);
+    EndFigure(true);
+}
+
+void SoftwareOutline::AddEllipse(float cx, float cy, float rx, float ry, float tolerance)
+{
+    if (rx <= 0.0f || ry <= 0.0f)
+        return;
+    const float steps = std::ceil(2.0f * kPi / ArcStep((std::max)(rx, ry), tolerance));
+    const int n = std::isfinite(steps) ? std::clamp(static_cast<int>(steps), 8, 1024) : 8;
+    MoveTo(cx + rx, cy);
+    for (int i = 1; i < n; ++i)
+    {
+        const float angle = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(n);
+        LineTo(cx + rx * std::cos(angle), cy + ry * std::sin(angle));
+    }
+    EndFigure(true);
+}
+
+void SoftwareOutline::AddPolyline(const float *xy, size_t count, bool closed)
+{
+    if (count == 0)
+        return;
+    MoveTo(xy[0], xy[1]);
+    for (size_t i = 1; i < count; ++i)
+        LineTo(xy[2 * i], xy[2 * i + 1]);
+    EndFigure(closed);
+}
+
+void SoftwareOutline::AddConvex(const Point *pts, size_t count)
+{
+    float area = 0.0f;
+    for (size_t i = 0, j = count - 1; i < count; j = i++)
+        area += pts[j].x * pts[i].y - pts[i].x * pts[j].y;
+    if (area == 0.0f || !std::isfinite(area))
+        return;
+    EndFigure(false);
+    if (area > 0.0f)
+        m_points.insert(m_points.end(), pts, pts + count);
+    else
+        m_points.insert(m_points.end(), std::make_reverse_iterator(pts + count), std::make_reverse_iterator(pts));
+    EndFigure(true);
+}
+
+void SoftwareOutline::AddWedge(Point c, Point from, float angle, float r, float tolerance)
+{
+    const float steps = std::ceil(std::fabs(angle) / ArcStep(r, tolerance));
+    const int n = std::isfinite(steps) ? std::clamp(static_cast<int>(steps), 1, 256) : 1;
+    Point pts[258];
+    size_t count = 0;
+    const bool full = std::fabs(angle) >= 2.0f * kPi - 1e-4f;
+    if (!full)
+        pts[count++] = c;
+    for (int i = 0; i <= n; ++i)
+    {
+        if (full && i == n)
+            break;
+        const Point p = Rotate(from, angle * static_cast<float>(i) / static_cast<float>(n));
+        pts[count++] = {c.x + p.x, c.y + p.y};
+    }
+    AddConvex(pts, count);
+}
+
+void SoftwareOutline::Stroke(SoftwareOutline &out, float width, Join join, Cap cap, float miterLimit,
+                             float tolerance) const
+{
+    const float hw = 0.5f * width;
+    if (!(hw > 0.0f))
+        return;
+
+    std::vector<Point> pts;
+    for (const Figure &figure : m_figures)
+    {
+        // Repeated points have no direction to stroke along.
+        pts.clear();
+        for (uint32_t i = figure.begin; i < figure.end; ++i)
+        {
+            const Point p = m_points[i];
+            if (pts.empty() || std::fabs(p.x - pts.back().x) > 1e-6f || std::fabs(p.y - pts.back().y) > 1e-6f)
+                pts.push_back(p);
+        }
+        if (figure.closed && pts.size() > 1 && std::fabs(pts.front().x - pts.back().x) <= 1e-6f &&
+            std::fabs(pts.front().y - pts.back().y) <= 1e-6f)
+            pts.pop_back();
+
+        const size_t n = pts.size();
+        if (n == 0)
+            continue;
+        if (n == 1)
+        {
+            // A lone point only shows with round caps, as a dot.
+            if (cap == Cap::Round && !figure.closed)
+                out.AddWedge(pts[0], {hw, 0.0f}, 2.0f * kPi, hw, tolerance);
+            continue;
+        }
+
+        const size_t segments = figure.closed ? n : n - 1;
+        auto direction = [&](size_t s)
+        {
+            const Point a = pts[s], b = pts[(s + 1) % n];
+            const float dx = b.x - a.x, dy = b.y - a.y;
+            const float len = std::sqrt(dx * dx + dy * dy);
+            return Point{dx / len, dy / len};
+        };
+
+        for (size_t s = 0; s < segments; ++s)
+        {
+            const Point a = pts[s], b = pts[(s + 1) % n];
+            const Point d = direction(s);
+            const Point side{-d.y * hw, d.x * hw};
+            const Point quad[4] = {{a.x + side.x, a.y + side.y}, {b.x + side.x, b.y + side.y},
+                                   {b.x - side.x, b.y - side.y}, {a.x - side.x, a.y - side.y}};
+            out.AddConvex(quad, 4);
+        }
+
+        // Each vertex between two segments gets what the two quads leave
+        // open on the outside of the turn.
+        const size_t firstJoint = figure.closed ? 0 : 1;
+        const size_t lastJoint = figure.closed ? n : n - 1;
+        for (size_t v = firstJoint; v < lastJoint; ++v)
+        {
+            const Point d0 = direction((v + segments - 1) % segments);
+            const Point d1 = direction(v % segments);
+            const float cross = d0.x * d1.y - d0.y * d1.x;
+            const float dot = d0.x * d1.x + d0.y * d1.y;
+            const float turn = std::atan2(cross, dot);
+            if (std::fabs(turn) < 1e-4f)
+                continue;
+            // The outside of a left turn is on the right, and the reverse.
+            const float outward = cross > 0.0f ? -hw : hw;
+            const Point o0{-d0.y * outward, d0.x * outward};
+            const Point o1{-d1.y * outward, d1.x * outward};
+            const Point c = pts[v];
+            if (join == Join::Round)
+            {
+                out.AddWedge(c, o0, turn, hw, tolerance);
+                continue;
+            }
+            // A miter reaches 1 / cos(turn / 2) half widths out.
+            const float cosHalf = std::sqrt((std::max)(0.5f * (1.0f + dot), 0.0f));
+            if (cosHalf > 0.0f && 1.0f / cosHalf <= miterLimit)
+            {
+                const float k = 1.0f / (1.0f + dot);
+                const Point miter[4] = {c, {c.x + o0.x, c.y + o0.y},
+                                        {c.x + (o0.x + o1.x) * k, c.y + (o0.y + o1.y) * k},
+                                        {c.x + o1.x, c.y + o1.y}};
+                out.AddConvex(miter, 4);
+            }
+            else
+            {
+                const Point bevel[3] = {c, {c.x + o0.x, c.y + o0.y}, {c.x + o1.x, c.y + o1.y}};
+                out.AddConvex(bevel, 3);
+            }
+        }
+
+        if (!figure.closed && cap == Cap::Round)
+        {
+            const Point d0 = direction(0);
+            const Point d1 = direction(segments - 1);
+            out.AddWedge(pts[0], {-d0.y * hw, d0.x * hw}, kPi, hw, tolerance);
+            out.AddWedge(pts[n - 1], {d1.y * hw, -d1.x * hw}, kPi, hw, tolerance);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef _SOFTWAREOUTLINE_H_
+#define _SOFTWAREOUTLINE_H_
+
+#include "PathData.h"
+#include "SvgTransform.h"
+#include <cstdint>
+#include <vector>
+
+// A shape as polygons: figures of points with the curves already flattened
+// to within a tolerance. The software renderer builds one per element in
+// the element's own space, fills it through the element's matrix, and
+// strokes it there too, so a stroke scales and shears with its shape.
+class SoftwareOutline
+{
+public:
+    struct Point
+    {
+        float x, y;
+    };
+
+    struct Figure
+    {
+        uint32_t begin, end;   // range of points
+        bool closed;
+    };
+
+    enum class Join : uint8_t
+    {
+        Miter,
+        Round
+    };
+
+    enum class Cap : uint8_t
+    {
+        Butt,
+        Round
+    };
+
+    void Clear();
+
+    // Curves are split into lines no further than tolerance from the curve.
+    void AddPath(const PathData &path, float tolerance);
+    void AddRect(float x, float y, float w, float h);
+    void AddEllipse(float cx, float cy, float rx, float ry, float tolerance);
+    // closed: the last point joins back to the first, as for a polygon.
+    void AddPolyline(const float *xy, size_t count, bool closed);
+
+    // Adds to out the area a pen of width covers when drawn along every
+    // figure, as convex pieces that all turn the same way, so a nonzero
+    // fill of out unites them. Miters longer than miterLimit half widths
+    // become bevels.
+    void Stroke(SoftwareOutline &out, float width, Join join, Cap cap, float miterLimit, float tolerance) const;
+
+    const std::vector<Point> &Points() const { return m_points; }
+    const std::vector<Figure> &Figures() const { return m_figures; }
+    bool Empty() const { return m_figures.empty(); }
+
+private:
+    void MoveTo(float x, float y);
+    void LineTo(float x, float y);
+    void CubicTo(float x1, float y1, float x2, float y2, float x3, float y3, float tolerance);
+    void EndFigure(bool closed);
+    // Adds the convex polygon pts as a closed figure, turning the standard
+    // way whichever way pts runs.
+    void AddConvex(const Point *pts, size_t count);
+    // The pie slice of radius r about c from offset from, swept by angle.
+    void AddWedge(Point c, Point from, float angle, float r, float tolerance);
+
+    std::vector<Point> m_points;
+    std::vector<Figure> m_figures;
+    uint32_t m_figureStart = 0;
+};
+
+#endif
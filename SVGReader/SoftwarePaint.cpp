@@ -0,0 +1,209 @@
+#include "SoftwarePaint.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // How far out a focal point may sit, as a fraction of the radius. SVG
+    // moves one outside onto the circle; just inside, every ray from it
+    // still leaves the circle once.
+    constexpr float kFocusLimit = 0.999f;
+
+    // The matrix undoing m; false if m flattens the plane.
+    bool Invert(const SvgMatrix &m, SvgMatrix &inverse)
+    {
+        const float det = m.a * m.d - m.b * m.c;
+        if (det == 0.0f || !std::isfinite(det))
+            return false;
+        const float k = 1.0f / det;
+        inverse = {m.d * k, -m.b * k, -m.c * k, m.a * k, (m.c * m.f - m.d * m.e) * k, (m.b * m.e - m.a * m.f) * k};
+        return true;
+    }
+}
+
+SoftwarePaint SoftwarePaint::FromGradient(const SvgGradient &gradient, const SvgBounds &box,
+                                          const SvgMatrix &toDevice, float opacity)
+{
+    SoftwarePaint paint;
+    if (gradient.stops.empty())
+        return paint;
+    const SvgGradientLut &lut = gradient.GetLut(opacity);
+    const uint32_t lastColor = lut.colors[SvgGradientLut::kSize - 1];
+    if (gradient.stops.size() == 1)
+        return SoftwarePaint(lastColor);
+    paint.m_lut = &lut;
+
+    // gradient space -> element space -> pixels.
+    SvgMatrix toElement = gradient.gradientTransform;
+    if (gradient.gradientUnits != "userSpaceOnUse")
+    {
+        const float w = box.maxX - box.minX, h = box.maxY - box.minY;
+        if (box.Empty() || !(w > 0.0f) || !(h > 0.0f))
+            return SoftwarePaint();
+        toElement = SvgMatrix{w, 0.0f, 0.0f, h, box.minX, box.minY} * toElement;
+    }
+    SvgMatrix fromDevice;
+    if (!Invert(toDevice * toElement, fromDevice))
+        return SoftwarePaint();
+
+    if (gradient.spreadMethod == "reflect")
+        paint.m_spread = Spread::Reflect;
+    else if (gradient.spreadMethod == "repeat")
+        paint.m_spread = Spread::Repeat;
+
+    if (gradient.type == GradientType::Linear)
+    {
+        const auto &linear = static_cast<const SvgLinearGradient &>(gradient);
+        const float dx = linear.x2 - linear.x1, dy = linear.y2 - linear.y1;
+        const float lengthSq = dx * dx + dy * dy;
+        // No direction: the last stop everywhere.
+        if (!(lengthSq > 1e-12f) || !std::isfinite(lengthSq))
+            return SoftwarePaint(lastColor);
+        // t = (p - start) . (end - start) / |end - start|^2
+        const float ax = dx / lengthSq, ay = dy / lengthSq;
+        const SvgMatrix project{ax, 0.0f, ay, 0.0f, -(ax * linear.x1 + ay * linear.y1), 0.0f};
+        paint.m_kind = Kind::Linear;
+        paint.m_fromDevice = project * fromDevice;
+        // x along the gradient's vector, y across it.
+        paint.m_frame = toDevice * toElement * SvgMatrix{dx, dy, -dy, dx, linear.x1, linear.y1};
+    }
+    else
+    {
+        const auto &radial = static_cast<const SvgRadialGradient &>(gradient);
+        const float r = radial.r;
+        if (!(r > 0.0f) || !std::isfinite(r))
+            return SoftwarePaint(lastColor);
+        float dx = ((radial.hasFx ? radial.fx : radial.cx) - radial.cx) / r;
+        float dy = ((radial.hasFy ? radial.fy : radial.cy) - radial.cy) / r;
+        if (!std::isfinite(dx) || !std::isfinite(dy))
+            dx = dy = 0.0f;
+        const float distance = std::hypot(dx, dy);
+        if (distance > kFocusLimit)
+        {
+            dx *= kFocusLimit / distance;
+            dy *= kFocusLimit / distance;
+        }
+        const float fx = radial.cx + dx * r, fy = radial.cy + dy * r;
+        const SvgMatrix normalize{1.0f / r, 0.0f, 0.0f, 1.0f / r, -fx / r, -fy / r};
+        paint.m_kind = Kind::Radial;
+        paint.m_fromDevice = normalize * fromDevice;
+        paint.m_frame = toDevice * toElement * SvgMatrix{r, 0.0f, 0.0f, r, fx, fy};
+        paint.m_dx = dx;
+        paint.m_dy = dy;
+        paint.m_a = 1.0f - (dx * dx + dy * dy);
+    }
+    return paint;
+}
+
+template <SoftwarePaint::Spread S>
+int SoftwarePaint::LutIndex(float t)
+{
+    if constexpr (S == Spread::Repeat)
+    {
+        t -= std::floor(t);
+    }
+    else if constexpr (S == Spread::Reflect)
+    {
+        t = std::fabs(t);
+        t -= 2.0f * std::floor(0.5f * t);
+        if (t > 1.0f)
+            t = 2.0f - t;
+    }
+    // Pads, which also sends a t that was not finite to the first entry.
+    if (!(t > 0.0f))
+        return 0;
+    if (t >= 1.0f)
+        return SvgGradientLut::kSize - 1;
+    return static_cast<int>(t * (SvgGradientLut::kSize - 1) + 0.5f);
+}
+
+template <SoftwarePaint::Spread S>
+void SoftwarePaint::ShadeLinear(float px, float py, int count, uint32_t *out) const
+{
+    // t is affine in the pixel, so it rises by a each pixel along the row.
+    const SvgMatrix &m = m_fromDevice;
+    const float t = m.a * px + m.c * py + m.e;
+    for (int i = 0; i < count; ++i)
+        out[i] = m_lut->colors[LutIndex<S>(t + m.a * static_cast<float>(i))];
+}
+
+template <SoftwarePaint::Spread S>
+void SoftwarePaint::ShadeRadial(float px, float py, int count, uint32_t *out) const
+{
+    // For q, the point from the focal point, and d, the focal point from
+    // the centre, t is where the ray from the focal point through q leaves
+    // the circle: |d + q / t| = 1, so
+    //   t = (b + sqrt(b^2 + a |q|^2)) / a,  b = d . q,  a = 1 - |d|^2.
+    // Along the row q steps by a constant, so b steps by one too and the
+    // discriminant by second differences; only the root is left per pixel.
+    // Doubles, as the differences are summed over the whole span.
+    const SvgMatrix &m = m_fromDevice;
+    const double qx = m.a * px + m.c * py + m.e, qy = m.b * px + m.d * py + m.f;
+    const double sx = m.a, sy = m.b;
+    const double a = m_a, inverseA = 1.0 / a;
+    double b = m_dx * qx + m_dy * qy;
+    const double db = m_dx * sx + m_dy * sy;
+    double disc = b * b + a * (qx * qx + qy * qy);
+    double dDisc = 2.0 * b * db + db * db + a * (2.0 * (qx * sx + qy * sy) + sx * sx + sy * sy);
+    const double ddDisc = 2.0 * (db * db + a * (sx * sx + sy * sy));
+    for (int i = 0; i < count; ++i)
+    {
+        const double t = (b + std::sqrt((std::max)(disc, 0.0))) * inverseA;
+        out[i] = m_lut->colors[LutIndex<S>(static_cast<float>(t))];
+        b += db;
+        disc += dDisc;
+        dDisc += ddDisc;
+    }
+}
+
+float SoftwarePaint::GetT(float x, float y) const
+{
+    const SvgMatrix &m = m_fromDevice;
+    const float qx = m.a * x + m.c * y + m.e, qy = m.b * x + m.d * y + m.f;
+    if (m_kind == Kind::Linear)
+        return qx;
+    if (m_kind == Kind::Solid)
+        return 0.0f;
+    // As ShadeRadial, at one point.
+    const float b = m_dx * qx + m_dy * qy;
+    return (b + std::sqrt((std::max)(b * b + m_a * (qx * qx + qy * qy), 0.0f))) / m_a;
+}
+
+uint32_t SoftwarePaint::GetColor(float t) const
+{
+    if (m_kind == Kind::Solid)
+        return m_color;
+    if (m_spread == Spread::Pad)
+        return m_lut->colors[LutIndex<Spread::Pad>(t)];
+    if (m_spread == Spread::Reflect)
+        return m_lut->colors[LutIndex<Spread::Reflect>(t)];
+    return m_lut->colors[LutIndex<Spread::Repeat>(t)];
+}
+
+void SoftwarePaint::Shade(int x, int y, int count, uint32_t *out) const
+{
+    const float px = static_cast<float>(x) + 0.5f;
+    const float py = static_cast<float>(y) + 0.5f;
+    switch (m_kind)
+    {
+    case Kind::Solid:
+        std::fill_n(out, count, m_color);
+        break;
+    case Kind::Linear:
+        if (m_spread == Spread::Pad)
+            ShadeLinear<Spread::Pad>(px, py, count, out);
+        else if (m_spread == Spread::Reflect)
+            ShadeLinear<Spread::Reflect>(px, py, count, out);
+        else
+            ShadeLinear<Spread::Repeat>(px, py, count, out);
+        break;
+    case Kind::Radial:
+        if (m_spread == Spread::Pad)
+            ShadeRadial<Spread::Pad>(px, py, count, out);
+        else if (m_spread == Spread::Reflect)
+            ShadeRadial<Spread::Reflect>(px, py, count, out);
+        else
+            ShadeRadial<Spread::Repeat>(px, py, count, out);
+        break;
+    }
+}
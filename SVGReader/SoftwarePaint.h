@@ -0,0 +1,87 @@
+#ifndef _SOFTWAREPAINT_H_
+#define _SOFTWAREPAINT_H_
+
+#include "SvgGradient.h"
+#include "SvgTransform.h"
+#include <cstdint>
+
+// What the software renderer fills a shape with, evaluated per device
+// pixel: one premultiplied colour, or a gradient mapped from its own space
+// through the shape's matrix onto the pixels. Built per draw; a gradient
+// paint reads the colour table its gradient keeps (SvgGradient::GetLut),
+// so it must not outlive the gradient.
+class SoftwarePaint
+{
+public:
+    // Transparent.
+    SoftwarePaint() = default;
+    explicit SoftwarePaint(uint32_t premultiplied) : m_color(premultiplied) {}
+
+    // box is the shape's fillBox, what objectBoundingBox units refer to;
+    // toDevice maps the shape's space to pixels. opacity scales every stop.
+    static SoftwarePaint FromGradient(const SvgGradient &gradient, const SvgBounds &box, const SvgMatrix &toDevice,
+                                      float opacity);
+
+    bool IsSolid() const { return m_kind == Kind::Solid; }
+    uint32_t GetColor() const { return m_color; }
+    // Solid and fully transparent: drawing it changes nothing.
+    bool IsClear() const { return IsSolid() && (m_color >> 24) == 0; }
+
+    // Writes the count premultiplied pixels from (x, y) along the row,
+    // sampled at pixel centres. Along a row the gradient's coordinates step
+    // by a constant, so nothing is mapped per pixel.
+    void Shade(int x, int y, int count, uint32_t *out) const;
+
+    // For backends that fill with gradient brushes of their own (GDI+).
+    // A gradient paint's frame maps onto the pixels the space in which a
+    // linear gradient's t is x, and a radial gradient is the unit circle
+    // around GetCenterX/Y seen from its focal point at the origin; t
+    // grows along the rays from there, reaching 1 on the circle.
+    bool IsRadial() const { return m_kind == Kind::Radial; }
+    bool IsPadded() const { return m_spread == Spread::Pad; }
+    const SvgMatrix &GetFrame() const { return m_frame; }
+    float GetCenterX() const { return -m_dx; }
+    float GetCenterY() const { return -m_dy; }
+    // t at a device point, before spreading; Shade samples (x + 0.5, y + 0.5).
+    float GetT(float x, float y) const;
+    // The premultiplied colour for t, spread as the gradient says.
+    uint32_t GetColor(float t) const;
+
+private:
+    enum class Kind : uint8_t
+    {
+        Solid,
+        Linear,
+        Radial
+    };
+    enum class Spread : uint8_t
+    {
+        Pad,
+        Reflect,
+        Repeat
+    };
+
+    // The table entry for t, spread.
+    template <Spread S>
+    static int LutIndex(float t);
+    template <Spread S>
+    void ShadeLinear(float px, float py, int count, uint32_t *out) const;
+    template <Spread S>
+    void ShadeRadial(float px, float py, int count, uint32_t *out) const;
+
+    Kind m_kind = Kind::Solid;
+    Spread m_spread = Spread::Pad;
+    uint32_t m_color = 0;
+    // Pixels to gradient space, scaled so that the linear gradient's t is
+    // x there, and so that the radial one's circle has radius 1 and its
+    // focal point is the origin.
+    SvgMatrix m_fromDevice;
+    SvgMatrix m_frame;
+    // Radial: the focal point less the centre, and 1 - its length squared,
+    // above 0 as the focal point is kept inside the circle.
+    float m_dx = 0.0f, m_dy = 0.0f;
+    float m_a = 1.0f;
+    const SvgGradientLut *m_lut = nullptr;
+};
+
+#endif
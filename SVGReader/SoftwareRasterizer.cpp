@@ -0,0 +1,270 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+void SoftwareRasterizer::SetClip(int width, int height)
+{
+    m_width = (std::max)(width, 0);
+    m_height = (std::max)(height, 0);
+    m_rowTop = 0;
+    m_rowBottom = m_height;
+    // Fill leaves every cell it touched at zero again, so this is the only
+    // time the band is cleared.
+    m_cells.assign(static_cast<size_t>(kBand) * (m_width + 2), 0.0f);
+    m_coverage.resize(m_width);
+}
+
+void SoftwareRasterizer::SetRows(int top, int bottom)
+{
+    m_rowTop = std::clamp(top, 0, m_height);
+    m_rowBottom = std::clamp(bottom, m_rowTop, m_height);
+}
+
+void SoftwareRasterizer::Reset()
+{
+    m_edges.clear();
+    m_open = false;
+}
+
+void SoftwareRasterizer::MoveTo(float x, float y)
+{
+    CloseFigure();
+    m_startX = m_lastX = x;
+    m_startY = m_lastY = y;
+    m_open = true;
+}
+
+void SoftwareRasterizer::LineTo(float x, float y)
+{
+    AddEdge(m_lastX, m_lastY, x, y);
+    m_lastX = x;
+    m_lastY = y;
+}
+
+void SoftwareRasterizer::CloseFigure()
+{
+    if (m_open)
+        AddEdge(m_lastX, m_lastY, m_startX, m_startY);
+    m_open = false;
+}
+
+void SoftwareRasterizer::AddEdge(float x0, float y0, float x1, float y1)
+{
+    if (y0 == y1 || !std::isfinite(x0) || !std::isfinite(y0) || !std::isfinite(x1) || !std::isfinite(y1))
+        return;
+    float dir = 1.0f;
+    if (y0 > y1)
+    {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        dir = -1.0f;
+    }
+
+    // Rows above and below the clip are never filled, so what lies there
+    // can go.
+    const float height = static_cast<float>(m_height);
+    if (y1 <= 0.0f || y0 >= height)
+        return;
+    if (y0 < 0.0f)
+    {
+        x0 += (x1 - x0) * (0.0f - y0) / (y1 - y0);
+        y0 = 0.0f;
+    }
+    if (y1 > height)
+    {
+        x1 = x0 + (x1 - x0) * (height - y0) / (y1 - y0);
+        y1 = height;
+    }
+    // Edges outside the rows go too, but one reaching into them is kept
+    // whole: cutting it would move where it crosses each row.
+    if (y1 <= static_cast<float>(m_rowTop) || y0 >= static_cast<float>(m_rowBottom))
+        return;
+
+    // Across, an edge covers everything to its right. Left of the clip it
+    // is flattened onto the left border, where it still covers the whole
+    // row; right of it, onto the right border, where it covers no pixel
+    // but still ends the row's run. Pieces are cut where it crosses a
+    // border; a t of 1 stands for no crossing and leaves an empty piece.
+    const float width = static_cast<float>(m_width);
+    auto crossing = [&](float border)
+    { return (x0 < border) != (x1 < border) && x0 != x1 ? (border - x0) / (x1 - x0) : 1.0f; };
+    float first = crossing(0.0f), second = crossing(width);
+    if (second < first)
+        std::swap(first, second);
+    const float cuts[4] = {0.0f, first, second, 1.0f};
+    for (int i = 0; i < 3; ++i)
+    {
+        const float t0 = cuts[i], t1 = cuts[i + 1];
+        if (t1 <= t0)
+            continue;
+        const float ax = std::clamp(x0 + (x1 - x0) * t0, 0.0f, width);
+        const float bx = std::clamp(x0 + (x1 - x0) * t1, 0.0f, width);
+        PushEdge(ax, y0 + (y1 - y0) * t0, bx, y0 + (y1 - y0) * t1, dir);
+    }
+}
+
+void SoftwareRasterizer::PushEdge(float x0, float y0, float x1, float y1, float dir)
+{
+    if (y0 < y1)
+        m_edges.push_back({x0, y0, x1, y1, dir});
+}
+
+void SoftwareRasterizer::Accumulate(const Edge &edge, int top)
+{
+    const float y0 = (std::max)(edge.y0, static_cast<float>(top));
+    const float y1 = (std::min)(edge.y1, static_cast<float>(top + kBand));
+    if (y0 >= y1)
+        return;
+
+    const float width = static_cast<float>(m_width);
+    const int stride = m_width + 2;
+    const float dxdy = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+    float x = edge.x0 + (y0 - edge.y0) * dxdy;
+    for (int row = static_cast<int>(y0); static_cast<float>(row) < y1; ++row)
+    {
+        float *cells = &m_cells[static_cast<size_t>(row - top) * stride];
+        const float dy = (std::min)(static_cast<float>(row + 1), y1) - (std::max)(static_cast<float>(row), y0);
+        const float next = x + dxdy * dy;
+        const float d = dy * edge.dir;
+
+        // The part of the edge in this row spans [xa, xb]; the cell it
+        // starts in gets the area left of it, the cells it crosses a share
+        // each, and the cell after it the rest of d.
+        const float xa = std::clamp((std::min)(x, next), 0.0f, width);
+        const float xb = std::clamp((std::max)(x, next), 0.0f, width);
+        const float xaFloor = std::floor(xa);
+        const int ia = static_cast<int>(xaFloor);
+        const float xbCeil = std::ceil(xb);
+        const int ib = static_cast<int>(xbCeil);
+        if (ib <= ia + 1)
+        {
+            const float xm = 0.5f * (xa + xb) - xaFloor;
+            cells[ia] += d - d * xm;
+            cells[ia + 1] += d * xm;
+            m_touchedMax = (std::max)(m_touchedMax, ia + 1);
+        }
+        else
+        {
+            const float s = 1.0f / (xb - xa);
+            const float xaFrac = xa - xaFloor;
+            const float a0 = 0.5f * s * (1.0f - xaFrac) * (1.0f - xaFrac);
+            const float xbFrac = xb - xbCeil + 1.0f;
+            const float am = 0.5f * s * xbFrac * xbFrac;
+            cells[ia] += d * a0;
+            if (ib == ia + 2)
+            {
+                cells[ia + 1] += d * (1.0f - a0 - am);
+            }
+            else
+            {
+                const float a1 = s * (1.5f - xaFrac);
+                cells[ia + 1] += d * (a1 - a0);
+                for (int i = ia + 2; i < ib - 1; ++i)
+                    cells[i] += d * s;
+                const float a2 = a1 + static_cast<float>(ib - ia - 3) * s;
+                cells[ib - 1] += d * (1.0f - a2 - am);
+            }
+            cells[ib] += d * am;
+            m_touchedMax = (std::max)(m_touchedMax, ib);
+        }
+        m_touchedMin = (std::min)(m_touchedMin, ia);
+        x = next;
+    }
+}
+
+void SoftwareRasterizer::Fill(FillRule rule, const SpanSink &sink)
+{
+    CloseFigure();
+    if (m_edges.empty() || m_width == 0)
+        return;
+    // Edges are summed into the cells in this order, and float sums depend
+    // on it; ordering on everything keeps it the same whichever edges the
+    // rows left out, where y0 alone would let the sort break ties apart.
+    std::sort(m_edges.begin(), m_edges.end(), [](const Edge &a, const Edge &b)
+              { return std::tie(a.y0, a.x0, a.y1, a.x1, a.dir) < std::tie(b.y0, b.x0, b.y1, b.x1, b.dir); });
+    float bottomY = 0.0f;
+    for (const Edge &edge : m_edges)
+        bottomY = (std::max)(bottomY, edge.y1);
+
+    bottomY = (std::min)(bottomY, static_cast<float>(m_rowBottom));
+
+    // Edges are taken in as the bands reach them and dropped once passed,
+    // so each band only looks at the edges crossing it. Bands start on
+    // multiples of kBand whatever the rows, which keeps the x each edge
+    // has on a row the same however the image is cut up.
+    std::vector<const Edge *> active;
+    size_t next = 0;
+    const int stride = m_width + 2;
+    const int firstRow = (std::max)(static_cast<int>(m_edges.front().y0), m_rowTop);
+    for (int top = firstRow - firstRow % kBand; static_cast<float>(top) < bottomY; top += kBand)
+    {
+        const float bandBottom = static_cast<float>(top + kBand);
+        for (; next < m_edges.size() && m_edges[next].y0 < bandBottom; ++next)
+            active.push_back(&m_edges[next]);
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](const Edge *edge) { return edge->y1 <= static_cast<float>(top); }),
+                     active.end());
+        if (active.empty())
+            continue;
+
+        m_touchedMin = stride;
+        m_touchedMax = -1;
+        for (const Edge *edge : active)
+            Accumulate(*edge, top);
+        if (m_touchedMax < 0)
+            continue;
+
+        // Edges stop at the clip, so rows below it hold nothing. Rows of the
+        // band outside the clip's are only cleared.
+        const int rows = (std::min)(kBand, m_height - top);
+        for (int r = 0; r < rows; ++r)
+        {
+            float *cells = &m_cells[static_cast<size_t>(r) * stride];
+            if (top + r < m_rowTop || top + r >= m_rowBottom)
+            {
+                std::fill(cells + m_touchedMin, cells + m_touchedMax + 1, 0.0f);
+                continue;
+            }
+            float sum = 0.0f;
+            int runStart = -1;
+            for (int x = m_touchedMin; x <= m_touchedMax; ++x)
+            {
+                sum += cells[x];
+                cells[x] = 0.0f;
+                if (x >= m_width)
+                    continue;
+
+                float covered = std::fabs(sum);
+                if (rule == FillRule::EvenOdd)
+                {
+                    // Winding 1 is in, 2 out, 3 in again...
+                    covered = std::fmod(covered, 2.0f);
+                    if (covered > 1.0f)
+                        covered = 2.0f - covered;
+                }
+                else if (covered > 1.0f)
+                {
+                    covered = 1.0f;
+                }
+                const auto alpha = static_cast<uint8_t>(covered * 255.0f + 0.5f);
+                if (alpha)
+                {
+                    if (runStart < 0)
+                        runStart = x;
+                    m_coverage[x] = alpha;
+                }
+                else if (runStart >= 0)
+                {
+                    sink(top + r, runStart, x - runStart, &m_coverage[runStart]);
+                    runStart = -1;
+                }
+            }
+            if (runStart >= 0)
+            {
+                const int end = (std::min)(m_touchedMax + 1, m_width);
+                sink(top + r, runStart, end - runStart, &m_coverage[runStart]);
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef _SOFTWARERASTERIZER_H_
+#define _SOFTWARERASTERIZER_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Turns polygons in device space into anti-aliased coverage, one run of
+// pixels at a time. Coverage is exact: each pixel gets the fraction of its
+// square the polygon covers, found by accumulating the signed area each
+// edge leaves in the cells it crosses and summing those along the row. No
+// supersampling, and the cost follows the edges and the pixels touched.
+//
+// Describe the outline with MoveTo/LineTo (every figure is closed back to
+// its start), then Fill. Reset clears it for the next shape and keeps the
+// storage. Uses no platform headers.
+class SoftwareRasterizer
+{
+public:
+    enum class FillRule : uint8_t
+    {
+        NonZero,
+        EvenOdd
+    };
+
+    // Receives coverage for pixels [x, x + count) of row y, 0 to 255 each.
+    using SpanSink = std::function<void(int y, int x, int count, const uint8_t *coverage)>;
+
+    // Pixels outside [0, width) x [0, height) get no coverage. Resets the
+    // rows to all of them.
+    void SetClip(int width, int height);
+    // Narrows the clip to rows [top, bottom). The rows inside get exactly
+    // the coverage they get with the whole clip, so pieces of one image
+    // can be rasterized apart (and at once) and come out the same.
+    void SetRows(int top, int bottom);
+
+    void Reset();
+    void MoveTo(float x, float y);
+    void LineTo(float x, float y);
+
+    // Hands every run of covered pixels to sink, top to bottom and left to
+    // right within a row.
+    void Fill(FillRule rule, const SpanSink &sink);
+
+private:
+    // Kept with y0 < y1; dir says which way the outline ran.
+    struct Edge
+    {
+        float x0, y0, x1, y1;
+        float dir;
+    };
+
+    void CloseFigure();
+    void AddEdge(float x0, float y0, float x1, float y1);
+    void PushEdge(float x0, float y0, float x1, float y1, float dir);
+    // Adds the part of edge between rows top and top + kBand to m_cells.
+    void Accumulate(const Edge &edge, int top);
+
+    static constexpr int kBand = 16;
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_rowTop = 0, m_rowBottom = 0;
+    std::vector<Edge> m_edges;
+    float m_startX = 0.0f, m_startY = 0.0f;
+    float m_lastX = 0.0f, m_lastY = 0.0f;
+    bool m_open = false;
+
+    // One band of rows, m_width + 2 cells each; the two spare cells take
+    // what edges on the right border leave past it.
+    std::vector<float> m_cells;
+    std::vector<uint8_t> m_coverage;
+    int m_touchedMin = 0, m_touchedMax = -1;
+};
+
+#endif
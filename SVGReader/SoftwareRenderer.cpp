@@ -0,0 +1,259 @@
+#include "SoftwareRenderer.h"
+#include "SoftwareBlend.h"
+#include "SoftwareFont.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // SVG's default stroke-miterlimit, in half widths as Stroke takes it.
+    constexpr float kMiterLimit = 4.0f;
+
+    uint32_t Premultiplied(Gdiplus::Color c)
+    {
+        return SoftwareBlend::Premultiply(c.GetR(), c.GetG(), c.GetB(), c.GetAlpha());
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(SoftwarePixmap &target, const SvgMatrix &view)
+    : m_target(target), m_matrix(view)
+{
+    m_rasterizer.SetClip(target.width, target.height);
+    m_shaded.resize(target.width);
+}
+
+const SvgStyle &SoftwareRenderer::StyleOf(const ISvgElement &element)
+{
+    if (m_resolved)
+        return *m_resolvedStyle;
+    static const SvgStyle unstyled;
+    const SvgStyle &own = m_styles ? (*m_styles)[element.style] : unstyled;
+    if (m_instances.empty())
+        return own;
+    m_instanceStyle = own;
+    InheritPaint(m_instanceStyle, m_instances.back());
+    return m_instanceStyle;
+}
+
+SvgMatrix SoftwareRenderer::ToDevice(const ISvgElement &element) const
+{
+    return m_resolved ? m_resolvedToDevice : m_matrix * element.transform;
+}
+
+float SoftwareRenderer::Tolerance(const SvgMatrix &toDevice) const
+{
+    // A fifth of a pixel is closer than anti-aliasing can show.
+    const float scale = (std::max)(std::hypot(toDevice.a, toDevice.b), std::hypot(toDevice.c, toDevice.d));
+    return scale > 0.0f && std::isfinite(scale) ? 0.2f / scale : 0.2f;
+}
+
+SoftwarePaint SoftwareRenderer::FillPaint(const SvgStyle &style, const ISvgElement &element,
+                                          const SvgMatrix &toDevice) const
+{
+    if (m_resolved)
+    {
+        if (m_resolvedFill)
+            return SoftwarePaint::FromGradient(*m_resolvedFill, element.fillBox, toDevice, style.fillOpacity);
+    }
+    else if (style.fillUrl != 0 && m_styles && m_gradients)
+    {
+        auto it = m_gradients->find(std::string(m_styles->GetString(style.fillUrl)));
+        if (it != m_gradients->end() && it->second)
+            return SoftwarePaint::FromGradient(*it->second, element.fillBox, toDevice, style.fillOpacity);
+    }
+    return SoftwarePaint(Premultiplied(style.fillColor));
+}
+
+void SoftwareRenderer::Fill(const SoftwareOutline &outline, const SvgMatrix &toDevice,
+                            SoftwareRasterizer::FillRule rule, const SoftwarePaint &paint)
+{
+    if (paint.IsClear() || outline.Empty())
+        return;
+    m_rasterizer.Reset();
+    const auto &points = outline.Points();
+    const SvgMatrix &m = toDevice;
+    for (const SoftwareOutline::Figure &figure : outline.Figures())
+    {
+        for (uint32_t i = figure.begin; i < figure.end; ++i)
+        {
+            const float x = m.a * points[i].x + m.c * points[i].y + m.e;
+            const float y = m.b * points[i].x + m.d * points[i].y + m.f;
+            if (i == figure.begin)
+                m_rasterizer.MoveTo(x, y);
+            else
+                m_rasterizer.LineTo(x, y);
+        }
+    }
+
+    if (paint.IsSolid())
+    {
+        const uint32_t color = paint.GetColor();
+        m_rasterizer.Fill(rule, [&](int y, int x, int count, const uint8_t *coverage)
+                          { SoftwareBlend::SolidSpan(m_target.Row(y) + x, count, color, coverage); });
+        return;
+    }
+    m_rasterizer.Fill(rule, [&](int y, int x, int count, const uint8_t *coverage)
+                      {
+                          paint.Shade(x, y, count, m_shaded.data());
+                          SoftwareBlend::Span(m_target.Row(y) + x, count, m_shaded.data(), coverage);
+                      });
+}
+
+void SoftwareRenderer::Paint(const ISvgElement &element, bool fill, SoftwareOutline::Join join,
+                             SoftwareOutline::Cap cap)
+{
+    const SvgStyle &style = StyleOf(element);
+    const SvgMatrix toDevice = ToDevice(element);
+    if (fill)
+    {
+        const auto rule = style.evenOddFill ? SoftwareRasterizer::FillRule::EvenOdd
+                                            : SoftwareRasterizer::FillRule::NonZero;
+        Fill(m_outline, toDevice, rule, FillPaint(style, element, toDevice));
+    }
+    if (style.strokeColor.GetAlpha() > 0 && style.strokeWidth > 0.0f)
+    {
+        m_stroke.Clear();
+        m_outline.Stroke(m_stroke, style.strokeWidth, join, cap, kMiterLimit, Tolerance(toDevice));
+        Fill(m_stroke, toDevice, SoftwareRasterizer::FillRule::NonZero, SoftwarePaint(Premultiplied(style.strokeColor)));
+    }
+}
+
+void SoftwareRenderer::DrawLine(const SvgLine &line)
+{
+    const float xy[4] = {line.x1, line.y1, line.x2, line.y2};
+    m_outline.Clear();
+    m_outline.AddPolyline(xy, 2, false);
+    Paint(line, false, SoftwareOutline::Join::Miter, SoftwareOutline::Cap::Butt);
+}
+
+void SoftwareRenderer::DrawRect(const SvgRect &rect)
+{
+    m_outline.Clear();
+    m_outline.AddRect(rect.x, rect.y, rect.w, rect.h);
+    Paint(rect, true, SoftwareOutline::Join::Miter, SoftwareOutline::Cap::Butt);
+}
+
+void SoftwareRenderer::DrawCircle(const SvgCircle &circle)
+{
+    m_outline.Clear();
+    m_outline.AddEllipse(circle.cx, circle.cy, circle.r, circle.r, Tolerance(ToDevice(circle)));
+    Paint(circle, true, SoftwareOutline::Join::Round, SoftwareOutline::Cap::Butt);
+}
+
+void SoftwareRenderer::DrawEllipse(const SvgEllipse &ellipse)
+{
+    m_outline.Clear();
+    m_outline.AddEllipse(ellipse.cx, ellipse.cy, ellipse.rx, ellipse.ry, Tolerance(ToDevice(ellipse)));
+    Paint(ellipse, true, SoftwareOutline::Join::Round, SoftwareOutline::Cap::Butt);
+}
+
+void SoftwareRenderer::DrawPolyline(const SvgPolyline &polyline)
+{
+    if (polyline.points.size() < 2)
+        return;
+    m_outline.Clear();
+    // PointF is an x, y pair of floats.
+    m_outline.AddPolyline(reinterpret_cast<const float *>(polyline.points.data()), polyline.points.size(), false);
+    Paint(polyline, true, SoftwareOutline::Join::Miter, SoftwareOutline::Cap::Butt);
+}
+
+void SoftwareRenderer::DrawPolygon(const SvgPolygon &polygon)
+{
+    if (polygon.points.size() < 3)
+        return;
+    m_outline.Clear();
+    m_outline.AddPolyline(reinterpret_cast<const float *>(polygon.points.data()), polygon.points.size(), true);
+    Paint(polygon, true, SoftwareOutline::Join::Miter, SoftwareOutline::Cap::Butt);
+}
+
+void SoftwareRenderer::DrawText(const SvgText &text)
+{
+    const SvgStyle &style = StyleOf(text);
+    const SvgMatrix toDevice = ToDevice(text);
+    const float tolerance = Tolerance(toDevice);
+    const float weight = SoftwareFont::Weight(style.fontSize);
+    m_outline.Clear();
+    SoftwareFont::AddText(m_outline, text.text, text.x, text.y, style.fontSize, style.textAnchor);
+
+    // The glyphs are pen strokes, so a stroke on their outline is a wider
+    // pen under a narrower one: the stroke reaches half its width beyond
+    // the glyph, and the fill shows where it does not reach inside.
+    float fillWeight = weight;
+    if (style.strokeColor.GetAlpha() > 0 && style.strokeWidth > 0.0f)
+    {
+        m_stroke.Clear();
+        m_outline.Stroke(m_stroke, weight + style.strokeWidth, SoftwareOutline::Join::Round,
+                         SoftwareOutline::Cap::Round, kMiterLimit, tolerance);
+        Fill(m_stroke, toDevice, SoftwareRasterizer::FillRule::NonZero, SoftwarePaint(Premultiplied(style.strokeColor)));
+        fillWeight -= style.strokeWidth;
+    }
+    if (fillWeight > 0.0f)
+    {
+        m_stroke.Clear();
+        m_outline.Stroke(m_stroke, fillWeight, SoftwareOutline::Join::Round, SoftwareOutline::Cap::Round,
+                         kMiterLimit, tolerance);
+        Fill(m_stroke, toDevice, SoftwareRasterizer::FillRule::NonZero, FillPaint(style, text, toDevice));
+    }
+}
+
+void SoftwareRenderer::DrawPath(const SvgPath &path)
+{
+    m_outline.Clear();
+    m_outline.AddPath(path.pathData, Tolerance(ToDevice(path)));
+    Paint(path, true, SoftwareOutline::Join::Round, SoftwareOutline::Cap::Round);
+}
+
+void SoftwareRenderer::DrawGroup(const SvgGroup &group)
+{
+    const SvgMatrix saved = m_matrix;
+    m_matrix = m_matrix * group.transform;
+    for (const ISvgElement *child : group.children)
+        child->Draw(*this);
+    m_matrix = saved;
+}
+
+void SoftwareRenderer::DrawUse(const SvgUse &use)
+{
+    if (!use.target)
+        return;
+    const SvgMatrix saved = m_matrix;
+    m_matrix = m_matrix * use.transform;
+    const SvgStyle &handed = m_styles ? (*m_styles)[use.style] : SvgStyle();
+    const SvgInheritedStyle outer = m_instances.empty() ? SvgInheritedStyle() : m_instances.back();
+    m_instances.push_back(PassPaint(handed, outer));
+    use.target->Draw(*this);
+    m_instances.pop_back();
+    m_matrix = saved;
+}
+
+void SoftwareRenderer::PushTransform(const SvgMatrix &transform)
+{
+    m_pushed.push_back(m_matrix);
+    m_matrix = m_matrix * transform;
+}
+
+void SoftwareRenderer::PopTransform()
+{
+    m_matrix = m_pushed.back();
+    m_pushed.pop_back();
+}
+
+const SvgMatrix &SoftwareRenderer::BeginResolved()
+{
+    m_resolved = true;
+    return m_matrix;
+}
+
+void SoftwareRenderer::SetResolved(const SvgMatrix &toDevice, const SvgStyle &style, const SvgGradient *fill)
+{
+    m_resolvedToDevice = toDevice;
+    m_resolvedStyle = &style;
+    m_resolvedFill = fill;
+}
+
+void SoftwareRenderer::EndResolved()
+{
+    m_resolved = false;
+    m_resolvedStyle = nullptr;
+    m_resolvedFill = nullptr;
+}
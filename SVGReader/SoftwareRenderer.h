@@ -0,0 +1,124 @@
+#ifndef _SOFTWARERENDERER_H_
+#define _SOFTWARERENDERER_H_
+
+#include "IRenderer.h"
+#include "SoftwareOutline.h"
+#include "SoftwarePaint.h"
+#include "SoftwareRasterizer.h"
+#include "SvgElement.h"
+#include "SvgStyle.h"
+#include "SvgTransform.h"
+#include <cstdint>
+#include <vector>
+
+// Pixels the software renderer draws into: premultiplied RGBA, eight bits
+// per channel, R in the lowest byte of each value (R, G, B, A in memory on
+// little-endian machines). Rows of width pixels, top row first.
+struct SoftwarePixmap
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+
+    SoftwarePixmap() = default;
+    SoftwarePixmap(int w, int h, uint32_t fill = 0)
+        : width(w), height(h), pixels(static_cast<size_t>(w) * h, fill)
+    {
+    }
+
+    uint32_t *Row(int y) { return pixels.data() + static_cast<size_t>(y) * width; }
+    const uint32_t *Row(int y) const { return pixels.data() + static_cast<size_t>(y) * width; }
+};
+
+// An IRenderer that rasterizes on the CPU into a SoftwarePixmap, with no
+// platform graphics library: the counterpart of GdiPlusRenderer for
+// headless use. Shapes are flattened and stroked in their own space
+// (SoftwareOutline), filled with exact-area anti-aliasing by
+// SoftwareRasterizer under the fill rule their style names, and composited
+// source-over (SoftwareBlend).
+//
+// Strokes follow GdiPlusRenderer: miter joins and butt caps, except round
+// joins and caps on paths. Text is drawn in SoftwareFont, a built-in stroke
+// font, rather than the family the style names, so it keeps its place and
+// size but not the look of the font GdiPlusRenderer would pick.
+class SoftwareRenderer : public IRenderer
+{
+public:
+    // view maps document space to pixels, as a viewer's zoom and pan do.
+    explicit SoftwareRenderer(SoftwarePixmap &target, const SvgMatrix &view = SvgMatrix());
+
+    // Draws only into rows [top, bottom) of the target, and into each of
+    // them what drawing everything would; see SoftwareRasterizer::SetRows.
+    void SetRows(int top, int bottom) { m_rasterizer.SetRows(top, bottom); }
+
+    void SetGradients(const std::unordered_map<std::string, std::shared_ptr<SvgGradient>> &gradients) override
+    {
+        m_gradients = &gradients;
+    }
+
+    void SetStyles(const SvgStyleTable &styles) override
+    {
+        m_styles = &styles;
+    }
+
+    void DrawLine(const SvgLine &line) override;
+    void DrawRect(const SvgRect &rect) override;
+    void DrawCircle(const SvgCircle &circle) override;
+    void DrawEllipse(const SvgEllipse &ellipse) override;
+    void DrawPolyline(const SvgPolyline &polyline) override;
+    void DrawPolygon(const SvgPolygon &polygon) override;
+    void DrawText(const SvgText &text) override;
+    void DrawPath(const SvgPath &path) override;
+    void DrawGroup(const SvgGroup &group) override;
+    void DrawUse(const SvgUse &use) override;
+    void PushTransform(const SvgMatrix &transform) override;
+    void PopTransform() override;
+    const SvgMatrix &BeginResolved() override;
+    void SetResolved(const SvgMatrix &toDevice, const SvgStyle &style, const SvgGradient *fill) override;
+    void EndResolved() override;
+
+private:
+    // The element's record, completed by the innermost use being drawn;
+    // as GdiPlusRenderer::StyleOf.
+    const SvgStyle &StyleOf(const ISvgElement &element);
+    // From element's space to pixels.
+    SvgMatrix ToDevice(const ISvgElement &element) const;
+    // Device pixels per unit of the element's space, at most; sets how
+    // finely curves are flattened.
+    float Tolerance(const SvgMatrix &toDevice) const;
+    // The style's fill for element: its gradient if it names one that
+    // exists, its colour otherwise.
+    SoftwarePaint FillPaint(const SvgStyle &style, const ISvgElement &element, const SvgMatrix &toDevice) const;
+
+    // Fills and strokes m_outline, which is in element's space.
+    void Paint(const ISvgElement &element, bool fill, SoftwareOutline::Join join, SoftwareOutline::Cap cap);
+    // Rasterizes outline through toDevice and composites paint where it
+    // covers.
+    void Fill(const SoftwareOutline &outline, const SvgMatrix &toDevice, SoftwareRasterizer::FillRule rule,
+              const SoftwarePaint &paint);
+
+    SoftwarePixmap &m_target;
+    // Element space of the group being drawn to pixels.
+    SvgMatrix m_matrix;
+    std::vector<SvgMatrix> m_pushed;
+
+    // Borrowed from the document drawn, as in GdiPlusRenderer.
+    const std::unordered_map<std::string, std::shared_ptr<SvgGradient>> *m_gradients = nullptr;
+    const SvgStyleTable *m_styles = nullptr;
+    std::vector<SvgInheritedStyle> m_instances;
+    SvgStyle m_instanceStyle;
+
+    // Between BeginResolved and EndResolved: what SetResolved gave.
+    bool m_resolved = false;
+    SvgMatrix m_resolvedToDevice;
+    const SvgStyle *m_resolvedStyle = nullptr;
+    const SvgGradient *m_resolvedFill = nullptr;
+
+    // Scratch kept between draws so they do not allocate.
+    SoftwareRasterizer m_rasterizer;
+    SoftwareOutline m_outline;
+    SoftwareOutline m_stroke;
+    std::vector<uint32_t> m_shaded;
+};
+
+#endif
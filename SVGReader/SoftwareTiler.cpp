@@ -0,0 +1,135 @@
+#include "SoftwareTiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // A thread's share of the tiles: positions [begin, end) of the list of
+    // tiles with something to draw. The owner takes from the front and
+    // others from the back, so a thief takes what the owner would reach
+    // last.
+    struct Run
+    {
+        std::mutex mutex;
+        size_t begin = 0, end = 0;
+    };
+
+    constexpr size_t kNoTile = static_cast<size_t>(-1);
+
+    size_t Take(std::vector<Run> &runs, size_t worker)
+    {
+        {
+            Run &own = runs[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.begin < own.end)
+                return own.begin++;
+        }
+        for (size_t k = 1; k < runs.size(); ++k)
+        {
+            Run &victim = runs[(worker + k) % runs.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin < victim.end)
+                return --victim.end;
+        }
+        return kNoTile;
+    }
+}
+
+void SoftwareTiler::Render(const SvgScene &scene, SoftwarePixmap &target, const SvgMatrix &view) const
+{
+    if (target.width <= 0 || target.height <= 0)
+        return;
+    const int tileCount = (target.height + kTileRows - 1) / kTileRows;
+
+    // Bins, each the leaf items reaching its rows in draw order. A pixel
+    // picks up coverage from anything inside it, and a pixel more each way
+    // leaves room for rounding. Items without a finite box go everywhere,
+    // as they would be drawn with no culling.
+    std::vector<std::vector<uint32_t>> bins(tileCount);
+    const uint32_t count = static_cast<uint32_t>(scene.Size());
+    for (uint32_t item = scene.GetFirstDrawn(); item < count; ++item)
+    {
+        if (scene.GetKind(item) == SvgScene::Kind::Group)
+            continue;
+        const SvgBounds box = scene.GetBounds(item).Transformed(view);
+        int first = 0, last = tileCount - 1;
+        if (!box.Empty() && box.Finite())
+        {
+            const float top = std::floor(box.minY) - 1.0f;
+            const float bottom = std::ceil(box.maxY) + 1.0f;
+            if (bottom < 0.0f || top >= static_cast<float>(target.height))
+                continue;
+            first = static_cast<int>((std::max)(top, 0.0f)) / kTileRows;
+            last = static_cast<int>((std::min)(bottom, static_cast<float>(target.height - 1))) / kTileRows;
+        }
+        for (int tile = first; tile <= last; ++tile)
+            bins[tile].push_back(item);
+    }
+
+    std::vector<int> tiles;
+    for (int tile = 0; tile < tileCount; ++tile)
+    {
+        if (!bins[tile].empty())
+            tiles.push_back(tile);
+    }
+    if (tiles.empty())
+        return;
+
+    const unsigned threads = m_maxThreads ? m_maxThreads : (std::max)(std::thread::hardware_concurrency(), 1u);
+    const size_t workerCount = (std::min)(static_cast<size_t>(threads), tiles.size());
+    std::vector<Run> runs(workerCount);
+    for (size_t w = 0; w < workerCount; ++w)
+    {
+        runs[w].begin = tiles.size() * w / workerCount;
+        runs[w].end = tiles.size() * (w + 1) / workerCount;
+    }
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto work = [&](size_t worker)
+    {
+        try
+        {
+            SoftwareRenderer renderer(target, view);
+            for (size_t next; !failed && (next = Take(runs, worker)) != kNoTile;)
+            {
+                const int tile = tiles[next];
+                renderer.SetRows(tile * kTileRows, (tile + 1) * kTileRows);
+                scene.Render(renderer, bins[tile]);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+            failed = true;
+        }
+    };
+
+    // A worker that cannot be started leaves its run to be stolen.
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < workerCount; ++w)
+    {
+        try
+        {
+            workers.emplace_back(work, w);
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+    work(0);
+    for (std::thread &worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+}
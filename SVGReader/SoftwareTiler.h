@@ -0,0 +1,36 @@
+#ifndef _SOFTWARETILER_H_
+#define _SOFTWARETILER_H_
+
+#include "SoftwareRenderer.h"
+#include "SvgScene.h"
+#include "SvgTransform.h"
+#include <vector>
+
+// Renders a scene into a SoftwarePixmap on several threads. The pixmap is
+// cut into tiles of kTileRows rows; each drawn item is binned into the
+// tiles its bounds reach under the view, and each tile replays only its
+// items, in draw order, through a SoftwareRenderer of its own that writes
+// no other rows. Tiles are dealt out to the threads in runs, and a thread
+// whose run is done takes tiles from the far end of another's.
+//
+// The pixels are those SoftwareRenderer gives drawing the whole scene on
+// one thread. Tiles run the full width because the rasterizer sums
+// coverage along each row from its left end; cutting rows across would
+// change the rounding.
+class SoftwareTiler
+{
+public:
+    static constexpr int kTileRows = 64;
+
+    // Caps the threads Render uses: 0 (the default) means one per core, 1
+    // keeps everything on the calling thread.
+    void SetMaxThreads(unsigned count) { m_maxThreads = count; }
+
+    // view maps document space to pixels, as for SoftwareRenderer.
+    void Render(const SvgScene &scene, SoftwarePixmap &target, const SvgMatrix &view = SvgMatrix()) const;
+
+private:
+    unsigned m_maxThreads = 0;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _SVGARENA_H_
+#define _SVGARENA_H_
+
+#include <memory_resource>
+#include <utility>
+
+// Bump allocator behind a document's elements. Elements are created here
+// along with everything they own (child lists, point arrays, path data,
+// strings), and none of it is ever freed piece by piece: destroying the
+// arena releases all of it in a few large blocks, without running the
+// elements' destructors. Whatever is created here must therefore keep its
+// memory in the arena too, through the allocator it is constructed with.
+//
+// Not thread-safe; each thread that builds elements uses an arena of its
+// own.
+class SvgArena
+{
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    SvgArena() = default;
+    SvgArena(const SvgArena &) = delete;
+    SvgArena &operator=(const SvgArena &) = delete;
+
+    allocator_type Allocator() { return allocator_type(&m_buffer); }
+
+    // Bytes handed out so far, not counting what the blocks hold in
+    // reserve. A child list that grew counts every buffer it had, as the
+    // arena gets none of them back.
+    size_t BytesUsed() const { return m_buffer.used; }
+
+    // Constructs a T in the arena and hands it the arena's allocator.
+    template <typename T, typename... Args>
+    T *Create(Args &&...args)
+    {
+        return Allocator().template new_object<T>(std::forward<Args>(args)...);
+    }
+
+private:
+    // Size of the first block; later ones grow geometrically.
+    static constexpr size_t kInitialBlock = 16 * 1024;
+
+    // The bump allocator, adding up what it is asked for.
+    class CountingBuffer : public std::pmr::memory_resource
+    {
+    public:
+        size_t used = 0;
+
+    private:
+        std::pmr::monotonic_buffer_resource m_blocks{kInitialBlock};
+
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            used += bytes;
+            return m_blocks.allocate(bytes, alignment);
+        }
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    CountingBuffer m_buffer;
+};
+
+#endif
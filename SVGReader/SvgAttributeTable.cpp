@@ -0,0 +1,50 @@
+#include "stdafx.h"
+#include "SvgAttributeTable.h"
+
+namespace
+{
+    std::string_view Trim(std::string_view s)
+    {
+        const char *ws = " \t\r\n";
+        size_t first = s.find_first_not_of(ws);
+        if (first == std::string_view::npos)
+            return s.substr(s.size());
+        return s.substr(first, s.find_last_not_of(ws) - first + 1);
+    }
+}
+
+SvgAttributeTable::SvgAttributeTable(const IXMLNode &node)
+{
+    node.forEachAttribute([&](std::string_view name, std::string_view value)
+    {
+        SvgAttr attr = LookupSvgAttr(name);
+        if (attr == SvgAttr::Count)
+            return;
+        // Keep the first occurrence, same as getAttribute() would. A default
+        // view has no data, an empty attribute value still does.
+        std::string_view &slot = m_values[static_cast<size_t>(attr)];
+        if (slot.data() == nullptr)
+            slot = value.data() ? value : std::string_view("");
+    });
+}
+
+void SvgAttributeTable::ApplyStyle()
+{
+    std::string_view style = Get(SvgAttr::Style);
+    while (!style.empty())
+    {
+        size_t end = style.find(';');
+        std::string_view item = style.substr(0, end);
+        style.remove_prefix(end == std::string_view::npos ? style.size() : end + 1);
+
+        size_t colon = item.find(':');
+        if (colon == std::string_view::npos)
+            continue;
+        std::string_view key = Trim(item.substr(0, colon));
+        std::string_view val = Trim(item.substr(colon + 1));
+
+        SvgAttr attr = LookupSvgAttr(key);
+        if (attr != SvgAttr::Count && attr != SvgAttr::Style)
+            m_values[static_cast<size_t>(attr)] = val;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef _SVGATTRIBUTETABLE_H_
+#define _SVGATTRIBUTETABLE_H_
+
+#include "IXMLNode.h"
+#include "SvgNames.h"
+
+#include <array>
+#include <string_view>
+
+// Attributes of a single element, gathered in one pass over the node and
+// indexed by SvgAttr. Attributes the parser does not know are dropped.
+// Views point into the node's attribute values, style declarations
+// included, and into the document's style sheet, so the table must not
+// outlive either.
+class SvgAttributeTable
+{
+public:
+    explicit SvgAttributeTable(const IXMLNode &node);
+
+    std::string_view Get(SvgAttr attr) const { return m_values[static_cast<size_t>(attr)]; }
+    bool Has(SvgAttr attr) const { return !Get(attr).empty(); }
+    std::string_view GetOr(SvgAttr attr, std::string_view def) const
+    {
+        std::string_view v = Get(attr);
+        return v.empty() ? def : v;
+    }
+
+    void Set(SvgAttr attr, std::string_view value) { m_values[static_cast<size_t>(attr)] = value; }
+
+    // Overlays the declarations of the style="" attribute on top of the
+    // presentation attributes, so style wins like it does in CSS and a
+    // later declaration beats an earlier one. The declarations are split in
+    // place and written straight into the slots; nothing is allocated.
+    void ApplyStyle();
+
+private:
+    std::array<std::string_view, static_cast<size_t>(SvgAttr::Count)> m_values{};
+};
+
+#endif
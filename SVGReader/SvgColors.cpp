@@ -1,139 +1,373 @@
 #include "stdafx.h"
 #include "SvgColors.h"
+#include "SvgNames.h"
+#include "SvgNumber.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
-std::unordered_map<std::string, Color> SvgColors::s_colorMap;
+namespace
+{
+    // 0xRRGGBB; never a valid entry, so it can mark "not found".
+    constexpr uint32_t kNoColor = 0xFFFFFFFFu;
 
-void SvgColors::LoadColors(const std::string& filePath) {
-    ifstream color_file(filePath, ios::in);
+    inline constexpr auto kNamedColors = SvgNames::MakePerfectHashMap<uint32_t, 12>({
+        {"aliceblue", 0xF0F8FF},
+        {"antiquewhite", 0xFAEBD7},
+        {"aqua", 0x00FFFF},
+        {"aquamarine", 0x7FFFD4},
+        {"azure", 0xF0FFFF},
+        {"beige", 0xF5F5DC},
+        {"bisque", 0xFFE4C4},
+        {"black", 0x000000},
+        {"blanchedalmond", 0xFFEBCD},
+        {"blue", 0x0000FF},
+        {"blueviolet", 0x8A2BE2},
+        {"brown", 0xA52A2A},
+        {"burlywood", 0xDEB887},
+        {"cadetblue", 0x5F9EA0},
+        {"chartreuse", 0x7FFF00},
+        {"chocolate", 0xD2691E},
+        {"coral", 0xFF7F50},
+        {"cornflowerblue", 0x6495ED},
+        {"cornsilk", 0xFFF8DC},
+        {"crimson", 0xDC143C},
+        {"cyan", 0x00FFFF},
+        {"darkblue", 0x00008B},
+        {"darkcyan", 0x008B8B},
+        {"darkgoldenrod", 0xB8860B},
+        {"darkgray", 0xA9A9A9},
+        {"darkgreen", 0x006400},
+        {"darkgrey", 0xA9A9A9},
+        {"darkkhaki", 0xBDB76B},
+        {"darkmagenta", 0x8B008B},
+        {"darkolivegreen", 0x556B2F},
+        {"darkorange", 0xFF8C00},
+        {"darkorchid", 0x9932CC},
+        {"darkred", 0x8B0000},
+        {"darksalmon", 0xE9967A},
+        {"darkseagreen", 0x8FBC8F},
+        {"darkslateblue", 0x483D8B},
+        {"darkslategray", 0x2F4F4F},
+        {"darkslategrey", 0x2F4F4F},
+        {"darkturquoise", 0x00CED1},
+        {"darkviolet", 0x9400D3},
+        {"deeppink", 0xFF1493},
+        {"deepskyblue", 0x00BFFF},
+        {"dimgray", 0x696969},
+        {"dimgrey", 0x696969},
+        {"dodgerblue", 0x1E90FF},
+        {"firebrick", 0xB22222},
+        {"floralwhite", 0xFFFAF0},
+        {"forestgreen", 0x228B22},
+        {"fuchsia", 0xFF00FF},
+        {"gainsboro", 0xDCDCDC},
+        {"ghostwhite", 0xF8F8FF},
+        {"gold", 0xFFD700},
+        {"goldenrod", 0xDAA520},
+        {"gray", 0x808080},
+        {"green", 0x008000},
+        {"greenyellow", 0xADFF2F},
+        {"grey", 0x808080},
+        {"honeydew", 0xF0FFF0},
+        {"hotpink", 0xFF69B4},
+        {"indianred", 0xCD5C5C},
+        {"indigo", 0x4B0082},
+        {"ivory", 0xFFFFF0},
+        {"khaki", 0xF0E68C},
+        {"lavender", 0xE6E6FA},
+        {"lavenderblush", 0xFFF0F5},
+        {"lawngreen", 0x7CFC00},
+        {"lemonchiffon", 0xFFFACD},
+        {"lightblue", 0xADD8E6},
+        {"lightcoral", 0xF08080},
+        {"lightcyan", 0xE0FFFF},
+        {"lightgoldenrodyellow", 0xFAFAD2},
+        {"lightgray", 0xD3D3D3},
+        {"lightgreen", 0x90EE90},
+        {"lightgrey", 0xD3D3D3},
+        {"lightpink", 0xFFB6C1},
+        {"lightsalmon", 0xFFA07A},
+        {"lightseagreen", 0x20B2AA},
+        {"lightskyblue", 0x87CEFA},
+        {"lightslategray", 0x778899},
+        {"lightslategrey", 0x778899},
+        {"lightsteelblue", 0xB0C4DE},
+        {"lightyellow", 0xFFFFE0},
+        {"lime", 0x00FF00},
+        {"limegreen", 0x32CD32},
+        {"linen", 0xFAF0E6},
+        {"magenta", 0xFF00FF},
+        {"maroon", 0x800000},
+        {"mediumaquamarine", 0x66CDAA},
+        {"mediumblue", 0x0000CD},
+        {"mediumorchid", 0xBA55D3},
+        {"mediumpurple", 0x9370DB},
+        {"mediumseagreen", 0x3CB371},
+        {"mediumslateblue", 0x7B68EE},
+        {"mediumspringgreen", 0x00FA9A},
+        {"mediumturquoise", 0x48D1CC},
+        {"mediumvioletred", 0xC71585},
+        {"midnightblue", 0x191970},
+        {"mintcream", 0xF5FFFA},
+        {"mistyrose", 0xFFE4E1},
+        {"moccasin", 0xFFE4B5},
+        {"navajowhite", 0xFFDEAD},
+        {"navy", 0x000080},
+        {"oldlace", 0xFDF5E6},
+        {"olive", 0x808000},
+        {"olivedrab", 0x6B8E23},
+        {"orange", 0xFFA500},
+        {"orangered", 0xFF4500},
+        {"orchid", 0xDA70D6},
+        {"palegoldenrod", 0xEEE8AA},
+        {"palegreen", 0x98FB98},
+        {"paleturquoise", 0xAFEEEE},
+        {"palevioletred", 0xDB7093},
+        {"papayawhip", 0xFFEFD5},
+        {"peachpuff", 0xFFDAB9},
+        {"peru", 0xCD853F},
+        {"pink", 0xFFC0CB},
+        {"plum", 0xDDA0DD},
+        {"powderblue", 0xB0E0E6},
+        {"purple", 0x800080},
+        {"rebeccapurple", 0x663399},
+        {"red", 0xFF0000},
+        {"rosybrown", 0xBC8F8F},
+        {"royalblue", 0x4169E1},
+        {"saddlebrown", 0x8B4513},
+        {"salmon", 0xFA8072},
+        {"sandybrown", 0xF4A460},
+        {"seagreen", 0x2E8B57},
+        {"seashell", 0xFFF5EE},
+        {"sienna", 0xA0522D},
+        {"silver", 0xC0C0C0},
+        {"skyblue", 0x87CEEB},
+        {"slateblue", 0x6A5ACD},
+        {"slategray", 0x708090},
+        {"slategrey", 0x708090},
+        {"snow", 0xFFFAFA},
+        {"springgreen", 0x00FF7F},
+        {"steelblue", 0x4682B4},
+        {"tan", 0xD2B48C},
+        {"teal", 0x008080},
+        {"thistle", 0xD8BFD8},
+        {"tomato", 0xFF6347},
+        {"turquoise", 0x40E0D0},
+        {"violet", 0xEE82EE},
+        {"wheat", 0xF5DEB3},
+        {"white", 0xFFFFFF},
+        {"whitesmoke", 0xF5F5F5},
+        {"yellow", 0xFFFF00},
+        {"yellowgreen", 0x9ACD32},
+    });
 
-    if (!color_file.is_open()) {
-        s_colorMap["none"] = Color(0, 0, 0, 0);
-        s_colorMap["black"] = Color(255, 0, 0, 0);
-        s_colorMap["white"] = Color(255, 255, 255, 255);
-        return;
+    constexpr size_t kLongestName = 20; // lightgoldenrodyellow
+
+    static_assert(kNamedColors.Find("rebeccapurple", kNoColor) == 0x663399);
+    static_assert(kNamedColors.Find("black", kNoColor) == 0x000000);
+    static_assert(kNamedColors.Find("blacks", kNoColor) == kNoColor);
+
+    bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+    char ToLower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+    std::string_view Trim(std::string_view s)
+    {
+        while (!s.empty() && IsSpace(s.front()))
+            s.remove_prefix(1);
+        while (!s.empty() && IsSpace(s.back()))
+            s.remove_suffix(1);
+        return s;
     }
 
-    string color_line = "";
-    while (getline(color_file, color_line)) {
-        if (color_line.empty()) continue;
-
-        stringstream ss(color_line);
-        string token = "";
-        vector<string> vct;
-
-        while (ss >> token)
-            vct.push_back(token);
-
-        if (vct.size() < 2) continue; 
-
-        string color_name = "";
-        string hexa_code;
-        int n = vct.size();
-
-        
-        for (int i = 0; i < n - 1; i++)
-            color_name = color_name + vct[i];
-
-        
-        transform(color_name.begin(), color_name.end(), color_name.begin(), ::tolower);
-
-        hexa_code = vct[n - 1]; 
-
-        try {
-            if (!hexa_code.empty() && hexa_code[0] == '#') {
-                if (hexa_code.size() == 4) { // #RGB
-                    string r_s = string(2, hexa_code[1]);
-                    string g_s = string(2, hexa_code[2]);
-                    string b_s = string(2, hexa_code[3]);
-                    int r = stoi(r_s, nullptr, 16);
-                    int g = stoi(g_s, nullptr, 16);
-                    int b = stoi(b_s, nullptr, 16);
-                    s_colorMap[color_name] = Color(255, r, g, b);
-                }
-                else if (hexa_code.size() >= 7) { // #RRGGBB
-                    int r = stoi(hexa_code.substr(1, 2), nullptr, 16);
-                    int g = stoi(hexa_code.substr(3, 2), nullptr, 16);
-                    int b = stoi(hexa_code.substr(5, 2), nullptr, 16);
-                    s_colorMap[color_name] = Color(255, r, g, b);
-                }
-            }
-        }
-        catch (...) {
-            continue; 
+    // lower must already be lowercase.
+    bool EqualsNoCase(std::string_view s, std::string_view lower)
+    {
+        if (s.size() != lower.size())
+            return false;
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            if (ToLower(s[i]) != lower[i])
+                return false;
         }
+        return true;
     }
 
-    s_colorMap["none"] = Color(0, 0, 0, 0);
-    s_colorMap["transparent"] = Color(0, 0, 0, 0);
-    color_file.close();
-}
+    int HexDigit(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    uint8_t ToByte(float v)
+    {
+        return static_cast<uint8_t>((std::max)(0.0f, (std::min)(255.0f, v)) + 0.5f);
+    }
+
+    // The digits after '#': 3, 4, 6 or 8 of them, alpha last.
+    bool ParseHex(std::string_view hex, Color &out)
+    {
+        const size_t n = hex.size();
+        if (n != 3 && n != 4 && n != 6 && n != 8)
+            return false;
 
-Color SvgColors::GetColor(std::string strokecolor, std::string strokeopa) {
+        int d[8];
+        for (size_t i = 0; i < n; ++i)
+        {
+            d[i] = HexDigit(hex[i]);
+            if (d[i] < 0)
+                return false;
+        }
 
-    float opacityVal = 1.0f;
-    if (!strokeopa.empty()) {
-        try { opacityVal = stof(strokeopa); }
-        catch (...) { opacityVal = 1.0f; }
+        if (n <= 4)
+            out = Color(n == 4 ? d[3] * 17 : 255, d[0] * 17, d[1] * 17, d[2] * 17);
+        else
+            out = Color(n == 8 ? d[6] * 16 + d[7] : 255, d[0] * 16 + d[1], d[2] * 16 + d[3], d[4] * 16 + d[5]);
+        return true;
     }
-    if (opacityVal > 1.0f) opacityVal = 1.0f;
-    if (opacityVal < 0.0f) opacityVal = 0.0f;
 
-    BYTE alpha = (BYTE)(opacityVal * 255); 
+    struct ColorArg
+    {
+        float value;
+        bool percent;
+    };
+
+    // Splits the inside of rgb()/hsl() into at most four values. Both the
+    // legacy comma form and the space form with "/ alpha" are accepted.
+    // Angle units are folded into degrees. Returns the count, or -1 if
+    // something does not parse.
+    int ReadArgs(std::string_view args, ColorArg (&out)[4])
+    {
+        int count = 0;
+        while (true)
+        {
+            args = Trim(args);
+            if (args.empty())
+                return count;
+            if (count == 4)
+                return -1;
+            if (count > 0 && (args.front() == ',' || args.front() == '/'))
+                args.remove_prefix(1);
+
+            ColorArg &arg = out[count++];
+            arg.percent = false;
+            if (!SvgNumber::Parse(args, arg.value))
+                return -1;
+
+            if (!args.empty() && args.front() == '%')
+            {
+                arg.percent = true;
+                args.remove_prefix(1);
+                continue;
+            }
+
+            size_t unit = 0;
+            while (unit < args.size() && args[unit] >= 'a' && args[unit] <= 'z')
+                ++unit;
+            if (unit == 0)
+                continue;
+            const std::string_view suffix = args.substr(0, unit);
+            args.remove_prefix(unit);
 
-    
-    if (strokecolor.find("rgb") != string::npos) {
-        for (int i = 0; i < strokecolor.size(); i++) {
-            if (!isdigit(strokecolor[i]) && strokecolor[i] != '.')
-                strokecolor[i] = ' ';
+            if (suffix == "rad")
+                arg.value *= static_cast<float>(180.0 / 3.14159265358979323846);
+            else if (suffix == "grad")
+                arg.value *= 0.9f;
+            else if (suffix == "turn")
+                arg.value *= 360.0f;
+            else if (suffix != "deg")
+                return -1;
         }
+    }
 
-        stringstream ss(strokecolor);
-        float r = 0, g = 0, b = 0;
-        ss >> r >> g >> b;
+    uint8_t Channel(const ColorArg &arg)
+    {
+        return ToByte(arg.percent ? arg.value * 2.55f : arg.value);
+    }
 
-        return Color(alpha, (BYTE)r, (BYTE)g, (BYTE)b);
+    uint8_t Alpha(const ColorArg *arg)
+    {
+        if (!arg)
+            return 255;
+        return ToByte((arg->percent ? arg->value / 100.0f : arg->value) * 255.0f);
     }
 
-    else if (!strokecolor.empty() && strokecolor[0] == '#') {
-        if (strokecolor.size() == 4) { // Convert #RGB -> #RRGGBB
-            string tmp = "#";
-            for (int i = 1; i < 4; i++)
-                tmp = tmp + strokecolor[i] + strokecolor[i];
-            strokecolor = tmp;
-        }
+    // CSS Color 4 hsl-to-rgb, with saturation and lightness in 0..1.
+    float HslComponent(int n, float hue, float s, float l)
+    {
+        const float k = std::fmod(n + hue / 30.0f, 12.0f);
+        const float a = s * (std::min)(l, 1.0f - l);
+        return l - a * (std::max)(-1.0f, (std::min)({k - 3.0f, 9.0f - k, 1.0f}));
+    }
 
-        try {
-            int r = stoi(strokecolor.substr(1, 2), nullptr, 16);
-            int g = stoi(strokecolor.substr(3, 2), nullptr, 16);
-            int b = stoi(strokecolor.substr(5, 2), nullptr, 16);
-            return Color(alpha, r, g, b);
-        }
-        catch (...) {
-            return Color(0, 0, 0, 0); 
-        }
+    Color FromHsl(const ColorArg (&args)[4], int count)
+    {
+        float hue = std::fmod(args[0].value, 360.0f);
+        if (hue < 0.0f)
+            hue += 360.0f;
+        const float s = (std::max)(0.0f, (std::min)(1.0f, args[1].value / 100.0f));
+        const float l = (std::max)(0.0f, (std::min)(1.0f, args[2].value / 100.0f));
+        return Color(Alpha(count == 4 ? &args[3] : nullptr),
+                     ToByte(HslComponent(0, hue, s, l) * 255.0f),
+                     ToByte(HslComponent(8, hue, s, l) * 255.0f),
+                     ToByte(HslComponent(4, hue, s, l) * 255.0f));
     }
+}
 
-    
-    else {
-        
-        string key = strokecolor;
-        for (int i = 0; i < key.size(); i++) {
-            if (isupper(key[i])) key[i] = tolower(key[i]);
-        }
+bool SvgColors::FindNamedColor(std::string_view name, Color &out)
+{
+    if (name.size() > kLongestName)
+        return false;
 
-        key.erase(0, key.find_first_not_of(" \t\r\n"));
-        key.erase(key.find_last_not_of(" \t\r\n") + 1);
+    char lower[kLongestName];
+    for (size_t i = 0; i < name.size(); ++i)
+        lower[i] = ToLower(name[i]);
 
-        string searchKey = "";
-        for (char c : key) {
-            if (c != ' ') searchKey += c;
-        }
+    const uint32_t rgb = kNamedColors.Find(std::string_view(lower, name.size()), kNoColor);
+    if (rgb == kNoColor)
+        return false;
+    out = Color(255, (rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+    return true;
+}
+
+bool SvgColors::Parse(std::string_view value, Color &out)
+{
+    value = Trim(value);
+    if (value.empty())
+        return false;
+
+    if (value.front() == '#')
+        return ParseHex(value.substr(1), out);
 
-        if (s_colorMap.find(searchKey) != s_colorMap.end()) {
-            Color baseColor = s_colorMap[searchKey];
-            return Color(alpha, baseColor.GetR(), baseColor.GetG(), baseColor.GetB());
+    const size_t open = value.find('(');
+    if (open == std::string_view::npos)
+    {
+        if (EqualsNoCase(value, "none") || EqualsNoCase(value, "transparent"))
+        {
+            out = Color(0, 0, 0, 0);
+            return true;
         }
+        return FindNamedColor(value, out);
     }
 
-    return Color(0, 0, 0, 0);
-}
\ No newline at end of file
+    if (value.back() != ')')
+        return false;
+    const std::string_view function = Trim(value.substr(0, open));
+    const bool rgb = EqualsNoCase(function, "rgb") || EqualsNoCase(function, "rgba");
+    const bool hsl = EqualsNoCase(function, "hsl") || EqualsNoCase(function, "hsla");
+    if (!rgb && !hsl)
+        return false;
+
+    ColorArg args[4];
+    const int count = ReadArgs(value.substr(open + 1, value.size() - open - 2), args);
+    if (count != 3 && count != 4)
+        return false;
+
+    if (hsl)
+        out = FromHsl(args, count);
+    else
+        out = Color(Alpha(count == 4 ? &args[3] : nullptr), Channel(args[0]), Channel(args[1]), Channel(args[2]));
+    return true;
+}
@@ -1,19 +1,23 @@
 #ifndef _SVGCOLORS_H_
 #define _SVGCOLORS_H_
-#include <string>
-#include <unordered_map>
-#include <gdiplus.h>
+#include <string_view>
+#include "SvgPlatform.h"
 
 using namespace Gdiplus;
 
+// CSS colour values, parsed straight from the attribute bytes without
+// allocating. The named colours are the CSS Color 4 keyword set, compiled
+// in, so nothing is loaded at startup and there is no state to share:
+// both functions are safe to call from any number of threads.
 class SvgColors {
 public:
-    static void LoadColors(const std::string& filePath);
+    // Parses #RGB, #RGBA, #RRGGBB, #RRGGBBAA, rgb()/rgba() with numbers or
+    // percentages, hsl()/hsla(), a colour keyword, "transparent" or "none".
+    // Leaves out untouched and returns false for anything else.
+    static bool Parse(std::string_view value, Color &out);
 
-    static Color GetColor(std::string colorStr, std::string opacityStr = "1.0");
-
-private:
-    static std::unordered_map<std::string, Color> s_colorMap;
+    // Looks up a colour keyword, ignoring ASCII case.
+    static bool FindNamedColor(std::string_view name, Color &out);
 };
 
-#endif
\ No newline at end of file
+#endif
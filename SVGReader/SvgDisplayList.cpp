@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "SvgDisplayList.h"
+#include "SvgDocument.h"
+#include "IRenderer.h"
+
+SvgDisplayList::SvgDisplayList(const SvgScene &scene)
+    : m_nodes{{SvgMatrix(), 0}}
+{
+    if (!scene.GetDocument())
+        return;
+    std::vector<uint32_t> nodes(scene.Size(), 0);
+    Add(scene, scene.GetFirstDrawn(), static_cast<uint32_t>(scene.Size()), 0, nullptr, nullptr, nodes);
+}
+
+uint32_t SvgDisplayList::AddNode(const SvgMatrix &transform, uint32_t parent)
+{
+    // Multiplying by the identity changes nothing, not even the rounding.
+    if (transform.IsIdentity())
+        return parent;
+    m_nodes.push_back({transform, parent});
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void SvgDisplayList::Add(const SvgScene &scene, uint32_t begin, uint32_t end, uint32_t outerNode,
+                         const SvgMatrix *outer, const SvgInheritedStyle *inherited, std::vector<uint32_t> &nodes)
+{
+    const SvgDocument &document = *scene.GetDocument();
+    const SvgStyleTable &styles = document.GetStyles();
+    const auto &gradients = document.GetGradients();
+    for (uint32_t item = begin; item < end; ++item)
+    {
+        const SvgScene::Kind kind = scene.GetKind(item);
+        const ISvgElement &element = scene.GetElement(item);
+        // Items outside any group here hang from the use, or the root.
+        const uint32_t parent = scene.GetParent(item);
+        const uint32_t parentNode = parent != SvgScene::kNone && parent >= begin ? nodes[parent] : outerNode;
+        const uint32_t node = AddNode(element.transform, parentNode);
+        if (kind == SvgScene::Kind::Group)
+        {
+            nodes[item] = node;
+            continue;
+        }
+
+        if (kind == SvgScene::Kind::Use)
+        {
+            // As the renderers' DrawUse: the target under the use, with the
+            // use's paint over what reached the use.
+            const uint32_t target = scene.GetTarget(item);
+            if (target == SvgScene::kNone)
+                continue;
+            const SvgMatrix world = outer ? *outer * scene.GetWorld(item) : scene.GetWorld(item);
+            const SvgInheritedStyle handed =
+                PassPaint(styles[element.style], inherited ? *inherited : SvgInheritedStyle());
+            Add(scene, target, scene.GetEnd(target), node, &world, &handed, nodes);
+            continue;
+        }
+
+        const SvgStyle *style = &styles[element.style];
+        if (inherited)
+        {
+            m_instanceStyles.push_back(*style);
+            InheritPaint(m_instanceStyles.back(), *inherited);
+            style = &m_instanceStyles.back();
+        }
+        const SvgGradient *fill = nullptr;
+        if (style->fillUrl != 0)
+        {
+            auto it = gradients.find(std::string(styles.GetString(style->fillUrl)));
+            if (it != gradients.end())
+                fill = it->second.get();
+        }
+        m_commands.push_back({kind, node, &element, style, fill});
+
+        // A target's items are bounded in its own space.
+        const SvgBounds box = outer ? scene.GetBounds(item).Transformed(*outer) : scene.GetBounds(item);
+        m_bounds.push_back(box);
+        m_sceneBounds.Union(box);
+    }
+}
+
+void SvgDisplayList::Replay(IRenderer &renderer, const SvgMatrix &root) const
+{
+    Draw(renderer, nullptr, root);
+}
+
+void SvgDisplayList::Replay(IRenderer &renderer, const SvgBounds &visible, const SvgMatrix &root) const
+{
+    Draw(renderer, &visible, root);
+}
+
+void SvgDisplayList::Draw(IRenderer &renderer, const SvgBounds *visible, const SvgMatrix &root) const
+{
+    const SvgMatrix &base = renderer.BeginResolved();
+    // Each node to the device, parents first: the matrices a walk would
+    // have built on its way down.
+    std::vector<SvgMatrix> toDevice(m_nodes.size());
+    toDevice[0] = root.IsIdentity() ? base : base * root;
+    for (size_t i = 1; i < m_nodes.size(); ++i)
+        toDevice[i] = toDevice[m_nodes[i].parent] * m_nodes[i].transform;
+
+    for (size_t i = 0; i < m_commands.size(); ++i)
+    {
+        if (visible && !m_bounds[i].Intersects(*visible))
+            continue;
+        const Command &command = m_commands[i];
+        renderer.SetResolved(toDevice[command.node], *command.style, command.fill);
+
+        const ISvgElement &element = *command.element;
+        switch (command.kind)
+        {
+        case SvgScene::Kind::Line:
+            renderer.DrawLine(static_cast<const SvgLine &>(element));
+            break;
+        case SvgScene::Kind::Rect:
+            renderer.DrawRect(static_cast<const SvgRect &>(element));
+            break;
+        case SvgScene::Kind::Circle:
+            renderer.DrawCircle(static_cast<const SvgCircle &>(element));
+            break;
+        case SvgScene::Kind::Ellipse:
+            renderer.DrawEllipse(static_cast<const SvgEllipse &>(element));
+            break;
+        case SvgScene::Kind::Polyline:
+            renderer.DrawPolyline(static_cast<const SvgPolyline &>(element));
+            break;
+        case SvgScene::Kind::Polygon:
+            renderer.DrawPolygon(static_cast<const SvgPolygon &>(element));
+            break;
+        case SvgScene::Kind::Path:
+            renderer.DrawPath(static_cast<const SvgPath &>(element));
+            break;
+        case SvgScene::Kind::Text:
+            renderer.DrawText(static_cast<const SvgText &>(element));
+            break;
+        default:
+            break;
+        }
+    }
+    renderer.EndResolved();
+}
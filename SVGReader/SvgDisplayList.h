@@ -0,0 +1,92 @@
+#ifndef _SVGDISPLAYLIST_H_
+#define _SVGDISPLAYLIST_H_
+
+#include "SvgScene.h"
+#include "SvgStyle.h"
+#include "SvgTransform.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class IRenderer;
+class SvgGradient;
+
+// A document lowered once into a flat list of draw commands, for drawing
+// it again and again. A command is one leaf element with what a renderer
+// would otherwise work out on every draw already settled: its final style
+// (for content of a <use>, completed with what the use hands down) and the
+// gradient its fill names. Uses are expanded into their targets' commands,
+// so a replay is one pass over arrays: no tree walk, no transform stack,
+// no style or gradient lookups by name.
+//
+// Transforms are kept as a tree of the ones that are not the identity
+// (groups', uses' and elements' own), each under the one around it. A
+// replay multiplies them out from the renderer's matrix down, once per
+// node and in the order a tree walk multiplies them, so the pixels are
+// the walk's: floating-point products differ with their grouping.
+//
+// Any IRenderer replays it through BeginResolved and SetResolved. Pan,
+// zoom and rotation only change the root matrix given to Replay. Groups
+// carry nothing but their transform here, as in the document model, so
+// there are no layers (group opacity, clipping) to push and pop.
+//
+// Compiled from a scene, the list points into the same document and is
+// only valid while that is alive and unchanged; compile it again after
+// an edit.
+class SvgDisplayList
+{
+public:
+    SvgDisplayList() = default;
+    explicit SvgDisplayList(const SvgScene &scene);
+
+    SvgDisplayList(const SvgDisplayList &) = delete;
+    SvgDisplayList &operator=(const SvgDisplayList &) = delete;
+    SvgDisplayList(SvgDisplayList &&) = default;
+    SvgDisplayList &operator=(SvgDisplayList &&) = default;
+
+    size_t Size() const { return m_commands.size(); }
+    // Document-space box around everything drawn, stroke included.
+    const SvgBounds &GetBounds() const { return m_sceneBounds; }
+
+    // root takes document space to the space the renderer is in.
+    void Replay(IRenderer &renderer, const SvgMatrix &root = SvgMatrix()) const;
+    // Skips the commands whose bounds miss visible, a document-space box.
+    void Replay(IRenderer &renderer, const SvgBounds &visible, const SvgMatrix &root = SvgMatrix()) const;
+
+private:
+    struct Command
+    {
+        SvgScene::Kind kind;
+        uint32_t node;              // index into m_nodes
+        const ISvgElement *element;
+        const SvgStyle *style;
+        const SvgGradient *fill;    // nullptr: the style's colour
+    };
+
+    // A transform under the node parent; node 0 is the root, the identity.
+    // Parents come before their children.
+    struct Node
+    {
+        SvgMatrix transform;
+        uint32_t parent;
+    };
+
+    // Adds the leaves of items [begin, end). A use's target is added under
+    // outerNode, the use's own node, whose document-space matrix is outer,
+    // and with the paint inherited handed down. nodes holds the node of
+    // each group added so far, by item.
+    void Add(const SvgScene &scene, uint32_t begin, uint32_t end, uint32_t outerNode, const SvgMatrix *outer,
+             const SvgInheritedStyle *inherited, std::vector<uint32_t> &nodes);
+    // A node for transform under parent, or parent itself for the identity.
+    uint32_t AddNode(const SvgMatrix &transform, uint32_t parent);
+    void Draw(IRenderer &renderer, const SvgBounds *visible, const SvgMatrix &root) const;
+
+    std::vector<Command> m_commands;
+    std::vector<SvgBounds> m_bounds;        // per command, document space
+    std::vector<Node> m_nodes;
+    // Styles of use content; a deque, so the commands' pointers hold.
+    std::deque<SvgStyle> m_instanceStyles;
+    SvgBounds m_sceneBounds;
+};
+
+#endif
@@ -1,10 +1,174 @@
 #include "stdafx.h"
 #include "SvgDocument.h"
 #include "IRenderer.h"
+#include <unordered_map>
+
+void SvgDocument::AdoptArenas(SvgDocument &part)
+{
+    for (auto &arena : part.arenas)
+        arenas.push_back(std::move(arena));
+    part.arenas.clear();
+    part.elements.clear();
+    definitions.insert(definitions.end(), part.definitions.begin(), part.definitions.end());
+    part.definitions.clear();
+    for (const auto &[id, element] : part.ids)
+        ids.try_emplace(id, element);
+    part.ids.clear();
+}
+
+size_t SvgDocument::ArenaBytes() const
+{
+    size_t bytes = 0;
+    for (const auto &arena : arenas)
+        bytes += arena->BytesUsed();
+    return bytes;
+}
+
+ISvgElement *SvgDocument::FindElement(std::string_view id)
+{
+    auto it = ids.find(std::string(id));
+    return it != ids.end() ? it->second : nullptr;
+}
+
+const ISvgElement *SvgDocument::FindElement(std::string_view id) const
+{
+    return const_cast<SvgDocument *>(this)->FindElement(id);
+}
+
+namespace
+{
+    void Remap(ISvgElement &element, const SvgStyleTable::Remap &remap)
+    {
+        element.style = remap.styles[element.style];
+        if (auto group = dynamic_cast<SvgGroup *>(&element))
+        {
+            for (ISvgElement *child : group->children)
+                Remap(*child, remap);
+        }
+        else if (auto use = dynamic_cast<SvgUse *>(&element))
+        {
+            use->href = remap.strings[use->href];
+        }
+    }
+
+    // Calls visit on every use in element and what it contains.
+    template <typename Visit>
+    void ForEachUse(ISvgElement &element, Visit &visit)
+    {
+        if (auto group = dynamic_cast<SvgGroup *>(&element))
+        {
+            for (ISvgElement *child : group->children)
+                ForEachUse(*child, visit);
+        }
+        else if (auto use = dynamic_cast<SvgUse *>(&element))
+        {
+            visit(*use);
+        }
+    }
+
+    // Follows every use from element down into its target. A use met again
+    // while its own target is still being walked would be drawn inside
+    // itself forever, so it loses its target. open holds the uses on the
+    // way down (true) and those already cleared (false).
+    void BreakCycles(ISvgElement &element, std::unordered_map<const SvgUse *, bool> &open)
+    {
+        auto visit = [&](SvgUse &use)
+        {
+            if (!use.target)
+                return;
+            auto [it, first] = open.try_emplace(&use, true);
+            if (!first)
+            {
+                if (it->second)
+                    use.target = nullptr;
+                return;
+            }
+            // Targets are only ever read when drawn; the walk here is the
+            // one place that needs to reach their uses.
+            BreakCycles(const_cast<ISvgElement &>(*use.target), open);
+            open[&use] = false;
+        };
+        ForEachUse(element, visit);
+    }
+}
+
+void SvgDocument::AdoptStyles(const SvgDocument &part, std::span<ISvgElement *const> adopted)
+{
+    const SvgStyleTable::Remap remap = styles.Merge(part.styles);
+    for (ISvgElement *element : adopted)
+        Remap(*element, remap);
+    for (ISvgElement *element : part.definitions)
+        Remap(*element, remap);
+}
+
+void SvgDocument::ResolveUses()
+{
+    auto link = [&](SvgUse &use) { use.target = FindElement(styles.GetString(use.href)); };
+    for (ISvgElement *element : elements)
+        ForEachUse(*element, link);
+    for (ISvgElement *element : definitions)
+        ForEachUse(*element, link);
+
+    std::unordered_map<const SvgUse *, bool> open;
+    for (ISvgElement *element : elements)
+        BreakCycles(*element, open);
+    for (ISvgElement *element : definitions)
+        BreakCycles(*element, open);
+
+    // A symbol's viewBox goes into the viewport of each use of it: the
+    // use's width and height, else the document's size, else the viewBox's
+    // own. A viewport with no area draws nothing.
+    auto place = [&](SvgUse &use)
+    {
+        auto symbol = dynamic_cast<const SvgSymbol *>(use.target);
+        if (!symbol || !symbol->hasViewBox)
+            return;
+        const float w = use.width >= 0.0f ? use.width : width > 0.0f ? width : symbol->viewBox.width;
+        const float h = use.height >= 0.0f ? use.height : height > 0.0f ? height : symbol->viewBox.height;
+        if (!(w > 0.0f) || !(h > 0.0f))
+        {
+            use.target = nullptr;
+            return;
+        }
+        const SvgMatrix fit = symbol->viewBox.Fit(w, h);
+        use.transform = use.transform * fit;
+        use.placement = use.placement * fit;
+    };
+    for (ISvgElement *element : elements)
+        ForEachUse(*element, place);
+    for (ISvgElement *element : definitions)
+        ForEachUse(*element, place);
+}
+
+void SvgDocument::ResolveStyles()
+{
+    const SvgInheritedStyle none;
+    for (const auto &e : elements)
+    {
+        if (e)
+            e->ResolveStyle(none, styles);
+    }
+    SvgInheritedStyle inDefinition;
+    inDefinition.definition = true;
+    for (ISvgElement *e : definitions)
+        e->ResolveStyle(inDefinition, styles);
+}
+
+void SvgDocument::ResolveBounds()
+{
+    for (ISvgElement *e : elements)
+    {
+        if (e)
+            e->UpdateFillBox(styles);
+    }
+    for (ISvgElement *e : definitions)
+        e->UpdateFillBox(styles);
+}
 
 void SvgDocument::Render(IRenderer &renderer) const
 {
     renderer.SetGradients(paintServer.GetGradients());
+    renderer.SetStyles(styles);
     for (const auto &e : elements)
     {
         if (e)
@@ -2,8 +2,11 @@
 #define _SVGDOCUMENT_H_
 
 #include "stdafx.h"
+#include "SvgArena.h"
 #include "SvgElement.h"
 #include "SvgGradient.h"
+#include "SvgStyle.h"
+#include <span>
 #include <unordered_map>
 #include <memory>
 #include <string>
@@ -12,18 +15,89 @@ class IRenderer;
 
 #include "SvgPaintServer.h"
 
-class IRenderer;
-
+// Owns its elements through the arenas they were created in: destroying
+// or replacing a document releases those wholesale, and no element outlives
+// its document.
 class SvgDocument
 {
 public:
-    void AddElement(std::unique_ptr<ISvgElement> element)
+    // Where the document's elements are created; see SvgArena.
+    SvgArena &GetArena()
+    {
+        if (arenas.empty())
+            arenas.push_back(std::make_unique<SvgArena>());
+        return *arenas.front();
+    }
+
+    // element must have been created in this document's arena, or in one it
+    // adopts before part goes away.
+    void AddElement(ISvgElement *element)
+    {
+        elements.push_back(element);
+    }
+
+    // Content that is not drawn where it stands but only through <use>:
+    // <defs> (held in a group) and <symbol>. Same ownership as AddElement.
+    void AddDefinition(ISvgElement *element)
     {
-        elements.push_back(std::move(element));
+        definitions.push_back(element);
     }
 
+    // Takes over the arenas of part, so elements built there can be added
+    // to this document, and the definitions and ids of those elements. part
+    // is left without elements.
+    void AdoptArenas(SvgDocument &part);
+
+    // Bytes the elements and what they own take in the document's arenas;
+    // see SvgArena::BytesUsed.
+    size_t ArenaBytes() const;
+
+    // Makes element, created in this document, findable by id. The first
+    // element given an id keeps it.
+    void SetElementId(std::string_view id, ISvgElement *element)
+    {
+        if (!id.empty())
+            ids.try_emplace(std::string(id), element);
+    }
+
+    // The element with that id attribute, or null. Gradients are looked up
+    // with GetGradient instead.
+    ISvgElement *FindElement(std::string_view id);
+    const ISvgElement *FindElement(std::string_view id) const;
+
+    // Interns the styles of part here and re-points adopted, elements built
+    // against part's table (groups with all they contain), and part's
+    // definitions at this one.
+    void AdoptStyles(const SvgDocument &part, std::span<ISvgElement *const> adopted);
+
+    // Where element styles are interned; see SvgStyle.
+    SvgStyleTable &GetStyles() { return styles; }
+    const SvgStyleTable &GetStyles() const { return styles; }
+
+    // Only reads the document, so any number of renderers may draw it at
+    // once. Call ResolveStyles first; SvgSnapshot freezes a finished
+    // document for sharing between threads.
     void Render(IRenderer &renderer) const;
 
+    // Top-level elements in draw order.
+    const std::vector<ISvgElement *> &GetElements() const { return elements; }
+    const std::vector<ISvgElement *> &GetDefinitions() const { return definitions; }
+
+    // Points every SvgUse at the element its href names, once all ids are
+    // known, cuts references that would loop, and fits symbol targets into
+    // their uses' viewports. The parsers run it once, when a document is
+    // complete.
+    void ResolveUses();
+
+    // Hands inherited paint down the group tree into every element (see
+    // ISvgElement::ResolveStyle). The parsers run it once when a document is
+    // complete; running it again would apply inherited opacity twice.
+    void ResolveStyles();
+
+    // Fills in the fillBox of every element, definitions included. The
+    // parsers run it after ResolveStyles, which settles the font of text.
+    void ResolveBounds();
+
     void SetSize(float w, float h)
     {
         width = w;
@@ -37,6 +111,13 @@ public:
         paintServer.AddGradient(gradient);
     }
 
+    // Adds every gradient of part, replacing ones with the same id.
+    void AddGradients(const SvgDocument &part)
+    {
+        for (const auto &[id, gradient] : part.GetGradients())
+            paintServer.AddGradient(gradient);
+    }
+
     void ResolveGradients()
     {
         paintServer.ResolveGradients();
@@ -53,10 +134,14 @@ public:
     }
 
 private:
-    std::vector<std::unique_ptr<ISvgElement>> elements;
+    std::vector<ISvgElement *> elements;
+    std::vector<ISvgElement *> definitions;
+    std::unordered_map<std::string, ISvgElement *> ids;
+    SvgStyleTable styles;
     SvgPaintServer paintServer;
     float width = 0.0f;
     float height = 0.0f;
+    std::vector<std::unique_ptr<SvgArena>> arenas;
 };
 
 #endif
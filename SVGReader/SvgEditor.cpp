@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include "SvgEditor.h"
+#include <memory>
+
+namespace
+{
+    // Calls count for the style of element and of everything in it.
+    template <typename Count>
+    void CountStyles(const ISvgElement &element, Count &count)
+    {
+        count(element.style);
+        if (auto group = dynamic_cast<const SvgGroup *>(&element))
+        {
+            for (const ISvgElement *child : group->children)
+                CountStyles(*child, count);
+        }
+    }
+}
+
+SvgEditor::SvgEditor(SvgDocument &&document) : m_document(std::move(document)), m_scene(m_document)
+{
+    m_items.reserve(m_scene.Size());
+    for (uint32_t item = m_scene.GetFirstDrawn(); item < m_scene.Size(); ++item)
+        m_items.emplace(&m_scene.GetElement(item), item);
+    for (uint32_t item = 0; item < m_scene.GetFirstDrawn(); ++item)
+        m_targetItems.emplace(&m_scene.GetElement(item), item);
+    for (uint32_t item = 0; item < m_scene.Size(); ++item)
+    {
+        if (m_scene.GetKind(item) == SvgScene::Kind::Use && m_scene.GetTarget(item) != SvgScene::kNone)
+            m_instances[m_scene.GetTarget(item)].push_back(item);
+    }
+
+    m_styleRefs.resize(m_document.GetStyles().Size());
+    auto count = [&](uint32_t style) { ++m_styleRefs[style]; };
+    for (const ISvgElement *element : m_document.GetElements())
+        CountStyles(*element, count);
+    for (const ISvgElement *element : m_document.GetDefinitions())
+        CountStyles(*element, count);
+}
+
+template <typename T>
+T &SvgEditor::Reclaimable(T &storage)
+{
+    // Arena storage is never freed, so it is traded for pool storage once;
+    // the arena runs no destructors, so the swap leaks nothing either way.
+    if (storage.get_allocator().resource() != &m_pool)
+    {
+        std::destroy_at(&storage);
+        std::construct_at(&storage, typename T::allocator_type(&m_pool));
+    }
+    return storage;
+}
+
+SvgBounds SvgEditor::Changed(const ISvgElement &element)
+{
+    // An element is drawn itself, through the uses of a target it is in,
+    // both, or not at all (in <defs> or a <symbol> nothing uses).
+    SvgBounds damage;
+    auto drawn = m_items.find(&element);
+    if (drawn != m_items.end())
+        damage = m_scene.Update(drawn->second);
+    auto target = m_targetItems.find(&element);
+    if (target != m_targetItems.end())
+    {
+        m_scene.Update(target->second);
+        damage.Union(Instanced(target->second));
+    }
+    return damage;
+}
+
+SvgBounds SvgEditor::Instanced(uint32_t item)
+{
+    uint32_t root = item;
+    while (m_scene.GetParent(root) != SvgScene::kNone)
+        root = m_scene.GetParent(root);
+    auto uses = m_instances.find(root);
+    if (uses == m_instances.end())
+        return {};
+
+    // A use inside another target shows wherever that target does in turn;
+    // SvgDocument::ResolveUses cut every loop, so this ends.
+    SvgBounds damage;
+    for (uint32_t use : uses->second)
+    {
+        if (use >= m_scene.GetFirstDrawn())
+        {
+            damage.Union(m_scene.Update(use));
+        }
+        else
+        {
+            m_scene.Update(use);
+            damage.Union(Instanced(use));
+        }
+    }
+    return damage;
+}
+
+SvgBounds SvgEditor::Reshaped(ISvgElement &element)
+{
+    element.UpdateFillBox(m_document.GetStyles());
+    return Changed(element);
+}
+
+SvgBounds SvgEditor::Restyle(ISvgElement &element, const SvgStyle &style)
+{
+    if (dynamic_cast<const SvgGroup *>(&element) || dynamic_cast<const SvgUse *>(&element))
+        return {};
+    // A record only this element used is rewritten rather than left behind,
+    // and records other edits left unused are taken before the table grows.
+    SvgStyleTable &styles = m_document.GetStyles();
+    const uint32_t old = element.style;
+    uint32_t index;
+    if (!styles.Find(style, index))
+    {
+        if (old != 0 && m_styleRefs[old] == 1)
+        {
+            index = old;
+            styles.Reuse(index, style);
+        }
+        else if (!m_freeStyles.empty())
+        {
+            index = m_freeStyles.back();
+            m_freeStyles.pop_back();
+            styles.Reuse(index, style);
+        }
+        else
+        {
+            index = styles.Intern(style);
+            m_styleRefs.push_back(0);
+        }
+    }
+    if (index != old)
+    {
+        // Find may have brought back a record that was free.
+        if (m_styleRefs[index]++ == 0)
+            std::erase(m_freeStyles, index);
+        if (--m_styleRefs[old] == 0 && old != 0)
+            m_freeStyles.push_back(old);
+    }
+    element.style = index;
+    return Changed(element);
+}
+
+SvgBounds SvgEditor::SetFill(ISvgElement &element, Gdiplus::Color color)
+{
+    SvgStyle style = m_document.GetStyles()[element.style];
+    style.fillColor = ApplyOpacity(color, style.fillOpacity);
+    style.fillUrl = 0;
+    style.hasInputFill = true;
+    return Restyle(element, style);
+}
+
+SvgBounds SvgEditor::SetStroke(ISvgElement &element, Gdiplus::Color color)
+{
+    SvgStyle style = m_document.GetStyles()[element.style];
+    style.strokeColor = ApplyOpacity(color, style.strokeOpacity);
+    style.hasInputStroke = true;
+    return Restyle(element, style);
+}
+
+SvgBounds SvgEditor::SetStrokeWidth(ISvgElement &element, float width)
+{
+    SvgStyle style = m_document.GetStyles()[element.style];
+    style.strokeWidth = width;
+    style.hasInputStrokeWidth = true;
+    return Restyle(element, style);
+}
+
+SvgBounds SvgEditor::SetTransform(ISvgElement &element, const SvgMatrix &transform)
+{
+    // A use keeps its x, y and viewport after the new transform.
+    if (auto use = dynamic_cast<const SvgUse *>(&element))
+        element.transform = transform * use->placement;
+    else
+        element.transform = transform;
+    return Changed(element);
+}
+
+SvgBounds SvgEditor::SetLine(SvgLine &line, float x1, float y1, float x2, float y2)
+{
+    line.x1 = x1;
+    line.y1 = y1;
+    line.x2 = x2;
+    line.y2 = y2;
+    return Reshaped(line);
+}
+
+SvgBounds SvgEditor::SetRect(SvgRect &rect, float x, float y, float w, float h)
+{
+    rect.x = x;
+    rect.y = y;
+    rect.w = w;
+    rect.h = h;
+    return Reshaped(rect);
+}
+
+SvgBounds SvgEditor::SetCircle(SvgCircle &circle, float cx, float cy, float r)
+{
+    circle.cx = cx;
+    circle.cy = cy;
+    circle.r = r;
+    return Reshaped(circle);
+}
+
+SvgBounds SvgEditor::SetEllipse(SvgEllipse &ellipse, float cx, float cy, float rx, float ry)
+{
+    ellipse.cx = cx;
+    ellipse.cy = cy;
+    ellipse.rx = rx;
+    ellipse.ry = ry;
+    return Reshaped(ellipse);
+}
+
+SvgBounds SvgEditor::SetPoints(SvgPolyline &polyline, std::span<const Gdiplus::PointF> points)
+{
+    Reclaimable(polyline.points).assign(points.begin(), points.end());
+    return Reshaped(polyline);
+}
+
+SvgBounds SvgEditor::SetPoints(SvgPolygon &polygon, std::span<const Gdiplus::PointF> points)
+{
+    Reclaimable(polygon.points).assign(points.begin(), points.end());
+    return Reshaped(polygon);
+}
+
+SvgBounds SvgEditor::SetPath(SvgPath &path, std::string_view d)
+{
+    Reclaimable(path.pathData) = ParsePathData(d, &m_pool);
+    return Reshaped(path);
+}
+
+SvgBounds SvgEditor::SetText(SvgText &text, std::wstring_view content)
+{
+    Reclaimable(text.text).assign(content.begin(), content.end());
+    return Reshaped(text);
+}
+
+SvgBounds SvgEditor::MoveText(SvgText &text, float x, float y)
+{
+    text.x = x;
+    text.y = y;
+    return Reshaped(text);
+}
@@ -0,0 +1,99 @@
+#ifndef _SVGEDITOR_H_
+#define _SVGEDITOR_H_
+
+#include "SvgDocument.h"
+#include "SvgScene.h"
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A document that keeps changing after it is loaded, for hosts that update
+// a few attributes of a large drawing (colours, transforms, text) instead
+// of parsing it again. Each setter changes the element in place, brings the
+// scene's copy and bounds up to date, and returns the document-space area
+// to repaint: where the element was, united with where it is now.
+//
+// Elements come from Find; setters take elements of this document only.
+// Paint setters leave groups and uses alone, since these hand their paint
+// down once, at load time (SvgDocument::ResolveStyles), and return an
+// empty area for them. An element that <use>s draw, in <defs>, in a
+// <symbol> or elsewhere, damages every instance of it; one that nothing
+// draws returns an empty area.
+//
+// Edits do not pile up memory. Geometry and text an edit replaces move out
+// of the document's arena, which never frees, into a pool of the editor's
+// own that takes old buffers back. Style records no element uses any more
+// are rewritten with the next new style, so the style table grows only
+// while more distinct styles are in use at once.
+//
+// Not thread-safe: edit and render from one thread. To share a state of
+// the drawing with others, load a separate document and freeze it
+// (SvgSnapshot).
+class SvgEditor
+{
+public:
+    // Takes over document, which a parser must have completed.
+    explicit SvgEditor(SvgDocument &&document);
+
+    SvgEditor(const SvgEditor &) = delete;
+    SvgEditor &operator=(const SvgEditor &) = delete;
+
+    const SvgDocument &GetDocument() const { return m_document; }
+    const SvgScene &GetScene() const { return m_scene; }
+
+    ISvgElement *Find(std::string_view id) { return m_document.FindElement(id); }
+
+    // Colours as written in the file; the element's opacity is applied as
+    // it was at load time. A solid fill replaces a gradient.
+    SvgBounds SetFill(ISvgElement &element, Gdiplus::Color color);
+    SvgBounds SetStroke(ISvgElement &element, Gdiplus::Color color);
+    SvgBounds SetStrokeWidth(ISvgElement &element, float width);
+    // The transform attribute; a use's x, y and viewport still apply.
+    SvgBounds SetTransform(ISvgElement &element, const SvgMatrix &transform);
+
+    SvgBounds SetLine(SvgLine &line, float x1, float y1, float x2, float y2);
+    SvgBounds SetRect(SvgRect &rect, float x, float y, float w, float h);
+    SvgBounds SetCircle(SvgCircle &circle, float cx, float cy, float r);
+    SvgBounds SetEllipse(SvgEllipse &ellipse, float cx, float cy, float rx, float ry);
+    SvgBounds SetPoints(SvgPolyline &polyline, std::span<const Gdiplus::PointF> points);
+    SvgBounds SetPoints(SvgPolygon &polygon, std::span<const Gdiplus::PointF> points);
+    // d is path data as in the d attribute.
+    SvgBounds SetPath(SvgPath &path, std::string_view d);
+    SvgBounds SetText(SvgText &text, std::wstring_view content);
+    SvgBounds MoveText(SvgText &text, float x, float y);
+
+private:
+    // Interns style as element's new record and updates its item.
+    SvgBounds Restyle(ISvgElement &element, const SvgStyle &style);
+    // Updates the items of element, which has just changed, and returns
+    // where they and the uses showing them were and are.
+    SvgBounds Changed(const ISvgElement &element);
+    // Updates the uses whose target holds item and returns the document-
+    // space area they covered before and after.
+    SvgBounds Instanced(uint32_t item);
+    // The same for a change to element's geometry, which moves its fillBox.
+    SvgBounds Reshaped(ISvgElement &element);
+
+    // Hands storage, an element's container, over to m_pool if it is not
+    // there yet.
+    template <typename T>
+    T &Reclaimable(T &storage);
+
+    // Edited geometry and text; declared first, so it goes last.
+    std::pmr::unsynchronized_pool_resource m_pool;
+    // The scene points into the document, so the editor never moves.
+    SvgDocument m_document;
+    SvgScene m_scene;
+    // Drawn items, and the items of use targets, by element.
+    std::unordered_map<const ISvgElement *, uint32_t> m_items;
+    std::unordered_map<const ISvgElement *, uint32_t> m_targetItems;
+    // The uses of each target root item.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_instances;
+    // How many elements use each style record, and records none does.
+    std::vector<uint32_t> m_styleRefs;
+    std::vector<uint32_t> m_freeStyles;
+};
+
+#endif
@@ -1,6 +1,78 @@
 #include "stdafx.h"
 #include "SvgElement.h"
 #include "IRenderer.h"
+#include <algorithm>
+
+Gdiplus::Color ApplyOpacity(Gdiplus::Color c, float opacity)
+{
+    if (opacity < 0.0f)
+        opacity = 0.0f;
+    if (opacity > 1.0f)
+        opacity = 1.0f;
+    // Combine original color alpha with provided opacity multiplicatively
+    float origA = c.GetAlpha() / 255.0f;
+    float finalA = origA * opacity;
+    int alphaInt = static_cast<int>(finalA * 255.0f + 0.5f);
+    if (alphaInt < 0)
+        alphaInt = 0;
+    if (alphaInt > 255)
+        alphaInt = 255;
+    uint8_t alpha = static_cast<uint8_t>(alphaInt);
+    return Gdiplus::Color(alpha, c.GetR(), c.GetG(), c.GetB());
+}
+
+namespace
+{
+    // An element's own paint and opacity win over inherited ones. Its colour
+    // already carries its own opacity (see SvgElementFactory), so an
+    // inherited opacity is applied exactly once, and only when it set none.
+    void ResolvePaint(Color &color, float &opacity, bool hasPaint, bool hasOpacity,
+                      bool inheritsPaint, const Color &paint, bool inheritsOpacity, float inheritedOpacity)
+    {
+        if (!hasOpacity && inheritsOpacity)
+            opacity = inheritedOpacity;
+        if (!hasPaint && inheritsPaint)
+            color = ApplyOpacity(paint, opacity);
+        else if (!hasOpacity && inheritsOpacity)
+            color = ApplyOpacity(color, inheritedOpacity);
+    }
+
+    void ResolveFill(SvgStyle &s, const SvgInheritedStyle &in)
+    {
+        ResolvePaint(s.fillColor, s.fillOpacity, s.hasInputFill, s.hasInputFillOpacity,
+                     in.hasFill, in.fillColor, in.hasFillOpacity, in.fillOpacity);
+    }
+
+    void ResolveStroke(SvgStyle &s, const SvgInheritedStyle &in)
+    {
+        ResolvePaint(s.strokeColor, s.strokeOpacity, s.hasInputStroke, s.hasInputStrokeOpacity,
+                     in.hasStroke, in.strokeColor, in.hasStrokeOpacity, in.strokeOpacity);
+        if (!s.hasInputStrokeWidth && in.hasStrokeWidth)
+            s.strokeWidth = in.strokeWidth;
+    }
+
+    // Marks what s inherited inside a definition as its own; see
+    // SvgInheritedStyle::definition.
+    void ClaimInherited(SvgStyle &s, const SvgInheritedStyle &in, bool fill)
+    {
+        if (fill)
+        {
+            s.hasInputFill |= in.hasFill;
+            s.hasInputFillOpacity |= in.hasFillOpacity;
+        }
+        s.hasInputStroke |= in.hasStroke;
+        s.hasInputStrokeOpacity |= in.hasStrokeOpacity;
+        s.hasInputStrokeWidth |= in.hasStrokeWidth;
+    }
+
+    // Most elements inherit nothing or end up as they were, so the table is
+    // only searched when the record really changes.
+    void Restyle(uint32_t &index, const SvgStyle &resolved, SvgStyleTable &styles)
+    {
+        if (!(resolved == styles[index]))
+            index = styles.Intern(resolved);
+    }
+}
 
 void SvgLine::Draw(IRenderer &renderer) const
 {
@@ -45,3 +117,167 @@ void SvgGroup::Draw(IRenderer &renderer) const
 void SvgPath::Draw(IRenderer& renderer) const {
     renderer.DrawPath(*this);
 }
+
+void SvgUse::Draw(IRenderer &renderer) const
+{
+    renderer.DrawUse(*this);
+}
+
+void InheritPaint(SvgStyle &style, const SvgInheritedStyle &inherited)
+{
+    ResolveFill(style, inherited);
+    ResolveStroke(style, inherited);
+}
+
+SvgInheritedStyle PassPaint(const SvgStyle &style, const SvgInheritedStyle &inherited)
+{
+    SvgInheritedStyle passed = inherited;
+    if (style.hasInputFill)
+    {
+        passed.hasFill = true;
+        passed.fillColor = style.fillColor;
+    }
+    if (style.hasInputStroke)
+    {
+        passed.hasStroke = true;
+        passed.strokeColor = style.strokeColor;
+    }
+    if (style.hasInputStrokeWidth)
+    {
+        passed.hasStrokeWidth = true;
+        passed.strokeWidth = style.strokeWidth;
+    }
+    if (style.hasInputFillOpacity)
+    {
+        passed.hasFillOpacity = true;
+        passed.fillOpacity = style.fillOpacity;
+    }
+    if (style.hasInputStrokeOpacity)
+    {
+        passed.hasStrokeOpacity = true;
+        passed.strokeOpacity = style.strokeOpacity;
+    }
+    return passed;
+}
+
+void ISvgElement::ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles)
+{
+    SvgStyle resolved = styles[style];
+    InheritPaint(resolved, inherited);
+    if (inherited.definition)
+        ClaimInherited(resolved, inherited, true);
+    Restyle(style, resolved, styles);
+}
+
+void SvgLine::ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles)
+{
+    SvgStyle resolved = styles[style];
+    ResolveStroke(resolved, inherited);
+    if (inherited.definition)
+        ClaimInherited(resolved, inherited, false);
+    Restyle(style, resolved, styles);
+}
+
+void SvgGroup::ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles)
+{
+    const SvgInheritedStyle passed = PassPaint(styles[style], inherited);
+    for (auto &child : children)
+        child->ResolveStyle(passed, styles);
+}
+
+void SvgUse::ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles)
+{
+    const SvgInheritedStyle passed = PassPaint(styles[style], inherited);
+    SvgStyle handed = styles[style];
+    handed.hasInputFill = passed.hasFill;
+    handed.fillColor = passed.fillColor;
+    handed.hasInputStroke = passed.hasStroke;
+    handed.strokeColor = passed.strokeColor;
+    handed.hasInputStrokeWidth = passed.hasStrokeWidth;
+    handed.strokeWidth = passed.strokeWidth;
+    handed.hasInputFillOpacity = passed.hasFillOpacity;
+    handed.fillOpacity = passed.fillOpacity;
+    handed.hasInputStrokeOpacity = passed.hasStrokeOpacity;
+    handed.strokeOpacity = passed.strokeOpacity;
+    Restyle(style, handed, styles);
+}
+
+void SvgLine::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = SvgBounds();
+    fillBox.Add(x1, y1);
+    fillBox.Add(x2, y2);
+}
+
+void SvgRect::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = {x, y, x + w, y + h};
+}
+
+void SvgCircle::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = {cx - r, cy - r, cx + r, cy + r};
+}
+
+void SvgEllipse::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = {cx - rx, cy - ry, cx + rx, cy + ry};
+}
+
+void SvgPolyline::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = SvgBounds();
+    for (const PointF &p : points)
+        fillBox.Add(p.X, p.Y);
+}
+
+void SvgPolygon::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = SvgBounds();
+    for (const PointF &p : points)
+        fillBox.Add(p.X, p.Y);
+}
+
+void SvgPath::UpdateFillBox(const SvgStyleTable &)
+{
+    fillBox = pathData.Bounds();
+}
+
+void SvgText::UpdateFillBox(const SvgStyleTable &styles)
+{
+    size_t lines = 1, longest = 0, run = 0;
+    for (wchar_t ch : text)
+    {
+        if (ch == L'\n')
+        {
+            ++lines;
+            longest = (std::max)(longest, run);
+            run = 0;
+        }
+        else
+        {
+            ++run;
+        }
+    }
+    longest = (std::max)(longest, run);
+
+    // Glyphs seldom reach more than an em across, and GdiPlusRenderer puts
+    // the ascent above y and 1.5 em between lines at most; half an em more
+    // all round covers the rest.
+    const SvgStyle &s = styles[style];
+    const float em = s.fontSize;
+    const float width = em * static_cast<float>(longest);
+    float left = x;
+    if (s.textAnchor == SvgTextAnchor::Middle)
+        left -= width * 0.5f;
+    else if (s.textAnchor == SvgTextAnchor::End)
+        left -= width;
+    fillBox = {left - em * 0.5f, y - em * 1.5f, left + width + em * 0.5f,
+               y + em * (1.5f * static_cast<float>(lines - 1) + 0.5f)};
+}
+
+void SvgGroup::UpdateFillBox(const SvgStyleTable &styles)
+{
+    for (ISvgElement *child : children)
+        child->UpdateFillBox(styles);
+}
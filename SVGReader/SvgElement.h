@@ -1,187 +1,243 @@
 #ifndef _SVGELEMENT_H_
 #define _SVGELEMENT_H_
 
-#include <gdiplus.h>
+#include "SvgPlatform.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include "PathData.h"
+#include "SvgArena.h"
+#include "SvgStyle.h"
+#include "SvgTransform.h"
 
 using Gdiplus::Color;
 using Gdiplus::PointF;
 
 class IRenderer;
 
+// Scales the alpha of c by opacity, clamped to [0, 1].
+Gdiplus::Color ApplyOpacity(Gdiplus::Color c, float opacity);
+
+// Paint properties a group hands down to its children: for each one, the
+// value set by the nearest enclosing group that sets it.
+struct SvgInheritedStyle
+{
+    bool hasFill = false;
+    bool hasStroke = false;
+    bool hasStrokeWidth = false;
+    bool hasFillOpacity = false;
+    bool hasStrokeOpacity = false;
+
+    Color fillColor;
+    Color strokeColor;
+    float strokeWidth = 1.0f;
+    float fillOpacity = 1.0f;
+    float strokeOpacity = 1.0f;
+
+    // Inside <defs> or a <symbol>: what the content inherits there counts
+    // as set by itself, so a <use> of it only fills in the rest.
+    bool definition = false;
+};
+
+// Fills in the fill and stroke that style leaves to inheritance from
+// inherited, applying inherited opacity once (see ISvgElement::ResolveStyle).
+void InheritPaint(SvgStyle &style, const SvgInheritedStyle &inherited);
+
+// What a group or <use> with style hands down: the paint it sets itself,
+// over what it inherited.
+SvgInheritedStyle PassPaint(const SvgStyle &style, const SvgInheritedStyle &inherited);
+
+// Elements are created in their document's SvgArena, and everything they
+// own is allocated with the allocator they are constructed with, so the
+// arena can drop them without running destructors. Paint and font
+// properties live in the document's SvgStyleTable; style indexes it.
 class ISvgElement
 {
 public:
+    using allocator_type = SvgArena::allocator_type;
+
+    explicit ISvgElement(const allocator_type & = {}) {}
     virtual ~ISvgElement() {}
-    std::string transformAttribute;
+    SvgMatrix transform;
+    uint32_t style = 0;
+    // Untransformed box of what the element fills, stroke left out: curves
+    // by their extrema, text by an estimate (see SvgText). Groups and uses
+    // keep an empty one; SvgScene gives the extent of those.
+    SvgBounds fillBox;
     virtual void Draw(IRenderer &renderer) const = 0;
 
-    bool hasInputFill = false;
-    bool hasInputStroke = false;
-    bool hasInputStrokeWidth = false;
-    bool hasInputStrokeOpacity = false;
-    bool hasInputFillOpacity = false;
-
-
-    float fillOpacity = 1.0f;
-    float strokeOpacity = 1.0f;
-
-    std::string fillUrl;
+    // Recomputes fillBox from the geometry (and, for text, the font in
+    // styles). Run once on a parsed document (SvgDocument::ResolveBounds)
+    // and again on every element whose geometry changes.
+    virtual void UpdateFillBox(const SvgStyleTable &) {}
+
+    // Folds what the element inherits from its groups into its style,
+    // interning the result in styles, so drawing it needs no context. Run
+    // once on a parsed document (SvgDocument::ResolveStyles); the hasInput
+    // flags keep saying what the element itself set. Elements resolve both
+    // fill and stroke unless they override this.
+    virtual void ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles);
 };
 
 class ISvgShape : public ISvgElement
 {
 public:
+    using ISvgElement::ISvgElement;
     virtual ~ISvgShape() {}
 };
 
 class SvgLine : public ISvgShape
 {
 public:
+    using ISvgShape::ISvgShape;
+
     float x1{}, y1{}, x2{}, y2{};
-    Color strokeColor{255, 0, 0, 0};
-    float strokeWidth{1.0f};
 
     void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
+    // A line has no interior, so only its stroke inherits.
+    void ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles) override;
 };
 
 class SvgRect : public ISvgShape
 {
 public:
+    using ISvgShape::ISvgShape;
+
     float x{}, y{}, w{}, h{};
-    Color fillColor{0, 0, 0, 0};
-    Color strokeColor{255, 0, 0, 0};
-    float strokeWidth{1.0f};
 
     void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
 };
 
 class SvgCircle : public ISvgShape
 {
 public:
+    using ISvgShape::ISvgShape;
+
     float cx{}, cy{}, r{};
-    Color fillColor{0, 0, 0, 0};
-    Color strokeColor{255, 0, 0, 0};
-    float strokeWidth{1.0f};
 
     void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
 };
 
 class SvgEllipse : public ISvgShape
 {
 public:
+    using ISvgShape::ISvgShape;
+
     float cx{}, cy{}, rx{}, ry{};
-    Color fillColor{0, 0, 0, 0};
-    Color strokeColor{255, 0, 0, 0};
-    float strokeWidth{1.0f};
 
     void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
 };
 
 class SvgPolyline : public ISvgShape
 {
 public:
-    std::vector<PointF> points;
-    Color strokeColor{255, 0, 0, 0};
-    float strokeWidth{1.0f};
-    Gdiplus::Color fillColor;
+    explicit SvgPolyline(const allocator_type &alloc = {}) : ISvgShape(alloc), points(alloc) {}
+
+    std::pmr::vector<PointF> points;
+
     void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
 };
 
 class SvgPolygon : public ISvgShape
 {
 public:
-    std::vector<PointF> points;
-    Color fillColor{0, 0, 0, 0};
-    Color strokeColor{255, 0, 0, 0};
-    float strokeWidth{1.0f};
+    explicit SvgPolygon(const allocator_type &alloc = {}) : ISvgShape(alloc), points(alloc) {}
+
+    std::pmr::vector<PointF> points;
 
     void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
 };
 
 class SvgText : public ISvgElement
 {
 public:
+    explicit SvgText(const allocator_type &alloc = {}) : ISvgElement(alloc), text(alloc) {}
+
     float x{}, y{};
-    std::wstring text;
-    std::wstring fontFamily{L"Arial"};
-    float fontSize{16.0f};
-    Color fillColor{255, 0, 0, 0};
-    std::string textAnchor = "start";
-    Color strokeColor{ 0, 0, 0, 0 };
-    float strokeWidth{ 1.0f };
+    std::pmr::wstring text;
+
     void Draw(IRenderer &renderer) const override;
+    // Glyph extents depend on the font, so this is a box one em per
+    // character wide that holds the text in any reasonable font.
+    void UpdateFillBox(const SvgStyleTable &styles) override;
 };
 
 class SvgGroup : public ISvgElement
 {
 public:
-    Gdiplus::Color strokeColor;
-    Gdiplus::Color fillColor;
-    float strokeWidth = 1.0f;
-    float strokeOpacity = 1.0f;
-    float fillOpacity = 1.0f;
+    explicit SvgGroup(const allocator_type &alloc = {}) : ISvgElement(alloc), children(alloc) {}
 
-    std::vector<std::unique_ptr<ISvgElement>> children;
+    // Owned by the document's arena, like the group itself.
+    std::pmr::vector<ISvgElement *> children;
 
-    void AddChild(std::unique_ptr<ISvgElement> child)
+    void AddChild(ISvgElement *child)
     {
-        children.push_back(std::move(child));
+        children.push_back(child);
     }
 
     void Draw(IRenderer &renderer) const override;
+    // Updates the children; the group's own box stays empty.
+    void UpdateFillBox(const SvgStyleTable &styles) override;
+    // The group's style keeps the values set on it; what it passes down is
+    // that merged over what it inherited.
+    void ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles) override;
 };
 
-class SvgPath : public ISvgElement
+// A <symbol>: a group drawn only through uses, each of which fits its
+// viewBox, if it has one, into the viewport the use gives it.
+class SvgSymbol : public SvgGroup
 {
 public:
-    std::unique_ptr<Gdiplus::GraphicsPath> pathData;
+    using SvgGroup::SvgGroup;
 
-    Gdiplus::Color fillColor;
-    Gdiplus::Color strokeColor;
-    float strokeWidth;
+    bool hasViewBox = false;
+    SvgViewBox viewBox;
+};
 
-    SvgPath() = default;
+class SvgPath : public ISvgElement
+{
+public:
+    explicit SvgPath(const allocator_type &alloc = {}) : ISvgElement(alloc), pathData(alloc) {}
 
-    // Custom copy constructor to allow copying SvgPath (deep copy of pathData)
-    SvgPath(const SvgPath &other)
-        : fillColor(other.fillColor),
-          strokeColor(other.strokeColor),
-          strokeWidth(other.strokeWidth)
-    {
-        if (other.pathData)
-        {
-            // GraphicsPath copy ctor is protected; create a new path and copy contents
-            pathData = std::make_unique<Gdiplus::GraphicsPath>();
-            pathData->AddPath(other.pathData.get(), FALSE);
-        }
-        transformAttribute = other.transformAttribute;
-    }
+    PathData pathData;
 
-    SvgPath &operator=(const SvgPath &other)
-    {
-        if (this != &other)
-        {
-            fillColor = other.fillColor;
-            strokeColor = other.strokeColor;
-            strokeWidth = other.strokeWidth;
-            transformAttribute = other.transformAttribute;
-            if (other.pathData)
-            {
-                pathData = std::make_unique<Gdiplus::GraphicsPath>();
-                pathData->AddPath(other.pathData.get(), FALSE);
-            }
-            else
-            {
-                pathData.reset();
-            }
-        }
-        return *this;
-    }
+    void Draw(IRenderer &renderer) const override;
+    void UpdateFillBox(const SvgStyleTable &styles) override;
+};
+
+// A <use>: draws another element of the document, shared with every other
+// use of it, in its own place and with its own paint. Nothing of the target
+// is copied, so an instance costs this record and nothing more.
+class SvgUse : public ISvgElement
+{
+public:
+    using ISvgElement::ISvgElement;
+
+    // Id of the target, interned in the document's SvgStyleTable.
+    uint32_t href = 0;
+    // The viewport a symbol target is fitted into; negative where the file
+    // gives none (100%, the document's size).
+    float width = -1.0f;
+    float height = -1.0f;
+    // What transform holds after the transform attribute: x and y, then,
+    // once the target is known (SvgDocument::ResolveUses), a symbol's
+    // viewBox fitted to width and height.
+    SvgMatrix placement;
+    // Set when the document is complete (SvgDocument::ResolveUses); null if
+    // href names no element, or drawing it would come back to this use.
+    const ISvgElement *target = nullptr;
 
     void Draw(IRenderer &renderer) const override;
+    // Stores what the use hands down to its target (see PassPaint) as its
+    // style; the renderer applies that to the target's own style.
+    void ResolveStyle(const SvgInheritedStyle &inherited, SvgStyleTable &styles) override;
 };
 
 #endif
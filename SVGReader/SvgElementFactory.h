@@ -4,15 +4,29 @@
 #include "stdafx.h"
 #include "SvgElement.h"
 #include "IXMLNode.h"
+#include "SvgStyleSheet.h"
 
+class SvgAttributeTable;
+class SvgDocument;
+
+// Stateless: every method is const and only reads its arguments, so one
+// factory can be shared between threads.
 class SvgElementFactory
 {
 public:
-    std::unique_ptr<ISvgElement> CreateElement(const IXMLNode &node) const;
-    Gdiplus::Color ParseColor(const std::string &value) const;
+    // style supplies the stylesheet and the element's ancestors for the
+    // cascade. The element is created in document's arena with its style
+    // interned in document's table and its id registered, but not added to
+    // it; null if the node is not drawn.
+    ISvgElement *CreateElement(const IXMLNode &node, const SvgStyleContext &style, SvgDocument &document) const;
+    Gdiplus::Color ParseColor(std::string_view value) const;
+    // The paint attrs set, for elements that only hand paint down (groups,
+    // symbols, uses): nothing is defaulted, and colours keep their opacity
+    // apart. See PassPaint.
+    SvgStyle ParsePassedPaint(const SvgAttributeTable &attrs) const;
 
 private:
-    std::vector<Gdiplus::PointF> ParsePoints(const std::string &ptsStr) const;
+    void ParsePoints(std::string_view ptsStr, std::pmr::vector<Gdiplus::PointF> &points) const;
 };
 
 #endif
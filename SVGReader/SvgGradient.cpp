@@ -0,0 +1,78 @@
+#include "stdafx.h"
+#include "SvgGradient.h"
+#include "SoftwareBlend.h"
+#include <algorithm>
+
+namespace
+{
+    uint32_t PremultiplyStop(Gdiplus::Color color, float opacity)
+    {
+        const float alpha = static_cast<float>(color.GetAlpha()) * std::clamp(opacity, 0.0f, 1.0f);
+        return SoftwareBlend::Premultiply(color.GetR(), color.GetG(), color.GetB(),
+                                          static_cast<uint8_t>(alpha + 0.5f));
+    }
+
+    uint32_t Lerp(uint32_t a, uint32_t b, float t)
+    {
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            const float ca = static_cast<float>((a >> shift) & 0xFF);
+            const float cb = static_cast<float>((b >> shift) & 0xFF);
+            out |= static_cast<uint32_t>(ca + (cb - ca) * t + 0.5f) << shift;
+        }
+        return out;
+    }
+
+    void BuildLut(const std::vector<GradientStop> &stops, float opacity, SvgGradientLut &lut)
+    {
+        if (stops.empty())
+        {
+            std::fill_n(lut.colors, SvgGradientLut::kSize, 0u);
+            return;
+        }
+
+        // Offsets never go back (SVG clamps each to the one before).
+        std::vector<float> offsets;
+        std::vector<uint32_t> colors;
+        float last = 0.0f;
+        for (const GradientStop &stop : stops)
+        {
+            last = (std::max)(last, std::clamp(stop.offset, 0.0f, 1.0f));
+            offsets.push_back(last);
+            colors.push_back(PremultiplyStop(stop.color, opacity));
+        }
+
+        // Entries go up in t, so the stop pair only ever moves forward.
+        size_t next = 0;
+        for (int i = 0; i < SvgGradientLut::kSize; ++i)
+        {
+            const float t = static_cast<float>(i) / (SvgGradientLut::kSize - 1);
+            while (next < offsets.size() && t >= offsets[next])
+                ++next;
+            if (next == 0)
+                lut.colors[i] = colors.front();
+            else if (next == offsets.size())
+                lut.colors[i] = colors.back();
+            else
+            {
+                const float span = offsets[next] - offsets[next - 1];
+                lut.colors[i] = Lerp(colors[next - 1], colors[next], (t - offsets[next - 1]) / span);
+            }
+        }
+    }
+}
+
+const SvgGradientLut &SvgGradient::GetLut(float opacity) const
+{
+    std::lock_guard<std::mutex> lock(lutMutex);
+    for (const auto &entry : luts)
+    {
+        if (entry.first == opacity)
+            return *entry.second;
+    }
+    auto lut = std::make_unique<SvgGradientLut>();
+    BuildLut(stops, opacity, *lut);
+    luts.emplace_back(opacity, std::move(lut));
+    return *luts.back().second;
+}
@@ -1,8 +1,13 @@
 #ifndef _SVGGRADIENT_H_
 #define _SVGGRADIENT_H_
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
-#include <gdiplus.h>
+#include "SvgPlatform.h"
+#include "SvgTransform.h"
 
 enum class GradientType
 {
@@ -16,6 +21,14 @@ struct GradientStop
     Gdiplus::Color color;
 };
 
+// A gradient's colours at 256 evenly spaced points of t over [0, 1],
+// premultiplied, packed with R in the lowest byte as SoftwarePixmap is.
+struct SvgGradientLut
+{
+    static constexpr int kSize = 256;
+    uint32_t colors[kSize];
+};
+
 class SvgGradient
 {
 public:
@@ -24,13 +37,23 @@ public:
     std::string id;
     GradientType type;
     std::string gradientUnits = "objectBoundingBox";
-    std::string gradientTransform;
+    SvgMatrix gradientTransform;
+    bool hasGradientTransform = false;
     std::string spreadMethod = "pad";
     std::string href;
     std::vector<GradientStop> stops;
 
+    // The stops sampled into a table, every alpha scaled by opacity. Built
+    // on the first call for each opacity and kept with the gradient, so
+    // the stops must be final by then; safe from several threads.
+    const SvgGradientLut &GetLut(float opacity) const;
+
 protected:
     SvgGradient(GradientType t) : type(t) {}
+
+private:
+    mutable std::mutex lutMutex;
+    mutable std::vector<std::pair<float, std::unique_ptr<SvgGradientLut>>> luts;
 };
 
 class SvgRadialGradient : public SvgGradient
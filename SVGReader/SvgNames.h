@@ -0,0 +1,245 @@
+#ifndef _SVGNAMES_H_
+#define _SVGNAMES_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Element names the parser dispatches on.
+enum class SvgTag : uint8_t
+{
+    Unknown,
+    Svg,
+    G,
+    Defs,
+    Line,
+    Rect,
+    Circle,
+    Ellipse,
+    Polyline,
+    Polygon,
+    Text,
+    Path,
+    LinearGradient,
+    RadialGradient,
+    Stop,
+    Style,
+    Symbol,
+    Use
+};
+
+// Attribute (and style property) names the parser reads. Count doubles as
+// "not a known attribute" and as the size of per-node slot tables.
+enum class SvgAttr : uint8_t
+{
+    Id,
+    Class,
+    Style,
+    Transform,
+    Display,
+    Fill,
+    FillOpacity,
+    FillRule,
+    Stroke,
+    StrokeOpacity,
+    StrokeWidth,
+    Opacity,
+    X,
+    Y,
+    Width,
+    Height,
+    X1,
+    Y1,
+    X2,
+    Y2,
+    Cx,
+    Cy,
+    R,
+    Rx,
+    Ry,
+    Fx,
+    Fy,
+    D,
+    Points,
+    FontFamily,
+    FontSize,
+    TextAnchor,
+    Offset,
+    StopColor,
+    StopOpacity,
+    GradientUnits,
+    GradientTransform,
+    SpreadMethod,
+    Href,
+    XlinkHref,
+    ViewBox,
+    PreserveAspectRatio,
+    Count
+};
+
+namespace SvgNames
+{
+    // FNV-1a, seeded so the perfect-hash builder can search for a seed.
+    constexpr uint32_t Hash(std::string_view s, uint32_t seed)
+    {
+        uint32_t h = 2166136261u ^ seed;
+        for (char c : s)
+        {
+            h ^= static_cast<uint8_t>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    template <typename Enum>
+    struct NameEntry
+    {
+        std::string_view name;
+        Enum value;
+    };
+
+    // Perfect hash over a fixed set of names. The seed is searched at compile
+    // time until every name owns its own slot, so a lookup is one hash, one
+    // table read and one string compare.
+    template <typename Enum, size_t N, unsigned Bits>
+    class PerfectHashMap
+    {
+    public:
+        consteval PerfectHashMap(const NameEntry<Enum> (&entries)[N])
+        {
+            for (size_t i = 0; i < N; ++i)
+                m_entries[i] = entries[i];
+
+            for (uint32_t seed = 1; seed < 100000; ++seed)
+            {
+                std::array<uint8_t, kSlots> slots{};
+                bool collision = false;
+                for (size_t i = 0; i < N && !collision; ++i)
+                {
+                    uint8_t &slot = slots[SlotOf(entries[i].name, seed)];
+                    if (slot != 0)
+                        collision = true;
+                    else
+                        slot = static_cast<uint8_t>(i + 1);
+                }
+                if (!collision)
+                {
+                    m_seed = seed;
+                    m_slots = slots;
+                    return;
+                }
+            }
+            throw "no perfect hash seed found; increase Bits";
+        }
+
+        constexpr Enum Find(std::string_view name, Enum notFound) const
+        {
+            uint8_t slot = m_slots[SlotOf(name, m_seed)];
+            if (slot == 0 || m_entries[slot - 1].name != name)
+                return notFound;
+            return m_entries[slot - 1].value;
+        }
+
+    private:
+        static_assert(N < 255, "slot indices are stored in a byte");
+        static constexpr size_t kSlots = size_t(1) << Bits;
+
+        static constexpr size_t SlotOf(std::string_view name, uint32_t seed)
+        {
+            return Hash(name, seed) >> (32 - Bits);
+        }
+
+        std::array<NameEntry<Enum>, N> m_entries{};
+        std::array<uint8_t, kSlots> m_slots{};
+        uint32_t m_seed = 0;
+    };
+
+    template <typename Enum, unsigned Bits, size_t N>
+    consteval PerfectHashMap<Enum, N, Bits> MakePerfectHashMap(const NameEntry<Enum> (&entries)[N])
+    {
+        return PerfectHashMap<Enum, N, Bits>(entries);
+    }
+
+    inline constexpr auto kTags = MakePerfectHashMap<SvgTag, 6>({
+        {"svg", SvgTag::Svg},
+        {"g", SvgTag::G},
+        {"defs", SvgTag::Defs},
+        {"line", SvgTag::Line},
+        {"rect", SvgTag::Rect},
+        {"circle", SvgTag::Circle},
+        {"ellipse", SvgTag::Ellipse},
+        {"polyline", SvgTag::Polyline},
+        {"polygon", SvgTag::Polygon},
+        {"text", SvgTag::Text},
+        {"path", SvgTag::Path},
+        {"linearGradient", SvgTag::LinearGradient},
+        {"radialGradient", SvgTag::RadialGradient},
+        {"stop", SvgTag::Stop},
+        {"style", SvgTag::Style},
+        {"symbol", SvgTag::Symbol},
+        {"use", SvgTag::Use},
+    });
+
+    inline constexpr auto kAttrs = MakePerfectHashMap<SvgAttr, 8>({
+        {"id", SvgAttr::Id},
+        {"class", SvgAttr::Class},
+        {"style", SvgAttr::Style},
+        {"transform", SvgAttr::Transform},
+        {"display", SvgAttr::Display},
+        {"fill", SvgAttr::Fill},
+        {"fill-opacity", SvgAttr::FillOpacity},
+        {"fill-rule", SvgAttr::FillRule},
+        {"stroke", SvgAttr::Stroke},
+        {"stroke-opacity", SvgAttr::StrokeOpacity},
+        {"stroke-width", SvgAttr::StrokeWidth},
+        {"opacity", SvgAttr::Opacity},
+        {"x", SvgAttr::X},
+        {"y", SvgAttr::Y},
+        {"width", SvgAttr::Width},
+        {"height", SvgAttr::Height},
+        {"x1", SvgAttr::X1},
+        {"y1", SvgAttr::Y1},
+        {"x2", SvgAttr::X2},
+        {"y2", SvgAttr::Y2},
+        {"cx", SvgAttr::Cx},
+        {"cy", SvgAttr::Cy},
+        {"r", SvgAttr::R},
+        {"rx", SvgAttr::Rx},
+        {"ry", SvgAttr::Ry},
+        {"fx", SvgAttr::Fx},
+        {"fy", SvgAttr::Fy},
+        {"d", SvgAttr::D},
+        {"points", SvgAttr::Points},
+        {"font-family", SvgAttr::FontFamily},
+        {"font-size", SvgAttr::FontSize},
+        {"text-anchor", SvgAttr::TextAnchor},
+        {"offset", SvgAttr::Offset},
+        {"stop-color", SvgAttr::StopColor},
+        {"stop-opacity", SvgAttr::StopOpacity},
+        {"gradientUnits", SvgAttr::GradientUnits},
+        {"gradientTransform", SvgAttr::GradientTransform},
+        {"spreadMethod", SvgAttr::SpreadMethod},
+        {"href", SvgAttr::Href},
+        {"xlink:href", SvgAttr::XlinkHref},
+        {"viewBox", SvgAttr::ViewBox},
+        {"preserveAspectRatio", SvgAttr::PreserveAspectRatio},
+    });
+}
+
+constexpr SvgTag LookupSvgTag(std::string_view name)
+{
+    return SvgNames::kTags.Find(name, SvgTag::Unknown);
+}
+
+constexpr SvgAttr LookupSvgAttr(std::string_view name)
+{
+    return SvgNames::kAttrs.Find(name, SvgAttr::Count);
+}
+
+static_assert(LookupSvgTag("radialGradient") == SvgTag::RadialGradient);
+static_assert(LookupSvgTag("radialgradient") == SvgTag::Unknown);
+static_assert(LookupSvgAttr("stroke-width") == SvgAttr::StrokeWidth);
+static_assert(LookupSvgAttr("stroke-widths") == SvgAttr::Count);
+
+#endif
@@ -0,0 +1,136 @@
+#include "stdafx.h"
+#include "SvgNumber.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+    bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+    bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    constexpr double kPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+        1e21, 1e22};
+
+    // Clinger's fast path: when the mantissa and the power of ten are both
+    // exact doubles, one multiply or divide gives the correctly rounded
+    // double. Narrowing that to float is only wrong when the double lands
+    // exactly halfway between two floats (the 29 bits a float drops are
+    // 1000...0), so those are left to from_chars along with everything else
+    // outside the fast path.
+    bool FastPath(uint64_t mantissa, int exponent, float &out)
+    {
+        if (mantissa == 0)
+        {
+            out = 0.0f;
+            return true;
+        }
+        if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+            return false;
+
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kPowersOfTen[-exponent] : value * kPowersOfTen[exponent];
+
+        if ((std::bit_cast<uint64_t>(value) & 0x1FFFFFFF) == 0x10000000)
+            return false;
+        out = static_cast<float>(value);
+        return true;
+    }
+}
+
+bool SvgNumber::Parse(std::string_view &text, float &out)
+{
+    const char *p = text.data();
+    const char *const end = p + text.size();
+    while (p < end && IsSpace(*p))
+        ++p;
+
+    const char *const start = p;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+        negative = *p++ == '-';
+
+    // The digits are gathered while scanning so the common case never has
+    // to look at the text twice. More than 19 of them could overflow the
+    // mantissa; those numbers take the slow path below.
+    uint64_t mantissa = 0;
+    const char *const intStart = p;
+    while (p < end && IsDigit(*p))
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p++ - '0');
+    size_t digits = p - intStart;
+    int exponent = 0;
+
+    if (p < end && *p == '.')
+    {
+        const char *const fracStart = ++p;
+        while (p < end && IsDigit(*p))
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p++ - '0');
+        const size_t fracDigits = p - fracStart;
+        digits += fracDigits;
+        exponent = -static_cast<int>((std::min)(fracDigits, size_t(1000)));
+    }
+    if (digits == 0)
+        return false;
+
+    // Only take the exponent if it has digits, so "1em" reads as 1.
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *q = p + 1;
+        bool expNegative = false;
+        if (q < end && (*q == '+' || *q == '-'))
+            expNegative = *q++ == '-';
+        const char *const expStart = q;
+        int value = 0;
+        while (q < end && IsDigit(*q))
+        {
+            if (value < 100000)
+                value = value * 10 + (*q - '0');
+            ++q;
+        }
+        if (q > expStart)
+        {
+            exponent += expNegative ? -value : value;
+            p = q;
+        }
+    }
+
+    float value = 0.0f;
+    if (digits <= 19 && FastPath(mantissa, exponent, value))
+    {
+        if (negative)
+            value = -value;
+    }
+    else
+    {
+        // from_chars does not take a leading '+'.
+        const char *first = start;
+        if (*first == '+')
+            ++first;
+        auto [ptr, ec] = std::from_chars(first, p, value, std::chars_format::general);
+        if (ec != std::errc())
+            return false;
+    }
+
+    out = value;
+    text.remove_prefix(p - text.data());
+    return true;
+}
+
+float SvgNumber::ParseOr(std::string_view text, float def)
+{
+    float value = def;
+    return Parse(text, value) ? value : def;
+}
+
+bool SvgNumberList::Next(float &out)
+{
+    size_t i = 0;
+    while (i < m_rest.size() && (IsSpace(m_rest[i]) || m_rest[i] == ','))
+        ++i;
+    m_rest.remove_prefix(i);
+    return SvgNumber::Parse(m_rest, out);
+}
@@ -0,0 +1,42 @@
+#ifndef _SVGNUMBER_H_
+#define _SVGNUMBER_H_
+
+#include <string_view>
+
+// Locale-independent parsing of SVG numbers straight from the attribute
+// bytes. Nothing here allocates, so it is cheap enough to call per value.
+//
+// The grammar is the SVG one: [+-] (digits [. digits] | . digits)
+// [(e|E) [+-] digits]. A number ends at the first character that cannot
+// continue it, which is how "10-5" or "0.5.5" split into two numbers.
+namespace SvgNumber
+{
+    // Skips leading whitespace and parses one number. On success removes
+    // both from the front of text and returns true; otherwise leaves text
+    // and out untouched.
+    bool Parse(std::string_view &text, float &out);
+
+    // The leading number of text, or def if it does not start with one.
+    // Whatever follows the number (a unit, '%') is ignored.
+    float ParseOr(std::string_view text, float def);
+}
+
+// Walks a comma/whitespace separated list such as a points attribute or
+// the arguments of a transform function.
+class SvgNumberList
+{
+public:
+    explicit SvgNumberList(std::string_view text) : m_rest(text) {}
+
+    // Reads the next number. Returns false at the end of the list or at the
+    // first thing that is not a number.
+    bool Next(float &out);
+
+    // What is left after the numbers read so far.
+    std::string_view Rest() const { return m_rest; }
+
+private:
+    std::string_view m_rest;
+};
+
+#endif
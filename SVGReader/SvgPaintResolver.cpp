@@ -1,489 +1,162 @@
 #include "stdafx.h"
 #include "SvgPaintResolver.h"
-#include <vector>
+#include "SoftwarePaint.h"
+#include "SvgTransform.h"
 #include <algorithm>
 #include <cmath>
-#include <sstream>
+#include <limits>
+#include <vector>
 
 using namespace Gdiplus;
 
 namespace {
 
-    // Helper: Apply opacity to color
-    Color ApplyColorOpacity(Color c, float opacity)
+    // Most steps a ramp takes, however many periods of a reflected or
+    // repeated gradient it spans.
+    constexpr int kMaxRampSteps = 2048;
+
+    // Helper: SoftwarePaint's premultiplied RGBA back to a GDI+ colour
+    Color Unpremultiply(uint32_t pixel)
     {
-        if (opacity < 0.0f) opacity = 0.0f;
-        if (opacity > 1.0f) opacity = 1.0f;
-        float origA = c.GetAlpha() / 255.0f;
-        float finalA = origA * opacity;
-        return Color(static_cast<BYTE>(finalA * 255.0f + 0.5f), c.GetR(), c.GetG(), c.GetB());
+        const int a = pixel >> 24;
+        if (a == 0)
+            return Color(0, 0, 0, 0);
+        auto channel = [&](int shift) {
+            return static_cast<BYTE>((std::min)((static_cast<int>((pixel >> shift) & 0xFF) * 255 + a / 2) / a, 255));
+        };
+        return Color(static_cast<BYTE>(a), channel(0), channel(8), channel(16));
     }
 
-    // Helper: Parse Transform
-    void ParseTransform(const std::string &xform, Matrix *result)
+    // Helper: device box of an element-space rectangle
+    SvgBounds DeviceBox(const RectF &rect, const SvgMatrix &toDevice)
     {
-        size_t pos = 0;
-        while (pos < xform.size())
-        {
-            while (pos < xform.size() && isspace(static_cast<unsigned char>(xform[pos])))
-                ++pos;
-            if (pos >= xform.size())
-                break;
-            size_t funcStart = pos;
-            while (pos < xform.size() && isalpha(static_cast<unsigned char>(xform[pos])))
-                ++pos;
-            std::string func = xform.substr(funcStart, pos - funcStart);
-            while (pos < xform.size() && xform[pos] != '(')
-                ++pos;
-            if (pos >= xform.size())
-                break;
-            ++pos;
-            size_t closePos = xform.find(')', pos);
-            if (closePos == std::string::npos)
-                break;
-            std::string args = xform.substr(pos, closePos - pos);
-            pos = closePos + 1;
-            std::replace(args.begin(), args.end(), ',', ' ');
-            std::stringstream ss(args);
-            ss.imbue(std::locale::classic());
-            std::vector<float> vals;
-            float v;
-            while (ss >> v)
-                vals.push_back(v);
+        SvgBounds box;
+        box.Add(rect.X, rect.Y);
+        box.Add(rect.X + rect.Width, rect.Y + rect.Height);
+        return box.Transformed(toDevice);
+    }
 
-            Gdiplus::Matrix m;
-            if (func == "matrix" && vals.size() >= 6)
-            {
-                m.SetElements(vals[0], vals[1], vals[2], vals[3], vals[4], vals[5]);
-            }
-            else if (func == "scale")
-            {
-                float sx = vals.size() > 0 ? vals[0] : 1.0f;
-                float sy = vals.size() > 1 ? vals[1] : sx;
-                m.Scale(sx, sy);
-            }
-            else if (func == "rotate" && vals.size() > 0)
-            {
-                float angle = vals[0];
-                float cx = vals.size() > 1 ? vals[1] : 0.0f;
-                float cy = vals.size() > 2 ? vals[2] : 0.0f;
-                if (cx != 0.0f || cy != 0.0f) { m.Translate(cx, cy); m.Rotate(angle); m.Translate(-cx, -cy); }
-                else { m.Rotate(angle); }
-            }
-            else if (func == "translate" && vals.size() >= 1)
-            {
-                float tx = vals[0];
-                float ty = vals.size() > 1 ? vals[1] : 0.0f;
-                m.Translate(tx, ty);
-            }
-            else if (func == "skewX" && vals.size() >= 1)
-            {
-                m.Shear(std::tan(vals[0] * 3.14159265f / 180.0f), 0.0f);
-            }
-            else if (func == "skewY" && vals.size() >= 1)
-            {
-                m.Shear(0.0f, std::tan(vals[0] * 3.14159265f / 180.0f));
-            }
-            result->Multiply(&m, MatrixOrderAppend);
+    // Helper: the paint's colours for t from t0 to t1, at positions 0 to
+    // 1, a step per colour table entry. A padded ramp only steps through
+    // [0, 1], which has to meet [t0, t1], and holds its end colours beyond.
+    void Ramp(const SoftwarePaint &paint, float t0, float t1, std::vector<Color> &colors, std::vector<REAL> &positions)
+    {
+        auto add = [&](float t) {
+            colors.push_back(Unpremultiply(paint.GetColor(t)));
+            positions.push_back((t - t0) / (t1 - t0));
+        };
+        const float first = paint.IsPadded() ? (std::max)(t0, 0.0f) : t0;
+        const float last = paint.IsPadded() ? (std::min)(t1, 1.0f) : t1;
+        if (first > t0)
+            add(t0);
+        if (first < last)
+        {
+            const float span = std::ceil((last - first) * (SvgGradientLut::kSize - 1));
+            const int steps = (std::max)(static_cast<int>((std::min)(span, static_cast<float>(kMaxRampSteps))), 1);
+            for (int i = 0; i <= steps; ++i)
+                add(first + (last - first) * static_cast<float>(i) / static_cast<float>(steps));
         }
+        if (last < t1)
+            add(t1);
+        positions.front() = 0.0f;
+        positions.back() = 1.0f;
     }
 }
 
-std::unique_ptr<Brush> SvgPaintResolver::CreateBrush(const std::shared_ptr<SvgGradient> &gradient, const RectF &bounds, float opacity)
+std::unique_ptr<Brush> SvgPaintResolver::CreateBrush(const Graphics &graphics, const SvgGradient &gradient,
+                                                     const RectF &bounds, float opacity)
 {
-    if (!gradient) return nullptr;
-
-    const bool isObjectBBox = (gradient->gradientUnits != "userSpaceOnUse");
-
-    // Validate bounds globaly to prevent NaN/Inf issues for BOTH Radial and Linear
-    if (!std::isfinite(bounds.Width) || !std::isfinite(bounds.Height)) 
+    // Validate bounds globaly to prevent NaN/Inf issues
+    if (!std::isfinite(bounds.Width) || !std::isfinite(bounds.Height))
          return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
 
-    if (isObjectBBox && (bounds.Width <= 0.0f || bounds.Height <= 0.0f))
-         return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-    // Helper to map units to pixels
-    auto MapPoint = [&](float x, float y) -> PointF {
-        if (isObjectBBox) {
-            return PointF(bounds.X + x * bounds.Width, bounds.Y + y * bounds.Height);
-        }
-        return PointF(x, y);
-    };
-
-    // Calculate T_grad (Gradient Matrix)
-    Matrix gradMatrix;
-    if (!gradient->gradientTransform.empty())
-    {
-        ParseTransform(gradient->gradientTransform, &gradMatrix);
-        
-        // Validate Matrix Elements
-        REAL m[6];
-        gradMatrix.GetElements(m);
-        for(int i=0; i<6; ++i) {
-             if (!std::isfinite(m[i])) {
-                 // Invalid matrix
-                 return std::make_unique<SolidBrush>(Color(255, 0, 0, 0)); // Return transparent
-             }
-        }
-    }
-
-    if (gradient->type == GradientType::Radial)
+    Matrix world;
+    graphics.GetTransform(&world);
+    REAL m[6];
+    world.GetElements(m);
+    const SvgMatrix toDevice{m[0], m[1], m[2], m[3], m[4], m[5]};
+
+    SvgBounds box;
+    box.Add(bounds.X, bounds.Y);
+    box.Add(bounds.X + bounds.Width, bounds.Y + bounds.Height);
+    const SoftwarePaint paint = SoftwarePaint::FromGradient(gradient, box, toDevice, opacity);
+    if (paint.IsSolid())
+        return std::make_unique<SolidBrush>(Unpremultiply(paint.GetColor()));
+
+    // The device pixels both the shape and the clip reach, and one more
+    // each way for antialiased edges.
+    RectF clip;
+    graphics.GetVisibleClipBounds(&clip);
+    const SvgBounds shape = DeviceBox(bounds, toDevice);
+    const SvgBounds visible = DeviceBox(clip, toDevice);
+    const float left = std::floor((std::max)(shape.minX, visible.minX)) - 1.0f;
+    const float top = std::floor((std::max)(shape.minY, visible.minY)) - 1.0f;
+    const float right = std::ceil((std::min)(shape.maxX, visible.maxX)) + 1.0f;
+    const float bottom = std::ceil((std::min)(shape.maxY, visible.maxY)) + 1.0f;
+    if (!(left < right && top < bottom) || !std::isfinite(right - left) || !std::isfinite(bottom - top))
+        return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
+
+    // The range of t over those pixels: a linear t is affine, so it is
+    // widest at the corners; the points a radial t stays under are a disc
+    // around the focal point, which holds the box if it holds the corners.
+    const float inf = std::numeric_limits<float>::infinity();
+    float t0 = paint.IsRadial() ? 0.0f : inf, t1 = -inf;
+    for (const float x : {left, right})
     {
-        auto radialGrad = std::dynamic_pointer_cast<SvgRadialGradient>(gradient);
-        if (!radialGrad) return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-        float cx = radialGrad->cx;
-        float cy = radialGrad->cy;
-        float r = radialGrad->r;
-        float fx = radialGrad->hasFx ? radialGrad->fx : cx;
-        float fy = radialGrad->hasFy ? radialGrad->fy : cy;
-
-        if (!std::isfinite(cx) || !std::isfinite(cy) || !std::isfinite(r) || !std::isfinite(fx) || !std::isfinite(fy))
-             return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-        if (r <= 1e-6) return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-        int n = static_cast<int>(radialGrad->stops.size());
-        if (n == 0) return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-        // Prepare Colors first
-        std::vector<Color> colors;
-        std::vector<REAL> positions;
-        colors.reserve(n);
-        positions.reserve(n);
-
-        // Iterate backwards from Stop 1 down to Stop 0
-        for (int i = n - 1; i >= 0; --i)
-        {
-            colors.push_back(ApplyColorOpacity(radialGrad->stops[i].color, opacity));
-            positions.push_back(1.0f - radialGrad->stops[i].offset);
-        }
-        
-        // Ensure boundaries 0.0 and 1.0 exist for GDI validity
-        if (positions.front() > 0.001f) {
-            colors.insert(colors.begin(), colors.front());
-            positions.insert(positions.begin(), 0.0f);
-            ++n;
-        }
-        if (positions.back() < 0.999f) {
-            colors.push_back(colors.back());
-            positions.push_back(1.0f);
-            ++n;
-        }
-
-        // Resolution Optimization: 512x512 is sufficient for high quality and performance
-        int texSize = 512;
-
-        // Texture Mapping Approach for Radial Gradient
-        Bitmap tex(texSize, texSize, PixelFormat32bppARGB);
-        if (tex.GetLastStatus() != Ok) {
-             return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-        }
+        for (const float y : {top, bottom})
         {
-            Graphics g(&tex);
-            g.SetSmoothingMode(SmoothingModeAntiAlias);
-            
-            // For 'pad' (default), we want the area OUTSIDE the definition to be the end color.
-            // SVG Stop 1 (Edge) corresponds to our `colors.front()` (Position 0.0f in GDI Edge).
-            Color edgeColor = colors.front();
-            if (radialGrad->spreadMethod == "pad" || radialGrad->spreadMethod == "")
-                g.Clear(edgeColor); 
-            else
-                g.Clear(Color(0,0,0,0)); 
-
-            // Draw gradient in the center of the bitmap
-            GraphicsPath path;
-            RectF rect(0, 0, (REAL)texSize, (REAL)texSize);
-            path.AddEllipse(rect);
-            
-            PathGradientBrush pgb(&path);
-            pgb.SetCenterPoint(PointF(texSize/2.0f, texSize/2.0f));
-
-            // Adjust focus point
-            // Map (fx-cx)/r to bitmap space.
-            float relFx = (fx - cx) / r;
-            float relFy = (fy - cy) / r;
-            // Clamp focus to be inside
-            float dist = sqrt(relFx*relFx + relFy*relFy);
-            if(dist > 0.99f){
-                relFx *= 0.99f/dist;
-                relFy *= 0.99f/dist;
-            }
-            PointF centerP(texSize/2.0f + relFx * texSize/2.0f, texSize/2.0f + relFy * texSize/2.0f);
-            pgb.SetCenterPoint(centerP);
-
-            pgb.SetCenterColor(colors.back()); // GDI Center (t=1.0) is SVG Start (s=0)
-            
-            std::unique_ptr<Color[]> colorArr(new Color[n]);
-            std::unique_ptr<REAL[]> posArr(new REAL[n]);
-            for(int i=0; i<n; ++i) {
-                 colorArr[i] = colors[i];
-                 posArr[i] = positions[i];
-            }
-            pgb.SetInterpolationColors(colorArr.get(), posArr.get(), n);
-            // pgb.SetGammaCorrection(TRUE); // Disabled for sRGB accuracy
-            
-            // Fill the texture
-            g.FillRectangle(&pgb, rect);
+            const float t = paint.GetT(x, y);
+            t0 = (std::min)(t0, t);
+            t1 = (std::max)(t1, t);
         }
-
-        // 2 Create TextureBrush
-        TextureBrush *tb = new TextureBrush(&tex);
-        
-        // 3. Configure WrapMode
-        if (radialGrad->spreadMethod == "reflect")
-             tb->SetWrapMode(WrapModeTileFlipXY);
-        else if (radialGrad->spreadMethod == "repeat")
-             tb->SetWrapMode(WrapModeTile);
-        else
-             tb->SetWrapMode(WrapModeClamp); // Clamp extends edgeColor for 'pad'
-
-        // 4. Calculate Final Transform Matrix
-        Matrix m;
-        m.Translate(-texSize/2.0f, -texSize/2.0f, MatrixOrderAppend);
-        float scaleFactor = 2.0f * r / (float)texSize;
-        m.Scale(scaleFactor, scaleFactor, MatrixOrderAppend);
-        m.Translate(cx, cy, MatrixOrderAppend);
-        
-        m.Multiply(&gradMatrix, MatrixOrderAppend);
-        
-        if (isObjectBBox) {
-            Matrix t_bbox;
-            t_bbox.Scale(bounds.Width, bounds.Height);
-            t_bbox.Translate(bounds.X, bounds.Y, MatrixOrderAppend);
-            m.Multiply(&t_bbox, MatrixOrderAppend);
-        }
-
-        tb->SetTransform(&m);
-        return std::unique_ptr<Brush>(tb);
     }
-    else // Linear Gradient
+    if (!std::isfinite(t0) || !std::isfinite(t1))
+        return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
+    // All of it on one side of a padded gradient, or too thin to vary.
+    if ((paint.IsPadded() && (t1 <= 0.0f || t0 >= 1.0f)) || !(t1 - t0 > 1e-6f))
+        return std::make_unique<SolidBrush>(Unpremultiply(paint.GetColor(0.5f * (t0 + t1))));
+
+    // GDI+ interpolates the ramp itself, so the brush holds a few thousand
+    // colours at most instead of a bitmap of the pixels it covers.
+    std::vector<Color> colors;
+    std::vector<REAL> positions;
+    Ramp(paint, t0, t1, colors, positions);
+    const INT count = static_cast<INT>(colors.size());
+
+    // The paint's frame -> device -> the space drawn in.
+    Matrix fromDevice(m[0], m[1], m[2], m[3], m[4], m[5]);
+    if (fromDevice.Invert() != Ok)
+        return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
+    const SvgMatrix &frame = paint.GetFrame();
+    Matrix placement(frame.a, frame.b, frame.c, frame.d, frame.e, frame.f);
+    placement.Multiply(&fromDevice, MatrixOrderAppend);
+
+    if (!paint.IsRadial())
     {
-        auto linearGrad = std::dynamic_pointer_cast<SvgLinearGradient>(gradient);
-        if (!linearGrad) return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-        PointF p1(linearGrad->x1, linearGrad->y1);
-        PointF p2(linearGrad->x2, linearGrad->y2);
-        
-        // Validate Points
-        if (!std::isfinite(p1.X) || !std::isfinite(p1.Y) || !std::isfinite(p2.X) || !std::isfinite(p2.Y))
-             return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-        
-        if (std::abs(p1.X - p2.X) < 1e-5 && std::abs(p1.Y - p2.Y) < 1e-5)
-        {
-             if (!linearGrad->stops.empty())
-                 return std::make_unique<SolidBrush>(ApplyColorOpacity(linearGrad->stops.back().color, opacity));
-             return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-        }
-
-        int n = static_cast<int>(linearGrad->stops.size());
-        if (n == 0) return std::make_unique<SolidBrush>(Color(0, 0, 0, 0));
-
-        // Determine t-range for Pad method to cover the object
-        float min_t = 0.0f;
-        float max_t = 1.0f;
-
-        if (linearGrad->spreadMethod == "pad" || linearGrad->spreadMethod == "")
-        {
-            // Project Object Bounds onto Gradient Vector to find needed coverage
-            std::vector<PointF> corners;
-            if (isObjectBBox) {
-                // Gradient Space is Unit Space 0..1
-                corners = {PointF(0,0), PointF(1,0), PointF(1,1), PointF(0,1)};
-            } else {
-                // Gradient Space is World Space (unless T_grad exists)
-                // If T_grad exists, we need to map World Bounds -> Gradient Space
-                // P_grad = Inv(T_grad) * P_world
-                corners = {PointF(bounds.X, bounds.Y), PointF(bounds.X + bounds.Width, bounds.Y),
-                           PointF(bounds.X + bounds.Width, bounds.Y + bounds.Height), PointF(bounds.X, bounds.Y + bounds.Height)};
-                
-                if (!gradient->gradientTransform.empty()) {
-                    Matrix invGradMatrix;
-                    ParseTransform(gradient->gradientTransform, &invGradMatrix);
-                    invGradMatrix.Invert();
-                    
-                    // Transform corners
-                    for(auto& pt : corners) {
-                        PointF pts[1] = {pt};
-                        invGradMatrix.TransformPoints(pts, 1);
-                        pt = pts[0];
-                    }
-                }
-            }
-            
-            float dx = p2.X - p1.X;
-            float dy = p2.Y - p1.Y;
-            float lenSq = dx*dx + dy*dy;
-            
-            if (lenSq > 1e-9) {
-                float minVal = 1e9f;
-                float maxVal = -1e9f;
-                for(const auto& pt : corners) {
-                    // Dot product relative to P1: t = (P-P1).V / |V|^2
-                    float t = ((pt.X - p1.X) * dx + (pt.Y - p1.Y) * dy) / lenSq;
-                    if (t < minVal) minVal = t;
-                    if (t > maxVal) maxVal = t;
-                }
-                // Add slight margin
-                minVal -= 0.01f;
-                maxVal += 0.01f;
-
-                if (minVal < min_t) min_t = minVal;
-                if (maxVal > max_t) max_t = maxVal;
-            }
-        }
-        
-        // Safety Clamping to prevent huge textures (e.g. if projection sends t to infinity)
-        if (min_t < -50.0f) min_t = -50.0f;
-        if (max_t > 50.0f) max_t = 50.0f;
-        // Ensure standard range is covered
-        if (min_t > 0.0f) min_t = 0.0f;
-        if (max_t < 1.0f) max_t = 1.0f;
-
-        // Texture width calculation: Map [min_t, max_t] to pixels
-        float range = max_t - min_t;
-        // Use HIGH resolution: 2048px for the 0..1 interval.
-        // Total Width = range * 2048.
-        int texWidth = static_cast<int>(range * 2048.0f); 
-        if (texWidth < 2048) texWidth = 2048;
-        if (texWidth > 8192) texWidth = 8192; // Cap size
-
-        int texHeight = 1; // 1px height with Y-scaling is sufficient and clean
-        
-        Bitmap tex(texWidth, texHeight, PixelFormat32bppARGB);
-        if (tex.GetLastStatus() != Ok) {
-             return std::make_unique<SolidBrush>(Color(0,0,0,0));
-        }
-
-        {
-            Graphics g(&tex);
-            g.SetSmoothingMode(SmoothingModeAntiAlias);
-
-            // Fill background with appropriate edge colors to handle padding
-            Color startColor = ApplyColorOpacity(linearGrad->stops.front().color, opacity);
-            Color endColor = ApplyColorOpacity(linearGrad->stops.back().color, opacity);
-            
-            // Map t=0 and t=1 to pixel coordinates in the texture
-            // t_pixel = (t - min_t) / range * texWidth
-            float x0 = (0.0f - min_t) / range * texWidth;
-            float x1 = (1.0f - min_t) / range * texWidth;
-            
-            // 1. Fill Start Pad [0, x0]
-            if (x0 > 0.5f) {
-                 SolidBrush sb(startColor);
-                 g.FillRectangle(&sb, 0.0f, 0.0f, x0 + 1.0f, (REAL)texHeight);
-            }
-            
-            // 2. Fill End Pad [x1, W]
-            if (x1 < texWidth - 0.5f) {
-                 SolidBrush sb(endColor);
-                 g.FillRectangle(&sb, x1 - 1.0f, 0.0f, (REAL)texWidth - x1 + 1.0f, (REAL)texHeight);
-            }
-
-            // 3. Draw Gradient [x0, x1]
-            if (x1 > x0) {
-                RectF rect(x0, 0, x1 - x0, (REAL)texHeight);
-                // Note: LinearGradientBrush needs 2 points.
-                // We draw from x0 to x1.
-                // Colors should be Start to End.
-                LinearGradientBrush lg(RectF(x0, 0.0f, x1 - x0, (REAL)texHeight), startColor, endColor, LinearGradientModeHorizontal);
-
-                std::vector<Color> colors;
-                std::vector<REAL> positions;
-                colors.reserve(n);
-                positions.reserve(n);
-                
-                // Add stops
-                for (const auto &s : linearGrad->stops) {
-                     colors.push_back(ApplyColorOpacity(s.color, opacity));
-                     positions.push_back(s.offset);
-                }
-                // Ensure 0 and 1 are present
-                 if (positions.front() > 0.001f) {
-                    colors.insert(colors.begin(), colors.front());
-                    positions.insert(positions.begin(), 0.0f);
-                    ++n;
-                }
-                if (positions.back() < 0.999f) {
-                     colors.push_back(colors.back());
-                     positions.push_back(1.0f);
-                     ++n;
-                }
-
-                std::unique_ptr<Color[]> colorArr(new Color[n]);
-                std::unique_ptr<REAL[]> posArr(new REAL[n]);
-                for (int i = 0; i < n; ++i) {
-                     colorArr[i] = colors[i];
-                     posArr[i] = positions[i];
-                }
-                lg.SetInterpolationColors(colorArr.get(), posArr.get(), n);
-                lg.SetInterpolationColors(colorArr.get(), posArr.get(), n);
-            // lg.SetGammaCorrection(TRUE); // Removed to match sRGB expectation
-                g.FillRectangle(&lg, rect);
-            }
-        }
-
-        TextureBrush *tb = new TextureBrush(&tex);
-
-        // WrapMode: 
-        if (linearGrad->spreadMethod == "reflect")
-             tb->SetWrapMode(WrapModeTileFlipX); 
-        else if (linearGrad->spreadMethod == "repeat")
-             tb->SetWrapMode(WrapModeTile);
-        else
-             tb->SetWrapMode(WrapModeClamp); 
-
-        // Transform Construction
-        // We need to map the Texture to World Space.
-        // Texture X-range [0, TexWidth] maps to t-range [min_t, max_t] relative to P1-P2.
-        // Specifically, Texture X=0 maps to t=min_t.
-        // P_start = P1 + min_t * (P2 - P1).
-        // Texture X=0 should map to P_start.
-        
-        float dx = p2.X - p1.X;
-        float dy = p2.Y - p1.Y;
-        float baseLen = sqrt(dx*dx + dy*dy);
-        // Avoid div by zero
-        if(baseLen < 1e-5) baseLen = 1.0f;
-
-        float totalLen = range * baseLen;
-        float angle = atan2(dy, dx) * 180.0f / 3.14159265f;
-        
-        float startX = p1.X + min_t * dx;
-        float startY = p1.Y + min_t * dy;
-
-        Matrix m;
-        // 1. Scale X to match Total Length (Texture Width -> Total World Length)
-        float scaleX = 0;
-        if(texWidth > 0) scaleX = totalLen / (float)texWidth;
-        
-        // 2. Scale Y to be Infinite (slab) and Centered
-        // Map 0..1 (TexY) to -10000..10000 (LocalY) relative to center line
-        float scaleY = 20000.0f; 
-        
-        m.Scale(scaleX, scaleY, MatrixOrderAppend);
-        m.Translate(0, -scaleY / 2.0f, MatrixOrderAppend); 
-        
-        // 3. Rotate
-        m.Rotate(angle, MatrixOrderAppend);
-        
-        // 4. Translate to P_start (where t=min_t)
-        m.Translate(startX, startY, MatrixOrderAppend);
-
-        // Append Gradient Transform
-        if (!gradient->gradientTransform.empty())
-        {
-             m.Multiply(&gradMatrix, MatrixOrderAppend); 
-        }
-        
-        if (isObjectBBox) {
-            Matrix t_bbox;
-            t_bbox.Scale(bounds.Width, bounds.Height);
-            t_bbox.Translate(bounds.X, bounds.Y, MatrixOrderAppend); 
-            m.Multiply(&t_bbox, MatrixOrderAppend);
-        }
-        
-        tb->SetTransform(&m);
-        return std::unique_ptr<Brush>(tb);
+        // Across the frame's x the colour is constant, as GDI+ draws a
+        // brush between two points on a horizontal line.
+        auto brush = std::make_unique<LinearGradientBrush>(PointF(t0, 0.0f), PointF(t1, 0.0f), colors.front(),
+                                                           colors.back());
+        brush->SetInterpolationColors(colors.data(), positions.data(), count);
+        brush->SetWrapMode(WrapModeTileFlipX);
+        brush->SetTransform(&placement);
+        return brush;
     }
+
+    // A path gradient blends from its centre point out to its outline along
+    // straight rays, as SVG's focal gradients do: with the focal point as
+    // the centre and the circle scaled about it by t1, the outline is at
+    // t1. Positions run from the outline in, so the ramp is reversed.
+    GraphicsPath path;
+    path.AddEllipse((paint.GetCenterX() - 1.0f) * t1, (paint.GetCenterY() - 1.0f) * t1, 2.0f * t1, 2.0f * t1);
+    std::reverse(colors.begin(), colors.end());
+    std::reverse(positions.begin(), positions.end());
+    for (REAL &position : positions)
+        position = 1.0f - position;
+    auto brush = std::make_unique<PathGradientBrush>(&path);
+    brush->SetCenterPoint(PointF(0.0f, 0.0f));
+    brush->SetCenterColor(colors.back());
+    brush->SetInterpolationColors(colors.data(), positions.data(), count);
+    brush->SetTransform(&placement);
+    return brush;
 }
@@ -5,12 +5,21 @@
 #include "SvgGradient.h"
 
 // Responsible for creating GDI+ Brushes from SVG Gradients.
-// Uses Texture Mapping for Radial Gradients to support complex transforms.
+// The gradient is set up as SoftwarePaint sets it up, and drawn with GDI+'s
+// own gradient brushes in that paint's frame: a LinearGradientBrush, or a
+// PathGradientBrush centred on the focal point for a radial one. Their
+// colours are sampled from the gradient's cached table over the range of t
+// the visible part of the shape covers, spread included, so a draw
+// allocates no pixels.
 class SvgPaintResolver
 {
 public:
+    // bounds is the shape's box in the space graphics is drawing in; the
+    // brush is only good for drawing with graphics' current transform and
+    // clip.
     static std::unique_ptr<Gdiplus::Brush> CreateBrush(
-        const std::shared_ptr<SvgGradient> &gradient, 
+        const Gdiplus::Graphics &graphics,
+        const SvgGradient &gradient, 
         const Gdiplus::RectF &bounds, 
         float opacity = 1.0f);
 };
@@ -56,8 +56,11 @@ void SvgPaintServer::ResolveGradients()
                 // Let's skip String inheritance for now unless I change Parser to leave them empty.
                 // Wait, User complained about "missing attributes... gradientTransform".
                 // gradientTransform defaults to empty string by Parser.
-                if (grad->gradientTransform.empty() && !parent->gradientTransform.empty())
+                if (!grad->hasGradientTransform && parent->hasGradientTransform)
+                {
                     grad->gradientTransform = parent->gradientTransform;
+                    grad->hasGradientTransform = true;
+                }
                     
                 if (grad->spreadMethod == "pad" && parent->spreadMethod != "pad") // "pad" is default
                      grad->spreadMethod = parent->spreadMethod;
@@ -2,94 +2,87 @@
 #include "SvgParser.h"
 
 #include "SvgGradient.h"
-#include <regex>
+#include "SvgAttributeTable.h"
+#include "SvgStreamParser.h"
+#include "SvgNumber.h"
+#include "SvgTransform.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 using namespace rapidxml;
 
 namespace {
-    std::string AttrOr(const IXMLNode &node, const char *name, const std::string &def = "")
+    float ParseFloat(std::string_view str)
     {
-        std::string v = node.getAttribute(name);
-        return v.empty() ? def : v;
+        return SvgNumber::ParseOr(str, 0.0f);
     }
 
-    float ParseFloat(const std::string& str)
-    {
-        if (str.empty()) return 0.0f;
-        std::stringstream ss(str);
-        ss.imbue(std::locale::classic()); // Force C locale (dot decimal)
-        float f = 0.0f;
-        ss >> f;
-        return f;
-    }
-
-    float ParseFloatOrPercentage(const std::string& s, float def)
+    float ParseFloatOrPercentage(std::string_view s, float def)
     {
          if (s.empty()) return def;
-         try {
-             if (s.back() == '%') {
-                 return ParseFloat(s.substr(0, s.size() - 1)) / 100.0f;
-             }
-             return ParseFloat(s);
-         } catch(...) { return def; }
+         if (s.back() == '%') {
+             return ParseFloat(s.substr(0, s.size() - 1)) / 100.0f;
+         }
+         return ParseFloat(s);
     }
 
-    float AttrOrFloatPercentage(const IXMLNode &node, const char *name, float def)
+    float AttrOrFloatPercentage(const SvgAttributeTable &attrs, SvgAttr attr, float def)
     {
-        return ParseFloatOrPercentage(node.getAttribute(name), def);
+        return ParseFloatOrPercentage(attrs.Get(attr), def);
     }
-    std::unordered_map<std::string, std::string> ParseStyleAttribute(const std::string& style)
-    {
-        std::unordered_map<std::string, std::string> styles;
-        if (style.empty()) return styles;
 
-        std::stringstream ss(style);
-        std::string item;
-        while (std::getline(ss, item, ';'))
+    // Below this many elements a document is built on the calling thread;
+    // starting workers would cost more than it saves.
+    constexpr size_t kParallelMinElements = 8192;
+    // Aim for this many pieces per thread so uneven subtrees still balance,
+    // but never split below kMinChunk elements.
+    constexpr size_t kChunksPerThread = 8;
+    constexpr size_t kMinChunk = 512;
+
+    size_t CountElements(const xml_node<> *node)
+    {
+        size_t count = 1;
+        for (const xml_node<> *child = node->first_node(); child; child = child->next_sibling())
         {
-            size_t colon = item.find(':');
-            if (colon != std::string::npos)
-            {
-                std::string key = item.substr(0, colon);
-                std::string val = item.substr(colon + 1);
-                
-                // trim spaces
-                auto trim = [](std::string& s) {
-                    size_t first = s.find_first_not_of(' ');
-                    if (std::string::npos == first) { s = ""; return; }
-                    size_t last = s.find_last_not_of(' ');
-                    s = s.substr(first, (last - first + 1));
-                };
-                trim(key);
-                trim(val);
-                if (!key.empty()) styles[key] = val;
-            }
+            if (child->type() == node_element)
+                count += CountElements(child);
         }
-        return styles;
+        return count;
     }
 }
 
-void SvgParser::ParseGradientStops(const IXMLNode &node, SvgGradient *grad)
+// A run of siblings under <svg>, or under a <g> too big to be a single
+// piece. Workers build pieces into documents of their own, and the pieces
+// are then moved into place in plan order, so the document comes
+// out exactly as ParseChildren would build it whatever the threads did.
+struct SvgParser::Subtree
 {
-     auto children = node.getChildren();
-     for (auto &c : children)
+    xml_node<> *first = nullptr;
+    xml_node<> *last = nullptr;             // one past the run
+    SvgGroup *parent = nullptr;             // where the elements go; null for the document
+    std::vector<SvgStyleNode> ancestors;
+    SvgGroup *group = nullptr;              // a split <g>: built while planning, its children are pieces of their own
+    SvgGroup elements;
+    SvgDocument part;                       // the piece's gradients and ids, and the arena its elements live in
+};
+
+void SvgParser::ParseGradientStops(const IXMLNode &node, SvgGradient *grad, const SvgStyleContext &style) const
+{
+     node.forEachChild([&](const IXMLNode &c)
      {
-         if (c->getTagName() == "stop")
+         if (LookupSvgTag(c.getTagName()) == SvgTag::Stop)
          {
+             SvgAttributeTable attrs(c);
              GradientStop stop;
-             std::string offsetStr = c->getAttribute("offset");
-             stop.offset = ParseFloatOrPercentage(offsetStr, 0.0f);
-             
-             std::string styleStr = c->getAttribute("style");
-             auto styles = ParseStyleAttribute(styleStr);
+             stop.offset = ParseFloatOrPercentage(attrs.Get(SvgAttr::Offset), 0.0f);
 
-             auto getAttr = [&](const char* name) {
-                 if (styles.count(name)) return styles[name];
-                 return c->getAttribute(name);
-             };
-
-             std::string colorStr = getAttr("stop-color");
-             std::string opacityStr = getAttr("stop-opacity");
+             style.sheet.Apply(SvgStyleNode(c, SvgTag::Stop, attrs.Get(SvgAttr::Id), attrs.Get(SvgAttr::Class)),
+                               style.ancestors, attrs);
+             std::string_view colorStr = attrs.Get(SvgAttr::StopColor);
+             std::string_view opacityStr = attrs.Get(SvgAttr::StopOpacity);
              
              // We need factory to parse color, but factory is member of SvgParser.
              // Accessing factory from here.
@@ -105,102 +98,131 @@ void SvgParser::ParseGradientStops(const IXMLNode &node, SvgGradient *grad)
                      if (op < 0.0f) op = 0.0f;
                      float a = stop.color.GetAlpha() / 255.0f;
                      a *= op;
-                     stop.color = Gdiplus::Color(static_cast<BYTE>(a * 255.5f), stop.color.GetR(), stop.color.GetG(), stop.color.GetB());
+                     stop.color = Gdiplus::Color(static_cast<uint8_t>(a * 255.5f), stop.color.GetR(), stop.color.GetG(), stop.color.GetB());
                  }
              }
              
              grad->stops.push_back(stop);
          }
-     }
+     });
 }
 
-void SvgParser::ParseGradient(const IXMLNode &child, SvgDocument &document)
+void SvgParser::ParseGradient(const IXMLNode &child, SvgDocument &document, SvgStyleContext &style) const
 {
-    const std::string tag = child.getTagName();
-    if (tag == "linearGradient")
+    const SvgTag tag = LookupSvgTag(child.getTagName());
+    SvgAttributeTable attrs(child);
+    // The stops see the gradient as their parent.
+    style.ancestors.emplace_back(child, tag, attrs.Get(SvgAttr::Id), attrs.Get(SvgAttr::Class));
+    if (tag == SvgTag::LinearGradient)
     {
         auto grad = std::make_shared<SvgLinearGradient>();
-        grad->id = child.getAttribute("id");
-        grad->gradientUnits = AttrOr(child, "gradientUnits", "objectBoundingBox");
-        grad->gradientTransform = AttrOr(child, "gradientTransform", "");
-        grad->spreadMethod = AttrOr(child, "spreadMethod", "pad");
+        grad->id = attrs.Get(SvgAttr::Id);
+        grad->gradientUnits = attrs.GetOr(SvgAttr::GradientUnits, "objectBoundingBox");
+        if (attrs.Has(SvgAttr::GradientTransform))
+        {
+            grad->gradientTransform = SvgTransform::Parse(attrs.Get(SvgAttr::GradientTransform));
+            grad->hasGradientTransform = true;
+        }
+        grad->spreadMethod = attrs.GetOr(SvgAttr::SpreadMethod, "pad");
 
         // Parse xlink:href for gradient inheritance
-        std::string href = AttrOr(child, "href", "");
-        if (href.empty()) href = AttrOr(child, "xlink:href", "");
+        std::string_view href = attrs.GetOr(SvgAttr::Href, "");
+        if (href.empty()) href = attrs.GetOr(SvgAttr::XlinkHref, "");
         if (!href.empty() && href[0] == '#') href = href.substr(1);
         grad->href = href;
 
-        if (AttrOr(child, "x1", "") != "") {
-             grad->x1 = AttrOrFloatPercentage(child, "x1", 0.0f);
+        if (attrs.Has(SvgAttr::X1)) {
+             grad->x1 = AttrOrFloatPercentage(attrs, SvgAttr::X1, 0.0f);
              grad->hasX1 = true;
         }
-        if (AttrOr(child, "y1", "") != "") {
-             grad->y1 = AttrOrFloatPercentage(child, "y1", 0.0f);
+        if (attrs.Has(SvgAttr::Y1)) {
+             grad->y1 = AttrOrFloatPercentage(attrs, SvgAttr::Y1, 0.0f);
              grad->hasY1 = true;
         }
-        if (AttrOr(child, "x2", "") != "") {
-             grad->x2 = AttrOrFloatPercentage(child, "x2", 1.0f);
+        if (attrs.Has(SvgAttr::X2)) {
+             grad->x2 = AttrOrFloatPercentage(attrs, SvgAttr::X2, 1.0f);
              grad->hasX2 = true;
         }
-        if (AttrOr(child, "y2", "") != "") {
-             grad->y2 = AttrOrFloatPercentage(child, "y2", 0.0f);
+        if (attrs.Has(SvgAttr::Y2)) {
+             grad->y2 = AttrOrFloatPercentage(attrs, SvgAttr::Y2, 0.0f);
              grad->hasY2 = true;
         }
 
-        ParseGradientStops(child, grad.get());
+        ParseGradientStops(child, grad.get(), style);
         document.AddGradient(grad);
     }
-    else if (tag == "radialGradient")
+    else if (tag == SvgTag::RadialGradient)
     {
         auto grad = std::make_shared<SvgRadialGradient>();
-        grad->id = child.getAttribute("id");
-        grad->gradientUnits = AttrOr(child, "gradientUnits", "objectBoundingBox");
-        grad->gradientTransform = AttrOr(child, "gradientTransform", "");
-        grad->spreadMethod = AttrOr(child, "spreadMethod", "pad");
+        grad->id = attrs.Get(SvgAttr::Id);
+        grad->gradientUnits = attrs.GetOr(SvgAttr::GradientUnits, "objectBoundingBox");
+        if (attrs.Has(SvgAttr::GradientTransform))
+        {
+            grad->gradientTransform = SvgTransform::Parse(attrs.Get(SvgAttr::GradientTransform));
+            grad->hasGradientTransform = true;
+        }
+        grad->spreadMethod = attrs.GetOr(SvgAttr::SpreadMethod, "pad");
 
         // Parse xlink:href for gradient inheritance
-        std::string href = AttrOr(child, "href", "");
-        if (href.empty()) href = AttrOr(child, "xlink:href", "");
+        std::string_view href = attrs.GetOr(SvgAttr::Href, "");
+        if (href.empty()) href = attrs.GetOr(SvgAttr::XlinkHref, "");
         if (!href.empty() && href[0] == '#') href = href.substr(1);
         grad->href = href;
 
-        if (AttrOr(child, "cx", "") != "") {
-             grad->cx = AttrOrFloatPercentage(child, "cx", 0.5f);
+        if (attrs.Has(SvgAttr::Cx)) {
+             grad->cx = AttrOrFloatPercentage(attrs, SvgAttr::Cx, 0.5f);
              grad->hasCx = true;
         }
-        if (AttrOr(child, "cy", "") != "") {
-             grad->cy = AttrOrFloatPercentage(child, "cy", 0.5f);
+        if (attrs.Has(SvgAttr::Cy)) {
+             grad->cy = AttrOrFloatPercentage(attrs, SvgAttr::Cy, 0.5f);
              grad->hasCy = true;
         }
-        if (AttrOr(child, "r", "") != "") {
-             grad->r = AttrOrFloatPercentage(child, "r", 0.5f);
+        if (attrs.Has(SvgAttr::R)) {
+             grad->r = AttrOrFloatPercentage(attrs, SvgAttr::R, 0.5f);
              grad->hasR = true;
         }
-        if (AttrOr(child, "fx", "") != "") {
-             grad->fx = AttrOrFloatPercentage(child, "fx", grad->cx);
+        if (attrs.Has(SvgAttr::Fx)) {
+             grad->fx = AttrOrFloatPercentage(attrs, SvgAttr::Fx, grad->cx);
              grad->hasFx = true;
         }
-        if (AttrOr(child, "fy", "") != "") {
-             grad->fy = AttrOrFloatPercentage(child, "fy", grad->cy);
+        if (attrs.Has(SvgAttr::Fy)) {
+             grad->fy = AttrOrFloatPercentage(attrs, SvgAttr::Fy, grad->cy);
              grad->hasFy = true;
         }
 
-        ParseGradientStops(child, grad.get());
+        ParseGradientStops(child, grad.get(), style);
         document.AddGradient(grad);
     }
+    style.ancestors.pop_back();
+}
+
+
+bool SvgParser::Parse(const std::string &xml, SvgDocument &document) const
+{
+    return Parse(std::string_view(xml), document);
 }
 
+bool SvgParser::Parse(std::string_view xml, SvgDocument &document) const
+{
+    std::vector<char> buffer(xml.size() + 1);
+    std::copy(xml.begin(), xml.end(), buffer.begin());
+    buffer.back() = '\0';
+    return Parse(std::span<char>(buffer), document);
+}
 
-bool SvgParser::Parse(const std::string &xml, SvgDocument &document)
+bool SvgParser::Parse(std::span<char> buffer, SvgDocument &document) const
 {
-    std::vector<char> buffer(xml.begin(), xml.end());
-    buffer.push_back('\0');
+    if (buffer.empty() || buffer.back() != '\0')
+        return false;
+
+    // Looking for stylesheets means visiting every group, so check the raw
+    // bytes first (rapidxml overwrites them in place).
+    const bool mayHaveStyle = std::string_view(buffer.data(), buffer.size()).find("<style") != std::string_view::npos;
 
     xml_document<> doc;
     try
     {
-        doc.parse<0>(&buffer[0]);
+        doc.parse<0>(buffer.data());
     }
     catch (...)
     {
@@ -212,142 +234,324 @@ bool SvgParser::Parse(const std::string &xml, SvgDocument &document)
         return false;
 
     RapidXmlNodeAdapter root(svg);
-    // Extract width/height or viewBox from root svg element if present
-    // Extract width/height or viewBox from root svg element if present
-    // Use the robust ParseFloat instead of the manual lambda
-    auto parseDimension = [](const std::string &s) -> float
+    SvgStyleSheet sheet;
+    if (mayHaveStyle)
+        CollectStyleSheets(root, sheet);
+    SvgStyleContext style{sheet, {SvgStyleNode(root)}};
+
+    ParseRootSize(root, document);
+    const unsigned threads = m_maxThreads ? m_maxThreads : (std::max)(std::thread::hardware_concurrency(), 1u);
+    const size_t elementCount = threads > 1 ? CountElements(svg) : 0;
+    if (elementCount >= kParallelMinElements)
+        ParseChildrenParallel(svg, document, style, elementCount, threads);
+    else
+        ParseChildren(root, document, nullptr, style);
+    document.ResolveGradients();
+    document.ResolveUses();
+    document.ResolveStyles();
+    document.ResolveBounds();
+    return true;
+}
+
+bool SvgParser::Parse(std::istream &input, SvgDocument &document) const
+{
+    SvgStreamParser stream(*this);
+    std::vector<char> chunk(64 * 1024);
+    while (input)
     {
-        if (s.empty()) return 0.0f;
-        std::stringstream ss(s);
-        ss.imbue(std::locale::classic());
-        float val = 0.0f;
-        ss >> val;
-        return val;
-    };
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        std::streamsize got = input.gcount();
+        if (got <= 0)
+            break;
+        if (!stream.Feed(std::string_view(chunk.data(), static_cast<size_t>(got))))
+            return false;
+    }
+    if (input.bad())
+        return false;
+    return stream.Finish(document);
+}
 
-    std::string wattr = root.getAttribute("width");
-    std::string hattr = root.getAttribute("height");
-    std::string vb = root.getAttribute("viewBox");
+void SvgParser::ParseRootSize(const IXMLNode &root, SvgDocument &document) const
+{
+    // Extract width/height or viewBox from root svg element if present
+    std::string_view wattr = root.getAttribute("width");
+    std::string_view hattr = root.getAttribute("height");
+    std::string_view vb = root.getAttribute("viewBox");
     if (!wattr.empty() && !hattr.empty())
     {
-        float w = parseDimension(wattr);
-        float h = parseDimension(hattr);
+        float w = SvgNumber::ParseOr(wattr, 0.0f);
+        float h = SvgNumber::ParseOr(hattr, 0.0f);
         if (w > 0 && h > 0)
             document.SetSize(w, h);
     }
     else if (!vb.empty())
     {
-        // viewBox: minx miny width height
-        // split by spaces or commas
-        std::vector<float> nums;
-        std::string tmp = vb;
-        for (char &c : tmp)
-            if (c == ',')
-                c = ' ';
-        std::stringstream ss(tmp);
-        ss.imbue(std::locale::classic());
-        float v;
-        while (ss >> v)
-            nums.push_back(v);
-        if (nums.size() >= 4)
+        // viewBox: minx miny width height, separated by spaces or commas
+        float nums[4] = {};
+        SvgNumberList list(vb);
+        size_t count = 0;
+        while (count < 4 && list.Next(nums[count]))
+            ++count;
+        if (count == 4)
         {
             document.SetSize(nums[2], nums[3]);
         }
     }
-    ParseChildren(root, document, nullptr);
-    document.ResolveGradients();
-    return true;
 }
 
-void SvgParser::ParseChildren(const IXMLNode &parent, SvgDocument &document, SvgGroup *currentGroup)
+void SvgParser::ParseStyleElement(const IXMLNode &node, SvgStyleSheet &sheet)
 {
-    auto children = parent.getChildren();
-    for (auto &childPtr : children)
-    {
-        IXMLNode &child = *childPtr;
-        const std::string tag = child.getTagName();
+    std::string_view type = node.getAttribute("type");
+    if (type.empty() || type == "text/css")
+        sheet.Parse(node.getTextContent());
+}
 
-        if (tag == "linearGradient" || tag == "radialGradient")
+void SvgParser::CollectStyleSheets(const IXMLNode &parent, SvgStyleSheet &sheet) const
+{
+    parent.forEachChild([&](const IXMLNode &child)
+    {
+        switch (LookupSvgTag(child.getTagName()))
         {
-            ParseGradient(child, document);
+        case SvgTag::Style:
+            ParseStyleElement(child, sheet);
+            break;
+        case SvgTag::G:
+        case SvgTag::Defs:
+        case SvgTag::Symbol:
+            CollectStyleSheets(child, sheet);
+            break;
+        default:
+            break;
         }
-        else if (tag == "defs")
-        {
-             auto defChildren = child.getChildren();
-             for (auto &dc : defChildren)
-             {
-                 std::string dTag = dc->getTagName();
-                 if (dTag == "linearGradient" || dTag == "radialGradient")
-                 {
-                     ParseGradient(*dc, document);
-                 }
-                 // If we support symbols or other defs later, handle here
-             }
-        }
-        else if (tag == "g")
-        {
-            auto group = std::make_unique<SvgGroup>();
-            SvgGroup *groupRaw = group.get();
+    });
+}
 
-            if (!child.getAttribute("transform").empty())
-            {
-                group->transformAttribute = child.getAttribute("transform");
-            }
+SvgGroup *SvgParser::CreateGroup(const IXMLNode &node, const SvgStyleContext &style, SvgDocument &document,
+                                 SvgDocument *names) const
+{
+    auto group = document.GetArena().Create<SvgGroup>();
+    SvgAttributeTable attrs(node);
+    style.sheet.Apply(SvgStyleNode(node, SvgTag::G, attrs.Get(SvgAttr::Id), attrs.Get(SvgAttr::Class)), style.ancestors, attrs);
+    InitGroup(*group, attrs, document, names ? *names : document);
+    return group;
+}
 
-            if (!child.getAttribute("stroke").empty())
-            {
-                group->hasInputStroke = true;
-                group->strokeColor = factory.ParseColor(child.getAttribute("stroke"));
-            }
+SvgSymbol *SvgParser::CreateSymbol(const IXMLNode &node, const SvgStyleContext &style, SvgDocument &document) const
+{
+    auto symbol = document.GetArena().Create<SvgSymbol>();
+    SvgAttributeTable attrs(node);
+    style.sheet.Apply(SvgStyleNode(node, SvgTag::Symbol, attrs.Get(SvgAttr::Id), attrs.Get(SvgAttr::Class)), style.ancestors, attrs);
+    InitGroup(*symbol, attrs, document, document);
+    symbol->hasViewBox = symbol->viewBox.Parse(attrs.Get(SvgAttr::ViewBox), attrs.Get(SvgAttr::PreserveAspectRatio));
+    return symbol;
+}
 
-            if (!child.getAttribute("fill").empty())
-            {
-                group->hasInputFill = true;
-                group->fillColor = factory.ParseColor(child.getAttribute("fill"));
-            }
+void SvgParser::InitGroup(SvgGroup &group, const SvgAttributeTable &attrs, SvgDocument &document,
+                          SvgDocument &names) const
+{
+    std::string_view transform = attrs.Get(SvgAttr::Transform);
+    if (!transform.empty())
+    {
+        group.transform = SvgTransform::Parse(transform);
+    }
 
-            if (!child.getAttribute("stroke-width").empty())
-            {
-                group->hasInputStrokeWidth = true;
-                group->strokeWidth = ParseFloat(child.getAttribute("stroke-width"));
-            }
+    // Only what the group sets matters; see SvgGroup::ResolveStyle.
+    group.style = document.GetStyles().Intern(factory.ParsePassedPaint(attrs));
+    names.SetElementId(attrs.Get(SvgAttr::Id), &group);
+}
 
-            if (!child.getAttribute("stroke-opacity").empty())
-            {
-                group->hasInputStrokeOpacity = true;
-                group->strokeOpacity = ParseFloat(child.getAttribute("stroke-opacity"));
-            }
+void SvgParser::ParseChildren(const IXMLNode &parent, SvgDocument &document, SvgGroup *currentGroup, SvgStyleContext &style) const
+{
+    parent.forEachChild([&](const IXMLNode &child)
+    {
+        ParseChild(child, document, currentGroup, style);
+    });
+}
 
-            if (!child.getAttribute("fill-opacity").empty())
-            {
-                group->hasInputFillOpacity = true;
-                group->fillOpacity = ParseFloat(child.getAttribute("fill-opacity"));
-            }
+void SvgParser::ParseChild(const IXMLNode &child, SvgDocument &document, SvgGroup *currentGroup, SvgStyleContext &style) const
+{
+    switch (LookupSvgTag(child.getTagName()))
+    {
+    case SvgTag::LinearGradient:
+    case SvgTag::RadialGradient:
+        ParseGradient(child, document, style);
+        break;
+    case SvgTag::Style:
+        // Already collected by CollectStyleSheets.
+        break;
+    case SvgTag::Defs:
+    {
+        // Built like a group but kept out of the drawing, for <use>.
+        SvgGroup *defs = document.GetArena().Create<SvgGroup>();
+        document.AddDefinition(defs);
+        style.ancestors.emplace_back(child);
+        ParseChildren(child, document, defs, style);
+        style.ancestors.pop_back();
+        break;
+    }
+    case SvgTag::Symbol:
+    {
+        SvgSymbol *symbol = CreateSymbol(child, style, document);
+        document.AddDefinition(symbol);
+        style.ancestors.emplace_back(child);
+        ParseChildren(child, document, symbol, style);
+        style.ancestors.pop_back();
+        break;
+    }
+    case SvgTag::G:
+    {
+        SvgGroup *group = CreateGroup(child, style, document);
 
+        if (currentGroup)
+        {
+            currentGroup->AddChild(group);
+        }
+        else
+        {
+            document.AddElement(group);
+        }
+        style.ancestors.emplace_back(child);
+        ParseChildren(child, document, group, style);
+        style.ancestors.pop_back();
+        break;
+    }
+    default:
+    {
+        ISvgElement *element = factory.CreateElement(child, style, document);
+        if (element)
+        {
             if (currentGroup)
             {
-                currentGroup->AddChild(std::move(group));
+                currentGroup->AddChild(element);
             }
             else
             {
-                document.AddElement(std::move(group));
+                document.AddElement(element);
             }
-            ParseChildren(child, document, groupRaw);
         }
-        else
+        break;
+    }
+    }
+}
+
+void SvgParser::PlanSubtrees(xml_node<> *parent, SvgGroup *target, SvgStyleContext &style, size_t chunk, SvgDocument &document,
+                             std::deque<RapidXmlNodeAdapter> &adapters, std::deque<Subtree> &plan) const
+{
+    // Small siblings are batched into runs of about chunk elements.
+    Subtree *run = nullptr;
+    size_t runSize = 0;
+    for (xml_node<> *child = parent->first_node(); child; child = child->next_sibling())
+    {
+        if (child->type() != node_element)
+            continue;
+
+        const size_t size = CountElements(child);
+        if (size > chunk && LookupSvgTag(std::string_view(child->name(), child->name_size())) == SvgTag::G)
+        {
+            Subtree &piece = plan.emplace_back();
+            piece.first = child;
+            piece.last = child->next_sibling();
+            piece.parent = target;
+
+            const RapidXmlNodeAdapter &adapter = adapters.emplace_back(child);
+            // Its id waits in the piece with the others; registered now, it
+            // would beat one earlier in the document that is merged later.
+            piece.group = CreateGroup(adapter, style, document, &piece.part);
+            style.ancestors.emplace_back(adapter);
+            PlanSubtrees(child, piece.group, style, chunk, document, adapters, plan);
+            style.ancestors.pop_back();
+            run = nullptr;
+            continue;
+        }
+
+        if (!run || runSize + size > chunk)
+        {
+            run = &plan.emplace_back();
+            run->first = child;
+            run->parent = target;
+            run->ancestors = style.ancestors;
+            runSize = 0;
+        }
+        run->last = child->next_sibling();
+        runSize += size;
+    }
+}
+
+void SvgParser::ParseChildrenParallel(xml_node<> *root, SvgDocument &document, SvgStyleContext &style,
+                                      size_t elementCount, unsigned threads) const
+{
+    // Adapters for split groups, kept alive for the SvgStyleNodes that
+    // point at them.
+    std::deque<RapidXmlNodeAdapter> adapters;
+    std::deque<Subtree> plan;
+    const size_t chunk = (std::max)(elementCount / (threads * kChunksPerThread), kMinChunk);
+    PlanSubtrees(root, nullptr, style, chunk, document, adapters, plan);
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto work = [&]()
+    {
+        try
         {
-            auto element = factory.CreateElement(child);
-            if (element)
+            for (size_t i = next++; i < plan.size(); i = next++)
             {
-                if (currentGroup)
+                Subtree &piece = plan[i];
+                if (piece.group)
+                    continue;
+                SvgStyleContext pieceStyle{style.sheet, std::move(piece.ancestors)};
+                for (xml_node<> *node = piece.first; node != piece.last; node = node->next_sibling())
                 {
-                    currentGroup->AddChild(std::move(element));
-                }
-                else
-                {
-                    document.AddElement(std::move(element));
+                    if (node->type() == node_element)
+                        ParseChild(RapidXmlNodeAdapter(node), piece.part, &piece.elements, pieceStyle);
                 }
             }
         }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+            next = plan.size();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const size_t workerCount = (std::min)(static_cast<size_t>(threads), plan.size());
+    for (size_t i = 1; i < workerCount; ++i)
+    {
+        try
+        {
+            workers.emplace_back(work);
+        }
+        catch (const std::system_error &)
+        {
+            break;  // fewer workers; the calling thread still does its share
+        }
+    }
+    work();
+    for (std::thread &worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    // Pieces are planned in document order, so their ids and gradients are
+    // merged as a serial parse would register them.
+    for (Subtree &piece : plan)
+    {
+        auto place = [&](ISvgElement *element)
+        {
+            if (piece.parent)
+                piece.parent->AddChild(element);
+            else
+                document.AddElement(element);
+        };
+        if (piece.group)
+            place(piece.group);
+        document.AdoptStyles(piece.part, piece.elements.children);
+        for (ISvgElement *element : piece.elements.children)
+            place(element);
+        document.AddGradients(piece.part);
+        document.AdoptArenas(piece.part);
     }
 }
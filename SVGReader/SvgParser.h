@@ -5,22 +5,80 @@
 #include "SvgDocument.h"
 #include "SvgGradient.h"
 #include "SvgElementFactory.h"
+#include "SvgStyleSheet.h"
 #include "IXMLNode.h"
 #include "RapidXmlNodeAdapter.h"
+#include <deque>
+#include <istream>
+#include <span>
+#include <string_view>
 
+// Parsing keeps all of its state on the stack and in the document being
+// built. Nothing here or in SvgElementFactory, SvgColors or the other
+// parse helpers writes to shared state, so one SvgParser (or several) can
+// load documents on any number of threads at once, as long as each thread
+// parses into its own SvgDocument. A large document may also be built on
+// worker threads of the parser's own; they only read the DOM and the
+// stylesheet and each fills its own part of the result.
 class SvgParser
 {
 public:
     SvgParser() = default;
 
-    bool Parse(const std::string &xml, SvgDocument &document);
+    // Caps the threads the DOM parse uses to build a large document: 0 (the
+    // default) means one per core, 1 keeps everything on the calling
+    // thread. The document is the same either way. Set it before sharing
+    // the parser.
+    void SetMaxThreads(unsigned count) { m_maxThreads = count; }
+
+    bool Parse(const std::string &xml, SvgDocument &document) const;
+
+    // Copies the bytes once into a terminated buffer and parses that.
+    bool Parse(std::string_view xml, SvgDocument &document) const;
+
+    // Parses the buffer in place without copying. rapidxml writes into it,
+    // and the last byte of the span must be the terminating '\0'.
+    bool Parse(std::span<char> buffer, SvgDocument &document) const;
+
+    // Streams the input through SvgStreamParser in fixed-size chunks, so no
+    // DOM and no full copy of the file is ever held. Works on pipes.
+    bool Parse(std::istream &input, SvgDocument &document) const;
 
 private:
+    friend class SvgStreamParser;
+
+    // A piece of the document built by one worker; see ParseChildrenParallel.
+    struct Subtree;
+
     SvgElementFactory factory;
+    unsigned m_maxThreads = 0;
+
+    void ParseRootSize(const IXMLNode &root, SvgDocument &document) const;
+    // The group's id goes to names if given instead of document: a split
+    // group's goes with its piece, so ids are merged in document order.
+    SvgGroup *CreateGroup(const IXMLNode &node, const SvgStyleContext &style, SvgDocument &document,
+                          SvgDocument *names = nullptr) const;
+    // A group that also keeps its viewBox.
+    SvgSymbol *CreateSymbol(const IXMLNode &node, const SvgStyleContext &style, SvgDocument &document) const;
+    // The transform, style and id of a <g> or <symbol>.
+    void InitGroup(SvgGroup &group, const SvgAttributeTable &attrs, SvgDocument &document, SvgDocument &names) const;
+
+    // Adds the rules of a <style> element to sheet, unless its type says it
+    // is not CSS.
+    static void ParseStyleElement(const IXMLNode &node, SvgStyleSheet &sheet);
+    // A stylesheet applies to the whole document wherever it sits, so the
+    // DOM walk collects them all before building anything. Looks in the
+    // same places ParseChildren descends into.
+    void CollectStyleSheets(const IXMLNode &parent, SvgStyleSheet &sheet) const;
 
-    void ParseChildren(const IXMLNode &parent, SvgDocument &document, SvgGroup *currentGroup);
-    void ParseGradientStops(const IXMLNode &node, SvgGradient *grad);
-    void ParseGradient(const IXMLNode &node, SvgDocument &document);
+    void ParseChildren(const IXMLNode &parent, SvgDocument &document, SvgGroup *currentGroup, SvgStyleContext &style) const;
+    void ParseChild(const IXMLNode &child, SvgDocument &document, SvgGroup *currentGroup, SvgStyleContext &style) const;
+    void ParseChildrenParallel(rapidxml::xml_node<> *root, SvgDocument &document, SvgStyleContext &style,
+                               size_t elementCount, unsigned threads) const;
+    void PlanSubtrees(rapidxml::xml_node<> *parent, SvgGroup *target, SvgStyleContext &style, size_t chunk, SvgDocument &document,
+                      std::deque<RapidXmlNodeAdapter> &adapters, std::deque<Subtree> &plan) const;
+    void ParseGradientStops(const IXMLNode &node, SvgGradient *grad, const SvgStyleContext &style) const;
+    void ParseGradient(const IXMLNode &node, SvgDocument &document, SvgStyleContext &style) const;
 };
 
 #endif
@@ -0,0 +1,66 @@
+#ifndef _SVGPLATFORM_H_
+#define _SVGPLATFORM_H_
+
+// The GDI+ value types the document model is written against: Color and
+// PointF. On Windows they are GDI+'s own, so documents pass straight to
+// GdiPlusRenderer. Elsewhere these stand-ins take their place, with the
+// same names and the members the model uses, and the parser, the scene
+// and the software renderer build with no Windows headers.
+#ifdef _WIN32
+
+#include <windows.h>
+#include <objidl.h>
+#include <gdiplus.h>
+
+#else
+
+#include <cstdint>
+
+namespace Gdiplus
+{
+    typedef float REAL;
+    typedef uint32_t ARGB;
+
+    // Straight (not premultiplied) 8-bit ARGB, packed as GDI+ packs it.
+    class Color
+    {
+    public:
+        Color() : argb(0xFF000000u) {}
+        Color(uint8_t r, uint8_t g, uint8_t b) : argb(MakeARGB(255, r, g, b)) {}
+        Color(uint8_t a, uint8_t r, uint8_t g, uint8_t b) : argb(MakeARGB(a, r, g, b)) {}
+        Color(ARGB value) : argb(value) {}
+
+        uint8_t GetAlpha() const { return static_cast<uint8_t>(argb >> 24); }
+        uint8_t GetA() const { return GetAlpha(); }
+        uint8_t GetRed() const { return static_cast<uint8_t>(argb >> 16); }
+        uint8_t GetR() const { return GetRed(); }
+        uint8_t GetGreen() const { return static_cast<uint8_t>(argb >> 8); }
+        uint8_t GetG() const { return GetGreen(); }
+        uint8_t GetBlue() const { return static_cast<uint8_t>(argb); }
+        uint8_t GetB() const { return GetBlue(); }
+        ARGB GetValue() const { return argb; }
+        void SetValue(ARGB value) { argb = value; }
+
+        static ARGB MakeARGB(uint8_t a, uint8_t r, uint8_t g, uint8_t b)
+        {
+            return (ARGB(a) << 24) | (ARGB(r) << 16) | (ARGB(g) << 8) | ARGB(b);
+        }
+
+    private:
+        ARGB argb;
+    };
+
+    class PointF
+    {
+    public:
+        PointF() : X(0.0f), Y(0.0f) {}
+        PointF(REAL x, REAL y) : X(x), Y(y) {}
+
+        REAL X;
+        REAL Y;
+    };
+}
+
+#endif
+
+#endif
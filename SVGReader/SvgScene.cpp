@@ -0,0 +1,676 @@
+#include "stdafx.h"
+#include "SvgScene.h"
+#include "SvgDocument.h"
+#include "IRenderer.h"
+#include <algorithm>
+
+namespace
+{
+    // Half the stroke, times SVG's default miter limit of 4 for the joins.
+    constexpr float kMiterReach = 2.0f;
+
+    float StrokeReach(const SvgStyle &style, float perWidth)
+    {
+        return style.strokeColor.GetAlpha() > 0 ? style.strokeWidth * perWidth : 0.0f;
+    }
+
+    // How far an item's stroke reaches past its geometry. Lines, ellipses
+    // and text (drawn with round joins) have no corners to miter.
+    float Outset(SvgScene::Kind kind, const SvgStyle &style)
+    {
+        switch (kind)
+        {
+        case SvgScene::Kind::Line:
+        case SvgScene::Kind::Circle:
+        case SvgScene::Kind::Ellipse:
+        case SvgScene::Kind::Text:
+            return StrokeReach(style, 0.5f);
+        case SvgScene::Kind::Rect:
+        case SvgScene::Kind::Polyline:
+        case SvgScene::Kind::Polygon:
+        case SvgScene::Kind::Path:
+            return StrokeReach(style, kMiterReach);
+        default:
+            return 0.0f;
+        }
+    }
+
+    // Whether a union holding box would be all the same without it: box
+    // reaches none of its edges.
+    bool Inside(const SvgBounds &box, const SvgBounds &all)
+    {
+        return box.Empty() || (box.minX > all.minX && box.minY > all.minY && box.maxX < all.maxX && box.maxY < all.maxY);
+    }
+}
+
+SvgBounds SvgScene::Lines::Box(size_t i) const
+{
+    SvgBounds box;
+    box.Add(x1[i], y1[i]);
+    box.Add(x2[i], y2[i]);
+    return box;
+}
+
+SvgBounds SvgScene::Rects::Box(size_t i) const
+{
+    return {x[i], y[i], x[i] + w[i], y[i] + h[i]};
+}
+
+SvgBounds SvgScene::Circles::Box(size_t i) const
+{
+    return {cx[i] - r[i], cy[i] - r[i], cx[i] + r[i], cy[i] + r[i]};
+}
+
+SvgBounds SvgScene::Ellipses::Box(size_t i) const
+{
+    return {cx[i] - rx[i], cy[i] - ry[i], cx[i] + rx[i], cy[i] + ry[i]};
+}
+
+SvgBounds SvgScene::PointRuns::Box(size_t i, const std::vector<float> &points) const
+{
+    SvgBounds box;
+    for (uint32_t k = begin[i]; k < end[i]; k += 2)
+        box.Add(points[k], points[k + 1]);
+    return box;
+}
+
+SvgScene::SvgScene(const SvgDocument &document)
+    : m_document(&document), m_matrices{SvgMatrix()}
+{
+    for (const ISvgElement *element : document.GetElements())
+        AddTargets(*element);
+    m_firstDrawn = static_cast<uint32_t>(m_kinds.size());
+    for (const ISvgElement *element : document.GetElements())
+        Add(*element, kNone, 0);
+    ComputeBounds();
+}
+
+void SvgScene::AddTargets(const ISvgElement &element)
+{
+    if (auto g = dynamic_cast<const SvgGroup *>(&element))
+    {
+        for (const ISvgElement *child : g->children)
+            AddTargets(*child);
+        return;
+    }
+    auto use = dynamic_cast<const SvgUse *>(&element);
+    if (!use || !use->target || m_targets.count(use->target))
+        return;
+    // SvgDocument::ResolveUses cut every loop, so this ends.
+    AddTargets(*use->target);
+    m_targets.emplace(use->target, static_cast<uint32_t>(m_kinds.size()));
+    Add(*use->target, kNone, 0);
+}
+
+uint32_t SvgScene::GetEnd(uint32_t item) const
+{
+    return m_kinds[item] == Kind::Group ? m_groupEnds[m_slots[item]] : item + 1;
+}
+
+uint32_t SvgScene::AddItem(Kind kind, uint32_t slot, const ISvgElement &element, uint32_t parent, uint32_t world,
+                           float outset)
+{
+    const uint32_t item = static_cast<uint32_t>(m_kinds.size());
+    m_kinds.push_back(kind);
+    m_slots.push_back(slot);
+    m_parents.push_back(parent);
+    m_worlds.push_back(world);
+    m_outsets.push_back(outset);
+    m_bounds.emplace_back();
+    m_fillBounds.emplace_back();
+    m_elements.push_back(&element);
+    return item;
+}
+
+void SvgScene::AddPoints(const float *coords, size_t count, Kind kind, const ISvgElement &element, uint32_t parent,
+                         uint32_t world, float outset)
+{
+    const uint32_t slot = static_cast<uint32_t>(m_polys.item.size());
+    m_polys.item.push_back(AddItem(kind, slot, element, parent, world, outset));
+    m_polys.begin.push_back(static_cast<uint32_t>(m_points.size()));
+    m_polys.end.push_back(static_cast<uint32_t>(m_points.size()));
+    m_polys.room.push_back(static_cast<uint32_t>(m_points.size()));
+    SetPoints(m_polys, slot, coords, count);
+}
+
+void SvgScene::AddBoxed(Boxed &boxed, Kind kind, const ISvgElement &element, uint32_t parent, uint32_t world,
+                        float outset)
+{
+    boxed.item.push_back(AddItem(kind, static_cast<uint32_t>(boxed.box.size()), element, parent, world, outset));
+    boxed.box.push_back(element.fillBox);
+}
+
+void SvgScene::SetPoints(PointRuns &runs, uint32_t slot, const float *coords, size_t count)
+{
+    // A run that outgrows its room moves to the end. Once what runs left
+    // behind that way outweighs what they hold, all of them are packed.
+    if (count > runs.room[slot] - runs.begin[slot])
+    {
+        m_abandonedPoints += runs.room[slot] - runs.begin[slot];
+        runs.begin[slot] = static_cast<uint32_t>(m_points.size());
+        m_points.insert(m_points.end(), coords, coords + count);
+        runs.room[slot] = static_cast<uint32_t>(m_points.size());
+    }
+    else
+    {
+        std::copy(coords, coords + count, m_points.begin() + runs.begin[slot]);
+    }
+    runs.end[slot] = runs.begin[slot] + static_cast<uint32_t>(count);
+    if (m_abandonedPoints > m_points.size() / 2)
+        PackPoints(runs);
+}
+
+void SvgScene::PackPoints(PointRuns &runs)
+{
+    std::vector<float> packed;
+    packed.reserve(m_points.size() - m_abandonedPoints);
+    for (size_t slot = 0; slot < runs.item.size(); ++slot)
+    {
+        const uint32_t begin = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(), m_points.begin() + runs.begin[slot], m_points.begin() + runs.end[slot]);
+        runs.begin[slot] = begin;
+        runs.end[slot] = runs.room[slot] = static_cast<uint32_t>(packed.size());
+    }
+    m_points.swap(packed);
+    m_abandonedPoints = 0;
+}
+
+void SvgScene::Add(const ISvgElement &element, uint32_t parent, uint32_t world)
+{
+    if (!element.transform.IsIdentity())
+    {
+        m_matrices.push_back(m_matrices[world] * element.transform);
+        world = static_cast<uint32_t>(m_matrices.size() - 1);
+    }
+
+    const SvgStyle &style = m_document->GetStyles()[element.style];
+
+    // The element model has no kind tag, so this one-time pass still has
+    // to ask; traversals of the scene never do.
+    if (auto g = dynamic_cast<const SvgGroup *>(&element))
+    {
+        const uint32_t slot = static_cast<uint32_t>(m_groupEnds.size());
+        m_groupEnds.push_back(0);
+        const uint32_t item = AddItem(Kind::Group, slot, element, parent, world, 0.0f);
+        for (const ISvgElement *child : g->children)
+            Add(*child, item, world);
+        m_groupEnds[slot] = static_cast<uint32_t>(m_kinds.size());
+    }
+    else if (auto l = dynamic_cast<const SvgLine *>(&element))
+    {
+        m_lines.item.push_back(AddItem(Kind::Line, static_cast<uint32_t>(m_lines.x1.size()), element, parent, world,
+                                       Outset(Kind::Line, style)));
+        m_lines.x1.push_back(l->x1);
+        m_lines.y1.push_back(l->y1);
+        m_lines.x2.push_back(l->x2);
+        m_lines.y2.push_back(l->y2);
+    }
+    else if (auto r = dynamic_cast<const SvgRect *>(&element))
+    {
+        m_rects.item.push_back(AddItem(Kind::Rect, static_cast<uint32_t>(m_rects.x.size()), element, parent, world,
+                                       Outset(Kind::Rect, style)));
+        m_rects.x.push_back(r->x);
+        m_rects.y.push_back(r->y);
+        m_rects.w.push_back(r->w);
+        m_rects.h.push_back(r->h);
+    }
+    else if (auto c = dynamic_cast<const SvgCircle *>(&element))
+    {
+        m_circles.item.push_back(AddItem(Kind::Circle, static_cast<uint32_t>(m_circles.r.size()), element, parent,
+                                         world, Outset(Kind::Circle, style)));
+        m_circles.cx.push_back(c->cx);
+        m_circles.cy.push_back(c->cy);
+        m_circles.r.push_back(c->r);
+    }
+    else if (auto e = dynamic_cast<const SvgEllipse *>(&element))
+    {
+        m_ellipses.item.push_back(AddItem(Kind::Ellipse, static_cast<uint32_t>(m_ellipses.rx.size()), element,
+                                          parent, world, Outset(Kind::Ellipse, style)));
+        m_ellipses.cx.push_back(e->cx);
+        m_ellipses.cy.push_back(e->cy);
+        m_ellipses.rx.push_back(e->rx);
+        m_ellipses.ry.push_back(e->ry);
+    }
+    else if (auto pl = dynamic_cast<const SvgPolyline *>(&element))
+    {
+        // PointF is an x, y pair of floats.
+        const float *coords = reinterpret_cast<const float *>(pl->points.data());
+        AddPoints(coords, pl->points.size() * 2, Kind::Polyline, element, parent, world, Outset(Kind::Polyline, style));
+    }
+    else if (auto pg = dynamic_cast<const SvgPolygon *>(&element))
+    {
+        const float *coords = reinterpret_cast<const float *>(pg->points.data());
+        AddPoints(coords, pg->points.size() * 2, Kind::Polygon, element, parent, world, Outset(Kind::Polygon, style));
+    }
+    else if (dynamic_cast<const SvgPath *>(&element))
+    {
+        AddBoxed(m_paths, Kind::Path, element, parent, world, Outset(Kind::Path, style));
+    }
+    else if (dynamic_cast<const SvgText *>(&element))
+    {
+        AddBoxed(m_texts, Kind::Text, element, parent, world, Outset(Kind::Text, style));
+    }
+    else if (auto u = dynamic_cast<const SvgUse *>(&element))
+    {
+        m_uses.item.push_back(AddItem(Kind::Use, static_cast<uint32_t>(m_uses.target.size()), element, parent,
+                                      world, 0.0f));
+        m_uses.target.push_back(u->target ? m_targets.at(u->target) : kNone);
+    }
+}
+
+void SvgScene::Leaf(uint32_t item, const SvgBounds &local)
+{
+    const SvgMatrix &world = m_matrices[m_worlds[item]];
+    SvgBounds box = local;
+    box.Inflate(m_outsets[item]);
+    m_bounds[item] = box.Transformed(world);
+    m_fillBounds[item] = local.Transformed(world);
+}
+
+void SvgScene::LeafUse(uint32_t item)
+{
+    // Target roots sit at the identity, so their bounds are in the
+    // target's own space.
+    const uint32_t target = m_uses.target[m_slots[item]];
+    if (target == kNone)
+    {
+        m_bounds[item] = m_fillBounds[item] = SvgBounds();
+        return;
+    }
+    const SvgMatrix &world = m_matrices[m_worlds[item]];
+    m_bounds[item] = m_bounds[target].Transformed(world);
+    m_fillBounds[item] = m_fillBounds[target].Transformed(world);
+}
+
+void SvgScene::ComputeBounds()
+{
+    for (size_t i = 0; i < m_lines.item.size(); ++i)
+        Leaf(m_lines.item[i], m_lines.Box(i));
+    for (size_t i = 0; i < m_rects.item.size(); ++i)
+        Leaf(m_rects.item[i], m_rects.Box(i));
+    for (size_t i = 0; i < m_circles.item.size(); ++i)
+        Leaf(m_circles.item[i], m_circles.Box(i));
+    for (size_t i = 0; i < m_ellipses.item.size(); ++i)
+        Leaf(m_ellipses.item[i], m_ellipses.Box(i));
+    for (size_t i = 0; i < m_polys.item.size(); ++i)
+        Leaf(m_polys.item[i], m_polys.Box(i, m_points));
+    for (const Boxed *boxed : {&m_paths, &m_texts})
+    {
+        for (size_t i = 0; i < boxed->item.size(); ++i)
+            Leaf(boxed->item[i], boxed->Box(i));
+    }
+
+    // Targets come before the uses of them, nested ones included, so each
+    // root is complete before any use needs it.
+    const uint32_t count = static_cast<uint32_t>(m_kinds.size());
+    for (uint32_t root = 0; root < count; root = GetEnd(root))
+    {
+        FoldRoot(root);
+        if (root >= m_firstDrawn)
+            m_sceneBounds.Union(m_bounds[root]);
+    }
+}
+
+void SvgScene::FoldRoot(uint32_t root)
+{
+    // Children come after their group, so one backwards pass folds every
+    // item into its group before that group is folded into its own.
+    for (uint32_t i = GetEnd(root); i-- > root;)
+    {
+        if (m_kinds[i] == Kind::Use)
+            LeafUse(i);
+        if (i > root)
+        {
+            m_bounds[m_parents[i]].Union(m_bounds[i]);
+            m_fillBounds[m_parents[i]].Union(m_fillBounds[i]);
+        }
+    }
+}
+
+void SvgScene::Render(IRenderer &renderer) const
+{
+    Draw(renderer, nullptr);
+}
+
+void SvgScene::Render(IRenderer &renderer, const SvgBounds &visible) const
+{
+    Draw(renderer, &visible);
+}
+
+void SvgScene::Render(IRenderer &renderer, const std::vector<uint32_t> &items) const
+{
+    Begin(renderer);
+
+    // The groups around the last item drawn, outermost first; their
+    // transforms are pushed one by one, as Draw does, so the matrices
+    // come out the same.
+    std::vector<uint32_t> open;
+    std::vector<uint32_t> enclosing;
+    for (uint32_t item : items)
+    {
+        while (!open.empty() && GetEnd(open.back()) <= item)
+        {
+            renderer.PopTransform();
+            open.pop_back();
+        }
+        enclosing.clear();
+        for (uint32_t group = m_parents[item]; group != kNone && (open.empty() || group != open.back());
+             group = m_parents[group])
+            enclosing.push_back(group);
+        for (auto it = enclosing.rbegin(); it != enclosing.rend(); ++it)
+        {
+            DrawItem(renderer, *it);
+            open.push_back(*it);
+        }
+        DrawItem(renderer, item);
+    }
+    for (; !open.empty(); open.pop_back())
+        renderer.PopTransform();
+}
+
+void SvgScene::Begin(IRenderer &renderer) const
+{
+    if (m_document)
+    {
+        renderer.SetGradients(m_document->GetGradients());
+        renderer.SetStyles(m_document->GetStyles());
+    }
+}
+
+void SvgScene::Draw(IRenderer &renderer, const SvgBounds *visible) const
+{
+    Begin(renderer);
+
+    // Ends of the groups whose transform is pushed, innermost last.
+    std::vector<uint32_t> open;
+    const uint32_t count = static_cast<uint32_t>(m_kinds.size());
+    for (uint32_t i = m_firstDrawn; i < count;)
+    {
+        while (!open.empty() && open.back() <= i)
+        {
+            renderer.PopTransform();
+            open.pop_back();
+        }
+        if (visible && !m_bounds[i].Intersects(*visible))
+        {
+            i = GetEnd(i);
+            continue;
+        }
+        if (m_kinds[i] == Kind::Group)
+            open.push_back(m_groupEnds[m_slots[i]]);
+        DrawItem(renderer, i);
+        ++i;
+    }
+    for (; !open.empty(); open.pop_back())
+        renderer.PopTransform();
+}
+
+void SvgScene::DrawItem(IRenderer &renderer, uint32_t item) const
+{
+    const ISvgElement &element = *m_elements[item];
+    switch (m_kinds[item])
+    {
+    case Kind::Group:
+        renderer.PushTransform(element.transform);
+        break;
+    case Kind::Line:
+        renderer.DrawLine(static_cast<const SvgLine &>(element));
+        break;
+    case Kind::Rect:
+        renderer.DrawRect(static_cast<const SvgRect &>(element));
+        break;
+    case Kind::Circle:
+        renderer.DrawCircle(static_cast<const SvgCircle &>(element));
+        break;
+    case Kind::Ellipse:
+        renderer.DrawEllipse(static_cast<const SvgEllipse &>(element));
+        break;
+    case Kind::Polyline:
+        renderer.DrawPolyline(static_cast<const SvgPolyline &>(element));
+        break;
+    case Kind::Polygon:
+        renderer.DrawPolygon(static_cast<const SvgPolygon &>(element));
+        break;
+    case Kind::Path:
+        renderer.DrawPath(static_cast<const SvgPath &>(element));
+        break;
+    case Kind::Text:
+        renderer.DrawText(static_cast<const SvgText &>(element));
+        break;
+    case Kind::Use:
+        renderer.DrawUse(static_cast<const SvgUse &>(element));
+        break;
+    }
+}
+
+void SvgScene::Query(const SvgBounds &area, std::vector<uint32_t> &items) const
+{
+    const uint32_t count = static_cast<uint32_t>(m_kinds.size());
+    for (uint32_t i = m_firstDrawn; i < count;)
+    {
+        if (!m_bounds[i].Intersects(area))
+        {
+            i = GetEnd(i);
+            continue;
+        }
+        if (m_kinds[i] != Kind::Group)
+            items.push_back(i);
+        ++i;
+    }
+}
+
+uint32_t SvgScene::HitTest(float x, float y) const
+{
+    const SvgBounds point{x, y, x, y};
+    uint32_t hit = kNone;
+    const uint32_t count = static_cast<uint32_t>(m_kinds.size());
+    for (uint32_t i = m_firstDrawn; i < count;)
+    {
+        if (!m_bounds[i].Intersects(point))
+        {
+            i = GetEnd(i);
+            continue;
+        }
+        // Later items are drawn over earlier ones.
+        if (m_kinds[i] != Kind::Group)
+            hit = i;
+        ++i;
+    }
+    return hit;
+}
+
+SvgBounds SvgScene::LocalBounds(uint32_t item) const
+{
+    const uint32_t slot = m_slots[item];
+    switch (m_kinds[item])
+    {
+    case Kind::Line:
+        return m_lines.Box(slot);
+    case Kind::Rect:
+        return m_rects.Box(slot);
+    case Kind::Circle:
+        return m_circles.Box(slot);
+    case Kind::Ellipse:
+        return m_ellipses.Box(slot);
+    case Kind::Polyline:
+    case Kind::Polygon:
+        return m_polys.Box(slot, m_points);
+    case Kind::Path:
+        return m_paths.Box(slot);
+    case Kind::Text:
+        return m_texts.Box(slot);
+    default:
+        return {};
+    }
+}
+
+void SvgScene::Reload(uint32_t item)
+{
+    const ISvgElement &element = *m_elements[item];
+    const uint32_t slot = m_slots[item];
+    switch (m_kinds[item])
+    {
+    case Kind::Line:
+    {
+        const auto &l = static_cast<const SvgLine &>(element);
+        m_lines.x1[slot] = l.x1;
+        m_lines.y1[slot] = l.y1;
+        m_lines.x2[slot] = l.x2;
+        m_lines.y2[slot] = l.y2;
+        break;
+    }
+    case Kind::Rect:
+    {
+        const auto &r = static_cast<const SvgRect &>(element);
+        m_rects.x[slot] = r.x;
+        m_rects.y[slot] = r.y;
+        m_rects.w[slot] = r.w;
+        m_rects.h[slot] = r.h;
+        break;
+    }
+    case Kind::Circle:
+    {
+        const auto &c = static_cast<const SvgCircle &>(element);
+        m_circles.cx[slot] = c.cx;
+        m_circles.cy[slot] = c.cy;
+        m_circles.r[slot] = c.r;
+        break;
+    }
+    case Kind::Ellipse:
+    {
+        const auto &e = static_cast<const SvgEllipse &>(element);
+        m_ellipses.cx[slot] = e.cx;
+        m_ellipses.cy[slot] = e.cy;
+        m_ellipses.rx[slot] = e.rx;
+        m_ellipses.ry[slot] = e.ry;
+        break;
+    }
+    case Kind::Polyline:
+    {
+        const auto &pl = static_cast<const SvgPolyline &>(element);
+        SetPoints(m_polys, slot, reinterpret_cast<const float *>(pl.points.data()), pl.points.size() * 2);
+        break;
+    }
+    case Kind::Polygon:
+    {
+        const auto &pg = static_cast<const SvgPolygon &>(element);
+        SetPoints(m_polys, slot, reinterpret_cast<const float *>(pg.points.data()), pg.points.size() * 2);
+        break;
+    }
+    case Kind::Path:
+        m_paths.box[slot] = element.fillBox;
+        break;
+    case Kind::Text:
+        m_texts.box[slot] = element.fillBox;
+        break;
+    default:
+        break;
+    }
+    m_outsets[item] = Outset(m_kinds[item], m_document->GetStyles()[element.style]);
+}
+
+void SvgScene::UpdateWorlds(uint32_t item)
+{
+    const uint32_t end = GetEnd(item);
+    for (uint32_t i = item; i < end; ++i)
+    {
+        // Parents come first, so theirs is already up to date.
+        const uint32_t inherited = m_parents[i] != kNone ? m_worlds[m_parents[i]] : 0;
+        const SvgMatrix &transform = m_elements[i]->transform;
+        if (transform.IsIdentity())
+        {
+            m_worlds[i] = inherited;
+            continue;
+        }
+        // An item with a transform has a matrix of its own, unless it had
+        // none until now and still shares its parent's.
+        if (m_worlds[i] == inherited)
+        {
+            m_worlds[i] = static_cast<uint32_t>(m_matrices.size());
+            m_matrices.emplace_back();
+        }
+        m_matrices[m_worlds[i]] = m_matrices[inherited] * transform;
+    }
+}
+
+void SvgScene::Refold(uint32_t group)
+{
+    SvgBounds &bounds = group != kNone ? m_bounds[group] : m_sceneBounds;
+    const uint32_t end = group != kNone ? GetEnd(group) : static_cast<uint32_t>(m_kinds.size());
+    bounds = SvgBounds();
+    // The scene only keeps the stroked box.
+    SvgBounds fill;
+    for (uint32_t i = group != kNone ? group + 1 : m_firstDrawn; i < end; i = GetEnd(i))
+    {
+        bounds.Union(m_bounds[i]);
+        fill.Union(m_fillBounds[i]);
+    }
+    if (group != kNone)
+        m_fillBounds[group] = fill;
+}
+
+bool SvgScene::Propagate(uint32_t child, SvgBounds &before, SvgBounds &fillBefore)
+{
+    const uint32_t group = m_parents[child];
+    if (group == kNone)
+    {
+        // Use targets are not part of what the scene draws.
+        if (child < m_firstDrawn)
+            return false;
+        if (Inside(before, m_sceneBounds))
+            m_sceneBounds.Union(m_bounds[child]);
+        else
+            Refold(kNone);
+        return false;
+    }
+    const SvgBounds bounds = m_bounds[group], fill = m_fillBounds[group];
+    if (Inside(before, bounds) && Inside(fillBefore, fill))
+    {
+        m_bounds[group].Union(m_bounds[child]);
+        m_fillBounds[group].Union(m_fillBounds[child]);
+    }
+    else
+    {
+        Refold(group);
+    }
+    if (m_bounds[group] == bounds && m_fillBounds[group] == fill)
+        return false;
+    before = bounds;
+    fillBefore = fill;
+    return true;
+}
+
+SvgBounds SvgScene::Update(uint32_t item)
+{
+    SvgBounds damage = m_bounds[item];
+    SvgBounds fillBefore = m_fillBounds[item];
+    Reload(item);
+    UpdateWorlds(item);
+
+    // The item and its contents from scratch, as ComputeBounds does...
+    const uint32_t end = GetEnd(item);
+    for (uint32_t i = item; i < end; ++i)
+    {
+        if (m_kinds[i] == Kind::Group)
+            m_bounds[i] = m_fillBounds[i] = SvgBounds();
+        else if (m_kinds[i] == Kind::Use)
+            LeafUse(i);
+        else
+            Leaf(i, LocalBounds(i));
+    }
+    for (uint32_t i = end; i-- > item + 1;)
+    {
+        m_bounds[m_parents[i]].Union(m_bounds[i]);
+        m_fillBounds[m_parents[i]].Union(m_fillBounds[i]);
+    }
+
+    // ...then the groups around it, up to the first that comes out the
+    // same.
+    SvgBounds before = damage;
+    uint32_t child = item;
+    while (Propagate(child, before, fillBefore))
+        child = m_parents[child];
+
+    damage.Union(m_bounds[item]);
+    return damage;
+}
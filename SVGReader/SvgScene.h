@@ -0,0 +1,221 @@
+#ifndef _SVGSCENE_H_
+#define _SVGSCENE_H_
+
+#include "SvgElement.h"
+#include "SvgTransform.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class IRenderer;
+class SvgDocument;
+
+// A flat view of a document's element tree for traversals that visit many
+// elements: rendering with culling, bounds, area queries.
+//
+// Every element, groups included, is an item numbered in draw order, and
+// what traversals read about an item sits in arrays indexed by that number
+// (kind, parent, world matrix, bounds). A group's descendants are the items
+// [group + 1, end), so skipping a group is a jump instead of a walk.
+// Geometry is kept per kind, one array per field, and bounds are computed
+// by one loop over each kind. Paths and text, whose extent takes more than
+// their fields to find, keep the fillBox their element caches instead.
+//
+// The arrays serve bounds, queries and culling. Drawing still hands the
+// renderer each leaf's element, which is what IRenderer takes, so a render
+// of everything chases the same pointers a tree walk does and comes out
+// somewhat slower (svgreader_bench scene); the scene pays off where its
+// bounds let it skip work.
+//
+// Elements that <use> elements refer to get items of their own, once each
+// however many uses there are, ahead of the drawn items and outside any
+// group; a use's bounds are its target's under the use's transform.
+//
+// The scene points into the document and is only valid while that is
+// alive; build it after parsing (SvgDocument::ResolveStyles has run by
+// then). When an element changes, Update its item before drawing again
+// (SvgEditor does both). Const traversals may run on any number of
+// threads, but not alongside Update.
+class SvgScene
+{
+public:
+    enum class Kind : uint8_t
+    {
+        Group,
+        Line,
+        Rect,
+        Circle,
+        Ellipse,
+        Polyline,
+        Polygon,
+        Path,
+        Text,
+        Use
+    };
+
+    static constexpr uint32_t kNone = 0xFFFFFFFF;
+
+    SvgScene() = default;
+    explicit SvgScene(const SvgDocument &document);
+
+    const SvgDocument *GetDocument() const { return m_document; }
+    size_t Size() const { return m_kinds.size(); }
+    // Items before this one are use targets, only drawn through their uses.
+    uint32_t GetFirstDrawn() const { return m_firstDrawn; }
+    Kind GetKind(uint32_t item) const { return m_kinds[item]; }
+    const ISvgElement &GetElement(uint32_t item) const { return *m_elements[item]; }
+    uint32_t GetParent(uint32_t item) const { return m_parents[item]; }
+    // One past the last item inside item; item + 1 for anything but a group.
+    uint32_t GetEnd(uint32_t item) const;
+    // From the item's own space, its transform included, to document space
+    // (a use target's root space for items of a target).
+    const SvgMatrix &GetWorld(uint32_t item) const { return m_matrices[m_worlds[item]]; }
+    // The root item of a use's target, or kNone.
+    uint32_t GetTarget(uint32_t use) const { return m_uses.target[m_slots[use]]; }
+    // Document-space box around the item and everything in it, stroke
+    // included (with room for miter joins). Curves are bounded by their
+    // extrema; text gets the estimate of SvgText::UpdateFillBox.
+    const SvgBounds &GetBounds(uint32_t item) const { return m_bounds[item]; }
+    const SvgBounds &GetBounds() const { return m_sceneBounds; }
+    // The same without the stroke: what the item and its contents fill.
+    const SvgBounds &GetFillBounds(uint32_t item) const { return m_fillBounds[item]; }
+
+    // Draws every item, leaves from their elements.
+    void Render(IRenderer &renderer) const;
+    // Draws only what may show inside visible, a document-space box.
+    void Render(IRenderer &renderer, const SvgBounds &visible) const;
+    // Draws only items, leaf items in draw order as Query gives them, each
+    // inside the transforms of the groups around it.
+    void Render(IRenderer &renderer, const std::vector<uint32_t> &items) const;
+
+    // Appends the leaf items whose bounds meet area, in draw order.
+    void Query(const SvgBounds &area, std::vector<uint32_t> &items) const;
+    // The topmost leaf item whose bounds hold the document-space point, or
+    // kNone. Boxes only: a point in a circle's corner hits the circle.
+    uint32_t HitTest(float x, float y) const;
+
+    // Rereads the element of item after it changed (geometry, style or
+    // transform) and brings the bounds of it, its contents and the groups
+    // around it up to date. Returns the document-space area to repaint:
+    // the item's bounds before, united with its bounds now.
+    SvgBounds Update(uint32_t item);
+
+private:
+    // Each kind's Box(slot) is its untransformed, unstroked extent.
+    struct Lines
+    {
+        std::vector<uint32_t> item;
+        std::vector<float> x1, y1, x2, y2;
+        SvgBounds Box(size_t i) const;
+    };
+    struct Rects
+    {
+        std::vector<uint32_t> item;
+        std::vector<float> x, y, w, h;
+        SvgBounds Box(size_t i) const;
+    };
+    struct Circles
+    {
+        std::vector<uint32_t> item;
+        std::vector<float> cx, cy, r;
+        SvgBounds Box(size_t i) const;
+    };
+    struct Ellipses
+    {
+        std::vector<uint32_t> item;
+        std::vector<float> cx, cy, rx, ry;
+        SvgBounds Box(size_t i) const;
+    };
+    // Polylines and polygons: a range of m_points, and the room it may
+    // grow into in place, up to room.
+    struct PointRuns
+    {
+        std::vector<uint32_t> item;
+        std::vector<uint32_t> begin, end, room;
+        SvgBounds Box(size_t i, const std::vector<float> &points) const;
+    };
+    // Paths and text: their element's fillBox.
+    struct Boxed
+    {
+        std::vector<uint32_t> item;
+        std::vector<SvgBounds> box;
+        SvgBounds Box(size_t i) const { return box[i]; }
+    };
+    struct Uses
+    {
+        std::vector<uint32_t> item;
+        std::vector<uint32_t> target;   // the target's item, or kNone
+    };
+
+    // Gives every element the uses in element refer to a root item, the
+    // targets of nested uses first.
+    void AddTargets(const ISvgElement &element);
+    void Add(const ISvgElement &element, uint32_t parent, uint32_t world);
+    uint32_t AddItem(Kind kind, uint32_t slot, const ISvgElement &element, uint32_t parent, uint32_t world, float outset);
+    void AddPoints(const float *coords, size_t count, Kind kind, const ISvgElement &element, uint32_t parent,
+                   uint32_t world, float outset);
+    void AddBoxed(Boxed &boxed, Kind kind, const ISvgElement &element, uint32_t parent, uint32_t world, float outset);
+    // Stores count coordinates as the run of slot, in place if they fit.
+    void SetPoints(PointRuns &runs, uint32_t slot, const float *coords, size_t count);
+    // Packs the runs together again, each with no room to spare.
+    void PackPoints(PointRuns &runs);
+    void ComputeBounds();
+    // Bounds of the items from root to its end, contents before containers.
+    void FoldRoot(uint32_t root);
+    SvgBounds LocalBounds(uint32_t item) const;
+    // Copies the element's geometry and stroke reach back into the arrays.
+    void Reload(uint32_t item);
+    // Recomputes the world matrices of item and everything in it.
+    void UpdateWorlds(uint32_t item);
+    // Unites the bounds of the items directly inside group (kNone: the
+    // scene) into its own.
+    void Refold(uint32_t group);
+    // Brings the group around child (or the scene) up to date after
+    // child's bounds changed from before and fillBefore. A child that grew
+    // or moved inside is united in; the group is only refolded if child
+    // was on its edge, as it may have shrunk. Returns whether the group
+    // changed, with its old bounds in before and fillBefore.
+    bool Propagate(uint32_t child, SvgBounds &before, SvgBounds &fillBefore);
+    // visible null: draw everything.
+    void Draw(IRenderer &renderer, const SvgBounds *visible) const;
+    // Hands the renderer what the document's elements refer to.
+    void Begin(IRenderer &renderer) const;
+    // Draws one item, a group by pushing its transform.
+    void DrawItem(IRenderer &renderer, uint32_t item) const;
+    // Sets the bounds of a leaf from its untransformed fill box.
+    void Leaf(uint32_t item, const SvgBounds &local);
+    // A use's are its target's under the use's world matrix.
+    void LeafUse(uint32_t item);
+
+    const SvgDocument *m_document = nullptr;
+    uint32_t m_firstDrawn = 0;
+    std::unordered_map<const ISvgElement *, uint32_t> m_targets;
+
+    // Per item, in draw order.
+    std::vector<Kind> m_kinds;
+    std::vector<uint32_t> m_slots;      // index into the kind's arrays
+    std::vector<uint32_t> m_parents;    // enclosing group item, or kNone
+    std::vector<uint32_t> m_worlds;     // index into m_matrices
+    std::vector<float> m_outsets;       // how far the stroke reaches past the geometry
+    std::vector<SvgBounds> m_bounds;
+    std::vector<SvgBounds> m_fillBounds;
+    std::vector<const ISvgElement *> m_elements;
+
+    std::vector<SvgMatrix> m_matrices;  // [0] is the identity
+    std::vector<uint32_t> m_groupEnds;  // per group slot
+
+    Lines m_lines;
+    Rects m_rects;
+    Circles m_circles;
+    Ellipses m_ellipses;
+    PointRuns m_polys;                  // polylines and polygons
+    Boxed m_paths;
+    Boxed m_texts;
+    Uses m_uses;
+    std::vector<float> m_points;        // x, y pairs
+    size_t m_abandonedPoints = 0;       // left behind by runs that moved
+
+    SvgBounds m_sceneBounds;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#include "stdafx.h"
+#include "SvgSnapshot.h"
+
+SvgSnapshot::SvgSnapshot(SvgDocument &&document)
+    : m_document(std::move(document)), m_scene(m_document), m_displayList(m_scene)
+{
+}
+
+std::shared_ptr<const SvgSnapshot> SvgSnapshot::Freeze(SvgDocument &&document)
+{
+    // The constructor is private, which rules out make_shared.
+    std::shared_ptr<const SvgSnapshot> snapshot(new SvgSnapshot(std::move(document)));
+    document = SvgDocument();
+    return snapshot;
+}
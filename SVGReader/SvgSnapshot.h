@@ -0,0 +1,47 @@
+#ifndef _SVGSNAPSHOT_H_
+#define _SVGSNAPSHOT_H_
+
+#include "SvgDisplayList.h"
+#include "SvgDocument.h"
+#include "SvgScene.h"
+#include <memory>
+
+// A finished document and its scene, frozen: nothing reachable from a
+// snapshot changes again, so one can be shared between threads and drawn
+// by any number of renderers at once, each into its own target (sizes,
+// tiles, crops). Renderers only borrow what they read from it.
+//
+// Build the document, then hand it over with Freeze; the snapshot lives as
+// long as its last shared_ptr.
+class SvgSnapshot
+{
+public:
+    // Takes over document, which a parser must have completed (its styles
+    // and gradients resolved). document is left empty.
+    static std::shared_ptr<const SvgSnapshot> Freeze(SvgDocument &&document);
+
+    SvgSnapshot(const SvgSnapshot &) = delete;
+    SvgSnapshot &operator=(const SvgSnapshot &) = delete;
+
+    const SvgDocument &GetDocument() const { return m_document; }
+    const SvgScene &GetScene() const { return m_scene; }
+    // The scene compiled for repeated drawing.
+    const SvgDisplayList &GetDisplayList() const { return m_displayList; }
+    float GetWidth() const { return m_document.GetWidth(); }
+    float GetHeight() const { return m_document.GetHeight(); }
+
+    void Render(IRenderer &renderer) const { m_scene.Render(renderer); }
+    // Draws only what may show inside visible, a document-space box.
+    void Render(IRenderer &renderer, const SvgBounds &visible) const { m_scene.Render(renderer, visible); }
+
+private:
+    explicit SvgSnapshot(SvgDocument &&document);
+
+    // The scene and list point into the document, so the snapshot never
+    // moves.
+    SvgDocument m_document;
+    SvgScene m_scene;
+    SvgDisplayList m_displayList;
+};
+
+#endif
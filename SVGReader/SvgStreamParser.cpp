@@ -0,0 +1,631 @@
+#include "stdafx.h"
+#include "SvgStreamParser.h"
+#include "SvgParser.h"
+#include "SvgNames.h"
+
+// The tokenizer below follows what rapidxml does with parse<0>, so that both
+// parse paths accept the same documents and see the same attribute values
+// and text: entities are expanded the same way, whitespace-only text runs
+// are not nodes, and RapidXmlNodeAdapter::getTextContent() returns the value
+// of the first child node (a text run, a CDATA section, or an element whose
+// value is its own first text run).
+namespace
+{
+    bool IsWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool IsWhitespace(std::string_view s)
+    {
+        for (char c : s)
+            if (!IsWhitespace(c))
+                return false;
+        return true;
+    }
+
+    // Anything but space \n \r \t / > ? \0
+    bool IsNameChar(char c)
+    {
+        return !IsWhitespace(c) && c != '/' && c != '>' && c != '?' && c != '\0';
+    }
+
+    // Anything but space \n \r \t / < > = ? ! \0
+    bool IsAttributeNameChar(char c)
+    {
+        return IsNameChar(c) && c != '<' && c != '=' && c != '!';
+    }
+
+    unsigned DigitValue(char c)
+    {
+        if (c >= '0' && c <= '9') return static_cast<unsigned>(c - '0');
+        if (c >= 'a' && c <= 'f') return static_cast<unsigned>(c - 'a' + 10);
+        if (c >= 'A' && c <= 'F') return static_cast<unsigned>(c - 'A' + 10);
+        return 0xFF;
+    }
+
+    bool AppendCodePoint(std::string &out, unsigned long code)
+    {
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x110000)
+        {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // Appends s to out with the five predefined entities and numeric
+    // character references expanded. Unknown entities are copied verbatim.
+    bool AppendDecoded(std::string &out, std::string_view s)
+    {
+        size_t amp = s.find('&');
+        if (amp == std::string_view::npos)
+        {
+            out.append(s);
+            return true;
+        }
+
+        out.reserve(out.size() + s.size());
+        size_t i = 0;
+        while (i < s.size())
+        {
+            if (s[i] != '&')
+            {
+                out += s[i++];
+                continue;
+            }
+
+            std::string_view rest = s.substr(i);
+            if (rest.starts_with("&amp;")) { out += '&'; i += 5; continue; }
+            if (rest.starts_with("&apos;")) { out += '\''; i += 6; continue; }
+            if (rest.starts_with("&quot;")) { out += '"'; i += 6; continue; }
+            if (rest.starts_with("&gt;")) { out += '>'; i += 4; continue; }
+            if (rest.starts_with("&lt;")) { out += '<'; i += 4; continue; }
+            if (rest.starts_with("&#"))
+            {
+                bool hex = rest.size() > 2 && rest[2] == 'x';
+                unsigned long base = hex ? 16 : 10;
+                i += hex ? 3 : 2;
+                unsigned long code = 0;
+                // Like rapidxml, digits are looked up in one hex table for
+                // both forms.
+                while (i < s.size() && DigitValue(s[i]) != 0xFF)
+                    code = code * base + DigitValue(s[i++]);
+                if (!AppendCodePoint(out, code))
+                    return false;
+                if (i >= s.size() || s[i] != ';')
+                    return false;
+                ++i;
+                continue;
+            }
+            out += s[i++];
+        }
+        return true;
+    }
+}
+
+void SvgStreamNode::Reset(std::string_view tag)
+{
+    m_tag.assign(tag);
+    m_text.clear();
+    m_attributeCount = 0;
+    children.clear();
+}
+
+std::string &SvgStreamNode::AddAttribute(std::string_view name)
+{
+    if (m_attributeCount == m_attributes.size())
+        m_attributes.emplace_back();
+    auto &attribute = m_attributes[m_attributeCount++];
+    attribute.first.assign(name);
+    attribute.second.clear();
+    return attribute.second;
+}
+
+std::string_view SvgStreamNode::getAttribute(std::string_view name) const
+{
+    for (size_t i = 0; i < m_attributeCount; ++i)
+    {
+        if (m_attributes[i].first == name)
+            return m_attributes[i].second;
+    }
+    return {};
+}
+
+void SvgStreamNode::forEachChild(XMLChildVisitor visitor) const
+{
+    for (const auto &child : children)
+        visitor(child);
+}
+
+void SvgStreamNode::forEachAttribute(XMLAttributeVisitor visitor) const
+{
+    for (size_t i = 0; i < m_attributeCount; ++i)
+        visitor(m_attributes[i].first, m_attributes[i].second);
+}
+
+SvgStreamParser::SvgStreamParser(const SvgParser &parser)
+    : m_parser(parser)
+{
+}
+
+bool SvgStreamParser::Feed(std::string_view chunk)
+{
+    if (m_failed)
+        return false;
+
+    // Parse straight out of the caller's chunk when nothing is carried over,
+    // and only keep the unfinished tail.
+    if (m_pending.empty())
+    {
+        size_t used = Consume(chunk, false);
+        m_pending.assign(chunk.substr(used));
+    }
+    else
+    {
+        m_pending.append(chunk);
+        size_t used = Consume(m_pending, false);
+        m_pending.erase(0, used);
+    }
+    return !m_failed;
+}
+
+bool SvgStreamParser::Finish(SvgDocument &document)
+{
+    if (!m_failed)
+    {
+        size_t used = Consume(m_pending, true);
+        m_pending.erase(0, used);
+    }
+    if (m_failed || !m_pending.empty() || !m_stack.empty() || !m_seenRoot)
+        return Fail();
+
+    m_document.ResolveGradients();
+    m_document.ResolveUses();
+    m_document.ResolveStyles();
+    m_document.ResolveBounds();
+    document = std::move(m_document);
+    return true;
+}
+
+bool SvgStreamParser::Fail()
+{
+    m_failed = true;
+    return false;
+}
+
+bool SvgStreamParser::WantsText() const
+{
+    if (m_stack.empty() || m_textDecided)
+        return false;
+    Frame frame = m_stack.back().frame;
+    return frame == Frame::Text || frame == Frame::Style || frame == Frame::TextChild;
+}
+
+// Consumes as many complete tokens as input holds and returns how many bytes
+// were used. The rest is an unfinished token that needs the next chunk.
+size_t SvgStreamParser::Consume(std::string_view input, bool atEnd)
+{
+    size_t pos = 0;
+    if (!m_started)
+    {
+        static constexpr std::string_view bom = "\xEF\xBB\xBF";
+        if (!atEnd && input.size() < bom.size() && bom.starts_with(input))
+            return 0;
+        if (input.starts_with(bom))
+            pos = bom.size();
+        m_started = true;
+    }
+
+    while (pos < input.size() && !m_failed)
+    {
+        if (input[pos] != '<')
+        {
+            size_t lt = input.find('<', pos);
+            if (lt == std::string_view::npos)
+            {
+                // A text run we still need has to be seen whole; anything
+                // else can be dropped right away.
+                if (WantsText() && !atEnd)
+                    return pos;
+                lt = input.size();
+            }
+
+            std::string_view run = input.substr(pos, lt - pos);
+            if (m_stack.empty())
+            {
+                if (!IsWhitespace(run))
+                {
+                    Fail();
+                    return pos;
+                }
+            }
+            else if (WantsText() && !IsWhitespace(run))
+            {
+                std::string text;
+                if (!AppendDecoded(text, run))
+                {
+                    Fail();
+                    return pos;
+                }
+                m_buffered.SetText(std::move(text));
+                m_textDecided = true;
+            }
+            pos = lt;
+            continue;
+        }
+
+        size_t used = ConsumeMarkup(input.substr(pos), atEnd);
+        if (used == 0)
+            break;
+        pos += used;
+        m_scanned = 0;
+        m_scanQuote = 0;
+    }
+    return pos;
+}
+
+// Handles one '<...>' token at the start of rest. Returns its length, or 0
+// when it is not complete yet (or is malformed, which sets m_failed).
+size_t SvgStreamParser::ConsumeMarkup(std::string_view rest, bool atEnd)
+{
+    auto needMore = [&]() -> size_t {
+        m_scanned = rest.size();
+        if (atEnd)
+            Fail();
+        return 0;
+    };
+    auto until = [&](std::string_view terminator, size_t from) -> size_t {
+        if (m_scanned >= from + terminator.size())
+            from = m_scanned - terminator.size() + 1;
+        size_t at = rest.find(terminator, from);
+        return at == std::string_view::npos ? 0 : at + terminator.size();
+    };
+    auto isPrefixOf = [&](std::string_view token) {
+        return rest.size() <= token.size() && token.starts_with(rest);
+    };
+
+    if (rest.size() < 2)
+        return needMore();
+
+    if (rest[1] == '/')
+    {
+        size_t gt = rest.find('>', 2);
+        if (gt == std::string_view::npos)
+            return needMore();
+        size_t i = 2;
+        while (i < gt && IsNameChar(rest[i]))
+            ++i;
+        while (i < gt && IsWhitespace(rest[i]))
+            ++i;
+        if (i != gt || m_stack.empty())
+        {
+            Fail();
+            return 0;
+        }
+        EndElement();
+        return gt + 1;
+    }
+
+    if (rest[1] == '?')
+    {
+        // XML declaration or processing instruction
+        size_t used = until("?>", 2);
+        return used ? used : needMore();
+    }
+
+    if (rest[1] == '!')
+    {
+        size_t used = 0;
+        if (rest.starts_with("<!--"))
+        {
+            used = until("-->", 4);
+        }
+        else if (rest.starts_with("<![CDATA["))
+        {
+            used = until("]]>", 9);
+            // Counts as the first child of <text>, but never as a text run.
+            if (used && !m_textDecided && !m_stack.empty() &&
+                (m_stack.back().frame == Frame::Text || m_stack.back().frame == Frame::Style))
+            {
+                m_buffered.SetText(std::string(rest.substr(9, used - 12)));
+                m_textDecided = true;
+            }
+        }
+        else if (rest.starts_with("<!DOCTYPE") && rest.size() > 9 && IsWhitespace(rest[9]))
+        {
+            // '>' inside the internal subset [...] does not end the doctype.
+            size_t i = 10;
+            while (i < rest.size() && used == 0)
+            {
+                if (rest[i] == '>')
+                {
+                    used = i + 1;
+                }
+                else if (rest[i] == '[')
+                {
+                    int depth = 1;
+                    for (++i; i < rest.size() && depth > 0; ++i)
+                    {
+                        if (rest[i] == '[') ++depth;
+                        else if (rest[i] == ']') --depth;
+                    }
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        else if (isPrefixOf("<!--") || isPrefixOf("<![CDATA[") || isPrefixOf("<!DOCTYPE"))
+        {
+            return needMore();
+        }
+        else
+        {
+            used = until(">", 2);
+        }
+        return used ? used : needMore();
+    }
+
+    // Start tag; a '>' inside a quoted attribute value does not end it.
+    size_t i = (std::max)(m_scanned, size_t(1));
+    char quote = m_scanQuote;
+    for (; i < rest.size(); ++i)
+    {
+        char c = rest[i];
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if (c == '>')
+        {
+            break;
+        }
+    }
+    if (i == rest.size())
+    {
+        m_scanQuote = quote;
+        return needMore();
+    }
+
+    bool selfClosing = false;
+    if (!ParseStartTag(rest.substr(1, i - 1), selfClosing))
+    {
+        Fail();
+        return 0;
+    }
+    StartElement();
+    if (selfClosing)
+        EndElement();
+    return i + 1;
+}
+
+// Fills m_node from the text between '<' and '>'.
+bool SvgStreamParser::ParseStartTag(std::string_view body, bool &selfClosing)
+{
+    const size_t n = body.size();
+    auto skipWhitespace = [&](size_t &i) {
+        while (i < n && IsWhitespace(body[i]))
+            ++i;
+    };
+
+    size_t i = 0;
+    while (i < n && IsNameChar(body[i]))
+        ++i;
+    if (i == 0)
+        return false;
+    m_node.Reset(body.substr(0, i));
+
+    skipWhitespace(i);
+    while (i < n && IsAttributeNameChar(body[i]))
+    {
+        size_t nameStart = i;
+        while (i < n && IsAttributeNameChar(body[i]))
+            ++i;
+        std::string_view name = body.substr(nameStart, i - nameStart);
+
+        skipWhitespace(i);
+        if (i >= n || body[i] != '=')
+            return false;
+        ++i;
+        skipWhitespace(i);
+        if (i >= n || (body[i] != '"' && body[i] != '\''))
+            return false;
+
+        char quote = body[i++];
+        size_t close = body.find(quote, i);
+        if (close == std::string_view::npos)
+            return false;
+        if (!AppendDecoded(m_node.AddAttribute(name), body.substr(i, close - i)))
+            return false;
+        i = close + 1;
+        skipWhitespace(i);
+    }
+
+    selfClosing = false;
+    if (i == n)
+        return true;
+    if (body[i] == '/' && i + 1 == n)
+    {
+        selfClosing = true;
+        return true;
+    }
+    return false;
+}
+
+// Mirrors SvgParser::ParseChildren: what an element turns into depends on
+// the element it sits in.
+void SvgStreamParser::StartElement()
+{
+    const SvgTag tag = LookupSvgTag(m_node.getTagName());
+    OpenElement open{Frame::Skip, nullptr};
+
+    if (m_stack.empty())
+    {
+        // Only the first top-level <svg> is rendered, like first_node("svg").
+        if (!m_seenRoot && tag == SvgTag::Svg)
+        {
+            m_seenRoot = true;
+            m_parser.ParseRootSize(m_node, m_document);
+            open.frame = Frame::Root;
+            PushAncestor();
+        }
+        m_stack.push_back(open);
+        return;
+    }
+
+    const OpenElement &parent = m_stack.back();
+    auto addToParent = [&](ISvgElement *element) {
+        if (!element)
+            return;
+        if (parent.group)
+            parent.group->AddChild(element);
+        else
+            m_document.AddElement(element);
+    };
+
+    switch (parent.frame)
+    {
+    case Frame::Root:
+    case Frame::Group:
+        switch (tag)
+        {
+        case SvgTag::LinearGradient:
+        case SvgTag::RadialGradient:
+            m_buffered = m_node;
+            open.frame = Frame::Gradient;
+            break;
+        case SvgTag::Defs:
+        {
+            // Built like a group but kept out of the drawing, for <use>.
+            SvgGroup *defs = m_document.GetArena().Create<SvgGroup>();
+            m_document.AddDefinition(defs);
+            open.frame = Frame::Group;
+            open.group = defs;
+            PushAncestor();
+            break;
+        }
+        case SvgTag::Symbol:
+        {
+            SvgSymbol *symbol = m_parser.CreateSymbol(m_node, m_style, m_document);
+            m_document.AddDefinition(symbol);
+            open.frame = Frame::Group;
+            open.group = symbol;
+            PushAncestor();
+            break;
+        }
+        case SvgTag::G:
+        {
+            SvgGroup *group = m_parser.CreateGroup(m_node, m_style, m_document);
+            open.frame = Frame::Group;
+            open.group = group;
+            addToParent(group);
+            PushAncestor();
+            break;
+        }
+        case SvgTag::Style:
+            m_buffered = m_node;
+            m_textDecided = false;
+            open.frame = Frame::Style;
+            break;
+        case SvgTag::Text:
+            // Needs its content, so it is built at the end tag.
+            m_buffered = m_node;
+            m_textDecided = false;
+            open.frame = Frame::Text;
+            break;
+        default:
+            addToParent(m_parser.factory.CreateElement(m_node, m_style, m_document));
+            break;
+        }
+        break;
+    case Frame::Gradient:
+        if (tag == SvgTag::Stop)
+            m_buffered.children.push_back(m_node);
+        break;
+    case Frame::Text:
+    case Frame::Style:
+        if (!m_textDecided)
+            open.frame = Frame::TextChild;
+        break;
+    default:
+        break;
+    }
+
+    m_stack.push_back(open);
+}
+
+// Keeps a copy of the start tag in m_node as the innermost ancestor.
+void SvgStreamParser::PushAncestor()
+{
+    const size_t depth = m_style.ancestors.size();
+    if (depth == m_ancestorNodes.size())
+        m_ancestorNodes.push_back(std::make_unique<SvgStreamNode>());
+    SvgStreamNode &copy = *m_ancestorNodes[depth];
+    copy = m_node;
+    m_style.ancestors.emplace_back(copy);
+}
+
+void SvgStreamParser::EndElement()
+{
+    const OpenElement open = m_stack.back();
+    m_stack.pop_back();
+
+    switch (open.frame)
+    {
+    case Frame::Root:
+    case Frame::Group:
+        m_style.ancestors.pop_back();
+        break;
+    case Frame::Gradient:
+        m_parser.ParseGradient(m_buffered, m_document, m_style);
+        break;
+    case Frame::Style:
+        SvgParser::ParseStyleElement(m_buffered, m_sheet);
+        break;
+    case Frame::TextChild:
+        m_textDecided = true;
+        break;
+    case Frame::Text:
+    {
+        ISvgElement *element = m_parser.factory.CreateElement(m_buffered, m_style, m_document);
+        if (!element)
+            break;
+        SvgGroup *group = m_stack.back().group;
+        if (group)
+            group->AddChild(element);
+        else
+            m_document.AddElement(element);
+        break;
+    }
+    default:
+        break;
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef _SVGSTREAMPARSER_H_
+#define _SVGSTREAMPARSER_H_
+
+#include "stdafx.h"
+#include "SvgDocument.h"
+#include "IXMLNode.h"
+#include "SvgStyleSheet.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class SvgParser;
+class SvgGroup;
+
+// Owned element used by the streaming parser. Only the start tag is kept
+// (plus the text content and, for gradients, the stop children), and the
+// strings are reused from tag to tag so steady-state parsing does not
+// allocate.
+class SvgStreamNode : public IXMLNode
+{
+public:
+    void Reset(std::string_view tag);
+    std::string &AddAttribute(std::string_view name);
+    void SetText(std::string text) { m_text = std::move(text); }
+
+    std::string_view getTagName() const override { return m_tag; }
+    std::string_view getAttribute(std::string_view name) const override;
+    std::string_view getTextContent() const override { return m_text; }
+    void forEachChild(XMLChildVisitor visitor) const override;
+    void forEachAttribute(XMLAttributeVisitor visitor) const override;
+
+    std::vector<SvgStreamNode> children;
+
+private:
+    std::string m_tag;
+    std::string m_text;
+    // Entries past m_attributeCount are stale and only kept for capacity.
+    std::vector<std::pair<std::string, std::string>> m_attributes;
+    size_t m_attributeCount = 0;
+};
+
+// Event-driven alternative to the DOM walk in SvgParser. Bytes are pushed in
+// with Feed() in chunks of any size and elements are built as their tags go
+// past, so memory is the unfinished token at the end of the last chunk, the
+// open-element stack and the one gradient or text element waiting for its
+// end tag. The document produced is the same as SvgParser::Parse builds from
+// the rapidxml DOM for the same input, with one exception: elements are
+// final once built, so a <style> element only applies to what comes after
+// it. Stylesheets normally sit at the top of the file anyway.
+class SvgStreamParser
+{
+public:
+    explicit SvgStreamParser(const SvgParser &parser);
+
+    // Returns false once the input is known to be malformed; further calls
+    // are ignored.
+    bool Feed(std::string_view chunk);
+
+    // Ends the input. On success the finished document replaces document;
+    // on failure document is left untouched.
+    bool Finish(SvgDocument &document);
+
+private:
+    enum class Frame : uint8_t
+    {
+        Skip,       // content is ignored (shapes, unknown tags, stops...)
+        Root,
+        Group,      // <g>, and <defs> and <symbol> building definitions
+        Gradient,
+        Text,
+        Style,
+        TextChild   // first child of <text> or <style>; its own text becomes the content
+    };
+
+    struct OpenElement
+    {
+        Frame frame;
+        SvgGroup *group;
+    };
+
+    size_t Consume(std::string_view input, bool atEnd);
+    size_t ConsumeMarkup(std::string_view input, bool atEnd);
+    bool ParseStartTag(std::string_view body, bool &selfClosing);
+    void StartElement();
+    void EndElement();
+    void PushAncestor();
+    bool WantsText() const;
+    bool Fail();
+
+    const SvgParser &m_parser;
+    SvgDocument m_document;
+    std::string m_pending;
+    // How far into the unfinished token at the front of m_pending the last
+    // scan got, so a token spread over many chunks is not rescanned.
+    size_t m_scanned = 0;
+    char m_scanQuote = 0;
+    std::vector<OpenElement> m_stack;
+    SvgStreamNode m_node;
+    SvgStreamNode m_buffered;
+    SvgStyleSheet m_sheet;
+    // Copies of the open <svg>, <g>, <defs> and <symbol> start tags for selector
+    // matching. Entries are reused from element to element and only ever
+    // added, and each sits behind its own pointer so the views in
+    // m_style.ancestors stay put.
+    std::vector<std::unique_ptr<SvgStreamNode>> m_ancestorNodes;
+    SvgStyleContext m_style{m_sheet, {}};
+    bool m_started = false;
+    bool m_seenRoot = false;
+    bool m_textDecided = false;
+    bool m_failed = false;
+};
+
+#endif
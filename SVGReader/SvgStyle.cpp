@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "SvgStyle.h"
+#include "SvgNames.h"
+#include <bit>
+
+namespace
+{
+    uint32_t Bits(float f)
+    {
+        return std::bit_cast<uint32_t>(f);
+    }
+
+    uint32_t Flags(const SvgStyle &s)
+    {
+        return static_cast<uint32_t>(s.hasInputFill) | static_cast<uint32_t>(s.hasInputStroke) << 1 |
+               static_cast<uint32_t>(s.hasInputStrokeWidth) << 2 | static_cast<uint32_t>(s.hasInputFillOpacity) << 3 |
+               static_cast<uint32_t>(s.hasInputStrokeOpacity) << 4 | static_cast<uint32_t>(s.evenOddFill) << 5 |
+               static_cast<uint32_t>(s.textAnchor) << 6;
+    }
+}
+
+bool SvgStyle::operator==(const SvgStyle &other) const
+{
+    return fillColor.GetValue() == other.fillColor.GetValue() &&
+           strokeColor.GetValue() == other.strokeColor.GetValue() &&
+           Bits(strokeWidth) == Bits(other.strokeWidth) && Bits(fillOpacity) == Bits(other.fillOpacity) &&
+           Bits(strokeOpacity) == Bits(other.strokeOpacity) && Bits(fontSize) == Bits(other.fontSize) &&
+           fillUrl == other.fillUrl && fontFamily == other.fontFamily && Flags(*this) == Flags(other);
+}
+
+size_t SvgStyleTable::StyleHash::operator()(const SvgStyle &s) const
+{
+    // FNV-1a over the fields operator== compares.
+    const uint32_t words[] = {s.fillColor.GetValue(), s.strokeColor.GetValue(), Bits(s.strokeWidth),
+                              Bits(s.fillOpacity), Bits(s.strokeOpacity), Bits(s.fontSize),
+                              s.fillUrl, s.fontFamily, Flags(s)};
+    uint64_t h = 14695981039346656037ull;
+    for (uint32_t w : words)
+        h = (h ^ w) * 1099511628211ull;
+    return static_cast<size_t>(h);
+}
+
+size_t SvgStyleTable::StringHash::operator()(std::string_view s) const
+{
+    return SvgNames::Hash(s, 0);
+}
+
+SvgStyleTable::SvgStyleTable()
+{
+    Intern(SvgStyle());
+    InternString({});
+}
+
+uint32_t SvgStyleTable::Intern(const SvgStyle &style)
+{
+    auto [it, added] = m_styleIds.try_emplace(style, static_cast<uint32_t>(m_styles.size()));
+    if (added)
+        m_styles.push_back(style);
+    return it->second;
+}
+
+bool SvgStyleTable::Find(const SvgStyle &style, uint32_t &index) const
+{
+    auto it = m_styleIds.find(style);
+    if (it == m_styleIds.end())
+        return false;
+    index = it->second;
+    return true;
+}
+
+void SvgStyleTable::Reuse(uint32_t index, const SvgStyle &style)
+{
+    auto it = m_styleIds.find(m_styles[index]);
+    if (it != m_styleIds.end() && it->second == index)
+        m_styleIds.erase(it);
+    m_styles[index] = style;
+    m_styleIds.emplace(style, index);
+}
+
+uint32_t SvgStyleTable::InternString(std::string_view s)
+{
+    auto it = m_stringIds.find(s);
+    if (it != m_stringIds.end())
+        return it->second;
+    const uint32_t id = static_cast<uint32_t>(m_strings.size());
+    m_stringIds.emplace(m_strings.emplace_back(s), id);
+    return id;
+}
+
+SvgStyleTable::Remap SvgStyleTable::Merge(const SvgStyleTable &other)
+{
+    Remap remap;
+    remap.strings.resize(other.m_strings.size());
+    for (size_t i = 0; i < remap.strings.size(); ++i)
+        remap.strings[i] = InternString(other.m_strings[i]);
+
+    remap.styles.resize(other.m_styles.size());
+    for (size_t i = 0; i < remap.styles.size(); ++i)
+    {
+        SvgStyle style = other.m_styles[i];
+        style.fillUrl = remap.strings[style.fillUrl];
+        style.fontFamily = remap.strings[style.fontFamily];
+        remap.styles[i] = Intern(style);
+    }
+    return remap;
+}
+
+size_t SvgStyleTable::MemoryUsage() const
+{
+    // Hash nodes are counted as the entry plus a next pointer, and one
+    // bucket pointer per bucket.
+    size_t bytes = m_styles.capacity() * sizeof(SvgStyle);
+    bytes += m_styleIds.size() * (sizeof(std::pair<const SvgStyle, uint32_t>) + sizeof(void *));
+    bytes += m_styleIds.bucket_count() * sizeof(void *);
+    for (const std::string &s : m_strings)
+    {
+        bytes += sizeof(std::string);
+        if (s.capacity() > std::string().capacity())
+            bytes += s.capacity() + 1;
+    }
+    bytes += m_stringIds.size() * (sizeof(std::pair<const std::string_view, uint32_t>) + sizeof(void *));
+    bytes += m_stringIds.bucket_count() * sizeof(void *);
+    return bytes;
+}
@@ -0,0 +1,109 @@
+#ifndef _SVGSTYLE_H_
+#define _SVGSTYLE_H_
+
+#include "SvgPlatform.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class SvgTextAnchor : uint8_t
+{
+    Start,
+    Middle,
+    End
+};
+
+// Paint, stroke and font properties of an element. Elements do not hold
+// these themselves: a document interns them in its SvgStyleTable, so all
+// the elements that look alike share one record, and each keeps only the
+// record's index. Strings are ids into the same table.
+//
+// Colours already carry their opacity (see SvgElementFactory). The
+// hasInput flags say which properties the element set itself, as opposed
+// to defaults; groups hand down only those (see ISvgElement::ResolveStyle).
+struct SvgStyle
+{
+    Gdiplus::Color fillColor{255, 0, 0, 0};
+    Gdiplus::Color strokeColor{0, 0, 0, 0};
+    float strokeWidth = 1.0f;
+    float fillOpacity = 1.0f;
+    float strokeOpacity = 1.0f;
+    float fontSize = 16.0f;
+    uint32_t fillUrl = 0;       // gradient id without the '#'; 0 is ""
+    uint32_t fontFamily = 0;    // first family named; "" means the default
+
+    bool hasInputFill = false;
+    bool hasInputStroke = false;
+    bool hasInputStrokeWidth = false;
+    bool hasInputFillOpacity = false;
+    bool hasInputStrokeOpacity = false;
+    bool evenOddFill = false;
+    SvgTextAnchor textAnchor = SvgTextAnchor::Start;
+
+    // Field by field, floats by their bits, so equal records hash alike.
+    bool operator==(const SvgStyle &other) const;
+};
+
+// A document's style records and strings, each stored once. Index 0 is
+// the default SvgStyle and string id 0 the empty string.
+//
+// Interning is not thread-safe; each thread that builds elements uses the
+// table of its own document part, and SvgDocument::AdoptStyles carries
+// them over. Reading is safe from any number of threads.
+class SvgStyleTable
+{
+public:
+    SvgStyleTable();
+    SvgStyleTable(const SvgStyleTable &) = delete;
+    SvgStyleTable &operator=(const SvgStyleTable &) = delete;
+    SvgStyleTable(SvgStyleTable &&) = default;
+    SvgStyleTable &operator=(SvgStyleTable &&) = default;
+
+    // Index of the record equal to style, added if there is none yet.
+    uint32_t Intern(const SvgStyle &style);
+    // Index of the record equal to style; false if there is none.
+    bool Find(const SvgStyle &style, uint32_t &index) const;
+    // Makes record index equal to style, which no record may be yet: for a
+    // record nothing refers to any more (see SvgEditor).
+    void Reuse(uint32_t index, const SvgStyle &style);
+    const SvgStyle &operator[](uint32_t index) const { return m_styles[index]; }
+    size_t Size() const { return m_styles.size(); }
+
+    uint32_t InternString(std::string_view s);
+    std::string_view GetString(uint32_t id) const { return m_strings[id]; }
+
+    // Where Merge put the records and strings of the other table, by their
+    // index there.
+    struct Remap
+    {
+        std::vector<uint32_t> styles;
+        std::vector<uint32_t> strings;
+    };
+
+    // Interns every record of other here, with its strings.
+    Remap Merge(const SvgStyleTable &other);
+
+    // Bytes held by the records, strings and their lookup tables.
+    size_t MemoryUsage() const;
+
+private:
+    struct StyleHash
+    {
+        size_t operator()(const SvgStyle &style) const;
+    };
+    struct StringHash
+    {
+        size_t operator()(std::string_view s) const;
+    };
+
+    std::vector<SvgStyle> m_styles;
+    std::unordered_map<SvgStyle, uint32_t, StyleHash> m_styleIds;
+    // A deque, so the views the lookup keys on stay put as it grows.
+    std::deque<std::string> m_strings;
+    std::unordered_map<std::string_view, uint32_t, StringHash> m_stringIds;
+};
+
+#endif
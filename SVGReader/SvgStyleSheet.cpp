@@ -0,0 +1,580 @@
+#include "stdafx.h"
+#include "SvgStyleSheet.h"
+#include "SvgAttributeTable.h"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    bool IsWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    std::string_view Trim(std::string_view s)
+    {
+        size_t first = 0;
+        while (first < s.size() && IsWhitespace(s[first]))
+            ++first;
+        size_t last = s.size();
+        while (last > first && IsWhitespace(s[last - 1]))
+            --last;
+        return s.substr(first, last - first);
+    }
+
+    // Identifier characters, without escapes.
+    bool IsNameChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    size_t NameLength(std::string_view s, size_t from)
+    {
+        size_t i = from;
+        while (i < s.size() && IsNameChar(s[i]))
+            ++i;
+        return i - from;
+    }
+
+    // Finds c at nesting level zero, skipping quoted strings and (...) groups.
+    size_t FindTopLevel(std::string_view s, char c, size_t from = 0)
+    {
+        int depth = 0;
+        char quote = 0;
+        for (size_t i = from; i < s.size(); ++i)
+        {
+            char ch = s[i];
+            if (quote)
+            {
+                if (ch == quote)
+                    quote = 0;
+            }
+            else if (ch == '"' || ch == '\'')
+                quote = ch;
+            else if (ch == '(')
+                ++depth;
+            else if (ch == ')' && depth > 0)
+                --depth;
+            else if (ch == c && depth == 0)
+                return i;
+        }
+        return std::string_view::npos;
+    }
+
+    // Index one past the '}' closing the block whose '{' is at open.
+    size_t SkipBlock(std::string_view s, size_t open)
+    {
+        int depth = 0;
+        for (size_t i = open; i < s.size(); ++i)
+        {
+            if (s[i] == '{')
+                ++depth;
+            else if (s[i] == '}' && --depth == 0)
+                return i + 1;
+        }
+        return s.size();
+    }
+
+    // Whether the whitespace-separated list holds token.
+    bool HasToken(std::string_view list, std::string_view token)
+    {
+        size_t i = 0;
+        while (i < list.size())
+        {
+            while (i < list.size() && IsWhitespace(list[i]))
+                ++i;
+            size_t start = i;
+            while (i < list.size() && !IsWhitespace(list[i]))
+                ++i;
+            if (i > start && list.substr(start, i - start) == token)
+                return true;
+        }
+        return false;
+    }
+
+    std::string StripComments(std::string_view css)
+    {
+        std::string out;
+        out.reserve(css.size());
+        size_t i = 0;
+        while (i < css.size())
+        {
+            size_t open = css.find("/*", i);
+            if (open == std::string_view::npos)
+            {
+                out.append(css.substr(i));
+                break;
+            }
+            out.append(css.substr(i, open - i));
+            out += ' ';
+            size_t close = css.find("*/", open + 2);
+            i = close == std::string_view::npos ? css.size() : close + 2;
+        }
+        return out;
+    }
+
+    // Matched selectors as (specificity << 32 | index), which sorts them into
+    // cascade order. Almost every element matches only a few rules, so they
+    // are kept inline and the heap is only touched past that.
+    class MatchList
+    {
+    public:
+        void Add(uint64_t key)
+        {
+            if (m_size < m_inline.size())
+                m_inline[m_size] = key;
+            else
+            {
+                if (m_heap.empty())
+                    m_heap.assign(m_inline.begin(), m_inline.end());
+                m_heap.push_back(key);
+            }
+            ++m_size;
+        }
+
+        uint64_t *begin() { return m_heap.empty() ? m_inline.data() : m_heap.data(); }
+        uint64_t *end() { return begin() + m_size; }
+        size_t size() const { return m_size; }
+
+    private:
+        std::array<uint64_t, 16> m_inline;
+        std::vector<uint64_t> m_heap;
+        size_t m_size = 0;
+    };
+}
+
+void SvgStyleSheet::Parse(std::string_view text)
+{
+    const std::string css = StripComments(text);
+    std::string_view s = css;
+
+    size_t pos = 0;
+    while (pos < s.size())
+    {
+        while (pos < s.size() && (IsWhitespace(s[pos]) || s[pos] == ';' || s[pos] == '}'))
+            ++pos;
+        if (pos >= s.size())
+            break;
+
+        size_t open = s.find('{', pos);
+        if (s[pos] == '@')
+        {
+            // @import and friends end at ';', @media and @font-face have a
+            // block. Neither contributes rules here.
+            size_t semicolon = s.find(';', pos);
+            if (semicolon != std::string_view::npos && (open == std::string_view::npos || semicolon < open))
+                pos = semicolon + 1;
+            else
+                pos = open == std::string_view::npos ? s.size() : SkipBlock(s, open);
+            continue;
+        }
+        if (open == std::string_view::npos)
+            break;
+
+        size_t close = s.find('}', open);
+        if (close == std::string_view::npos)
+            close = s.size();
+        std::string_view prelude = s.substr(pos, open - pos);
+        std::string_view block = s.substr(open + 1, close - open - 1);
+        pos = close + 1;
+
+        const uint32_t declBegin = static_cast<uint32_t>(m_declarations.size());
+        ParseDeclarations(block);
+        const uint32_t declEnd = static_cast<uint32_t>(m_declarations.size());
+        if (declBegin == declEnd)
+            continue;
+
+        // Parse the whole selector list before filing anything, since one bad
+        // selector invalidates the rule.
+        const size_t selectorsBefore = m_selectors.size();
+        const size_t compoundsBefore = m_compounds.size();
+        const size_t stringsBefore = m_strings.size();
+        const size_t attrTestsBefore = m_attrTests.size();
+        bool valid = true;
+        size_t start = 0;
+        while (valid)
+        {
+            size_t comma = FindTopLevel(prelude, ',', start);
+            valid = ParseSelector(prelude.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start),
+                                  declBegin, declEnd);
+            if (comma == std::string_view::npos)
+                break;
+            start = comma + 1;
+        }
+        if (!valid)
+        {
+            m_selectors.resize(selectorsBefore);
+            m_compounds.resize(compoundsBefore);
+            m_strings.resize(stringsBefore);
+            m_attrTests.resize(attrTestsBefore);
+            m_declarations.resize(declBegin);
+            continue;
+        }
+
+        for (size_t i = selectorsBefore; i < m_selectors.size(); ++i)
+        {
+            const Selector &selector = m_selectors[i];
+            const uint32_t index = static_cast<uint32_t>(i);
+            if (selector.compoundBegin == selector.compoundEnd)
+                continue;   // can never match
+            const Compound &key = m_compounds[selector.compoundEnd - 1];
+            if (key.id != kNone)
+                m_byId[m_strings[key.id]].push_back(index);
+            else if (key.classBegin != key.classEnd)
+                m_byClass[m_strings[key.classBegin]].push_back(index);
+            else if (key.tag != SvgTag::Unknown)
+                m_byTag[static_cast<size_t>(key.tag)].push_back(index);
+            else
+                m_universal.push_back(index);
+        }
+    }
+}
+
+void SvgStyleSheet::ParseDeclarations(std::string_view block)
+{
+    size_t start = 0;
+    while (start < block.size())
+    {
+        size_t end = FindTopLevel(block, ';', start);
+        if (end == std::string_view::npos)
+            end = block.size();
+        std::string_view item = block.substr(start, end - start);
+        start = end + 1;
+
+        size_t colon = item.find(':');
+        if (colon == std::string_view::npos)
+            continue;
+        SvgAttr attr = LookupSvgAttr(Trim(item.substr(0, colon)));
+        if (attr == SvgAttr::Count || attr == SvgAttr::Style)
+            continue;
+
+        std::string_view value = Trim(item.substr(colon + 1));
+        bool important = false;
+        size_t bang = value.rfind('!');
+        if (bang != std::string_view::npos && Trim(value.substr(bang + 1)) == "important")
+        {
+            important = true;
+            value = Trim(value.substr(0, bang));
+        }
+        if (!value.empty())
+            m_declarations.push_back({attr, important, std::string(value)});
+    }
+}
+
+bool SvgStyleSheet::ParseSelector(std::string_view text, uint32_t declBegin, uint32_t declEnd)
+{
+    Selector selector{static_cast<uint32_t>(m_compounds.size()), 0, declBegin, declEnd, 0};
+    bool matchesNothing = false;
+    bool expectCompound = true;     // at the start or right after '>'
+
+    size_t i = 0;
+    while (true)
+    {
+        while (i < text.size() && IsWhitespace(text[i]))
+            ++i;
+        if (i >= text.size())
+            break;
+
+        if (text[i] == '>')
+        {
+            if (expectCompound)
+                return false;
+            m_compounds.back().childOf = true;
+            expectCompound = true;
+            ++i;
+            continue;
+        }
+
+        // A compound runs to the next whitespace or combinator outside [...].
+        size_t start = i;
+        char quote = 0;
+        bool inBrackets = false;
+        for (; i < text.size(); ++i)
+        {
+            char c = text[i];
+            if (quote)
+            {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (inBrackets)
+            {
+                if (c == '"' || c == '\'')
+                    quote = c;
+                else if (c == ']')
+                    inBrackets = false;
+            }
+            else if (c == '[')
+                inBrackets = true;
+            else if (IsWhitespace(c) || c == '>' || c == '+' || c == '~')
+                break;
+        }
+        if (i == start)
+            return false;   // sibling combinators are not supported
+
+        Compound compound;
+        if (!ParseCompound(text.substr(start, i - start), compound, selector.specificity, matchesNothing))
+            return false;
+        m_compounds.push_back(compound);
+        expectCompound = false;
+    }
+    if (expectCompound)
+        return false;
+
+    // Keep the entry (it still has to be rolled back with the rule) but
+    // give it no compounds when it can never match.
+    selector.compoundEnd = static_cast<uint32_t>(m_compounds.size());
+    if (matchesNothing)
+        selector.compoundEnd = selector.compoundBegin;
+    m_selectors.push_back(selector);
+    return true;
+}
+
+bool SvgStyleSheet::ParseCompound(std::string_view text, Compound &compound, uint32_t &specificity, bool &matchesNothing)
+{
+    constexpr uint32_t kIdWeight = 1u << 20, kClassWeight = 1u << 10, kTagWeight = 1u;
+
+    size_t i = 0;
+    if (text[0] == '*')
+    {
+        i = 1;
+    }
+    else if (size_t n = NameLength(text, 0))
+    {
+        // A valid name we do not build is not an error, it just never matches.
+        compound.tag = LookupSvgTag(text.substr(0, n));
+        if (compound.tag == SvgTag::Unknown)
+            matchesNothing = true;
+        specificity += kTagWeight;
+        i = n;
+    }
+
+    compound.classBegin = compound.classEnd = static_cast<uint32_t>(m_strings.size());
+    compound.attrBegin = compound.attrEnd = static_cast<uint32_t>(m_attrTests.size());
+    std::string_view id;
+    while (i < text.size())
+    {
+        const char c = text[i++];
+        if (c == '#' || c == '.')
+        {
+            size_t n = NameLength(text, i);
+            if (n == 0)
+                return false;
+            std::string_view name = text.substr(i, n);
+            i += n;
+            if (c == '#')
+            {
+                if (!id.empty() && id != name)
+                    matchesNothing = true;
+                id = name;
+                specificity += kIdWeight;
+            }
+            else
+            {
+                // Classes are stored contiguously; the id goes in after them.
+                m_strings.emplace_back(name);
+                compound.classEnd = static_cast<uint32_t>(m_strings.size());
+                specificity += kClassWeight;
+            }
+        }
+        else if (c == '[')
+        {
+            size_t close = FindTopLevel(text, ']', i);
+            if (close == std::string_view::npos)
+                return false;
+            std::string_view body = Trim(text.substr(i, close - i));
+            i = close + 1;
+
+            size_t n = 0;
+            while (n < body.size() && (IsNameChar(body[n]) || body[n] == ':'))
+                ++n;
+            if (n == 0)
+                return false;
+            AttrTest test{std::string(body.substr(0, n)), {}, AttrMatch::Exists};
+            std::string_view rest = Trim(body.substr(n));
+            if (!rest.empty())
+            {
+                size_t opLength = 2;
+                switch (rest[0])
+                {
+                case '=': test.match = AttrMatch::Equals; opLength = 1; break;
+                case '~': test.match = AttrMatch::Includes; break;
+                case '|': test.match = AttrMatch::DashMatch; break;
+                case '^': test.match = AttrMatch::Prefix; break;
+                case '$': test.match = AttrMatch::Suffix; break;
+                case '*': test.match = AttrMatch::Substring; break;
+                default: return false;
+                }
+                if (opLength == 2 && (rest.size() < 2 || rest[1] != '='))
+                    return false;
+                std::string_view value = Trim(rest.substr(opLength));
+                if (!value.empty() && (value[0] == '"' || value[0] == '\''))
+                {
+                    if (value.size() < 2 || value.back() != value[0])
+                        return false;
+                    value = value.substr(1, value.size() - 2);
+                }
+                else if (value.empty() || NameLength(value, 0) != value.size())
+                {
+                    return false;
+                }
+                test.value = value;
+            }
+            m_attrTests.push_back(std::move(test));
+            compound.attrEnd = static_cast<uint32_t>(m_attrTests.size());
+            specificity += kClassWeight;
+        }
+        else
+        {
+            // Pseudo-classes, pseudo-elements, escapes...
+            return false;
+        }
+    }
+
+    if (!id.empty())
+    {
+        compound.id = static_cast<uint32_t>(m_strings.size());
+        m_strings.emplace_back(id);
+    }
+    return true;
+}
+
+bool SvgStyleSheet::MatchesCompound(const Compound &compound, const SvgStyleNode &node) const
+{
+    if (compound.tag != SvgTag::Unknown && compound.tag != node.tag)
+        return false;
+    if (compound.id != kNone && node.id != m_strings[compound.id])
+        return false;
+    for (uint32_t i = compound.classBegin; i < compound.classEnd; ++i)
+    {
+        if (!HasToken(node.classes, m_strings[i]))
+            return false;
+    }
+    for (uint32_t i = compound.attrBegin; i < compound.attrEnd; ++i)
+    {
+        const AttrTest &test = m_attrTests[i];
+        std::string_view value = node.node->getAttribute(test.name);
+        if (value.data() == nullptr)
+            return false;
+        bool ok = true;
+        switch (test.match)
+        {
+        case AttrMatch::Exists: break;
+        case AttrMatch::Equals: ok = value == test.value; break;
+        case AttrMatch::Includes: ok = HasToken(value, test.value); break;
+        case AttrMatch::DashMatch:
+            ok = value == test.value || (value.starts_with(test.value) && value.size() > test.value.size() &&
+                                         value[test.value.size()] == '-');
+            break;
+        case AttrMatch::Prefix: ok = !test.value.empty() && value.starts_with(test.value); break;
+        case AttrMatch::Suffix: ok = !test.value.empty() && value.ends_with(test.value); break;
+        case AttrMatch::Substring: ok = !test.value.empty() && value.find(test.value) != std::string_view::npos; break;
+        }
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+// Matches compounds [begin, end) against the ancestors, right to left. The
+// compound at end - 1 sits above the one already matched, and is its parent
+// if that pair is joined by '>'.
+bool SvgStyleSheet::MatchesAncestors(uint32_t begin, uint32_t end, std::span<const SvgStyleNode> ancestors) const
+{
+    if (begin == end)
+        return true;
+    const Compound &compound = m_compounds[end - 1];
+    if (compound.childOf)
+    {
+        return !ancestors.empty() && MatchesCompound(compound, ancestors.back()) &&
+               MatchesAncestors(begin, end - 1, ancestors.first(ancestors.size() - 1));
+    }
+
+    for (size_t i = ancestors.size(); i-- > 0;)
+    {
+        if (!MatchesCompound(compound, ancestors[i]))
+            continue;
+        if (MatchesAncestors(begin, end - 1, ancestors.first(i)))
+            return true;
+        // With a descendant combinator further left, the nearest match leaves
+        // the most ancestors to work with, so a farther one cannot do better.
+        // Only a '>' further left needs the other candidates tried.
+        if (end - 1 == begin || !m_compounds[end - 2].childOf)
+            return false;
+    }
+    return false;
+}
+
+bool SvgStyleSheet::Matches(const Selector &selector, const SvgStyleNode &element, std::span<const SvgStyleNode> ancestors) const
+{
+    return MatchesCompound(m_compounds[selector.compoundEnd - 1], element) &&
+           MatchesAncestors(selector.compoundBegin, selector.compoundEnd - 1, ancestors);
+}
+
+void SvgStyleSheet::Apply(const SvgStyleNode &element, std::span<const SvgStyleNode> ancestors, SvgAttributeTable &attrs) const
+{
+    if (Empty())
+    {
+        attrs.ApplyStyle();
+        return;
+    }
+
+    MatchList matches;
+    auto addCandidates = [&](const std::vector<uint32_t> &bucket) {
+        for (uint32_t index : bucket)
+        {
+            const Selector &selector = m_selectors[index];
+            if (Matches(selector, element, ancestors))
+                matches.Add((uint64_t(selector.specificity) << 32) | index);
+        }
+    };
+
+    if (!element.id.empty())
+    {
+        auto it = m_byId.find(element.id);
+        if (it != m_byId.end())
+            addCandidates(it->second);
+    }
+    if (!m_byClass.empty())
+    {
+        std::string_view classes = element.classes;
+        size_t i = 0;
+        while (i < classes.size())
+        {
+            while (i < classes.size() && IsWhitespace(classes[i]))
+                ++i;
+            size_t start = i;
+            while (i < classes.size() && !IsWhitespace(classes[i]))
+                ++i;
+            std::string_view name = classes.substr(start, i - start);
+            // A class listed twice must not match its rules twice.
+            if (name.empty() || HasToken(classes.substr(0, start), name))
+                continue;
+            auto it = m_byClass.find(name);
+            if (it != m_byClass.end())
+                addCandidates(it->second);
+        }
+    }
+    if (element.tag != SvgTag::Unknown)
+        addCandidates(m_byTag[static_cast<size_t>(element.tag)]);
+    addCandidates(m_universal);
+
+    std::sort(matches.begin(), matches.end());
+    auto applyDeclarations = [&](bool important) {
+        for (uint64_t key : matches)
+        {
+            const Selector &selector = m_selectors[static_cast<uint32_t>(key)];
+            for (uint32_t i = selector.declBegin; i < selector.declEnd; ++i)
+            {
+                const Declaration &declaration = m_declarations[i];
+                if (declaration.important == important)
+                    attrs.Set(declaration.attr, declaration.value);
+            }
+        }
+    };
+    applyDeclarations(false);
+    attrs.ApplyStyle();
+    applyDeclarations(true);
+}
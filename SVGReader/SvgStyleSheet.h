@@ -0,0 +1,146 @@
+#ifndef _SVGSTYLESHEET_H_
+#define _SVGSTYLESHEET_H_
+
+#include "IXMLNode.h"
+#include "SvgNames.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class SvgAttributeTable;
+
+// An element as selectors see it. The id and class list are read once up
+// front, since a descendant selector looks at the same ancestors again for
+// every element below them.
+struct SvgStyleNode
+{
+    SvgStyleNode(const IXMLNode &node, SvgTag tag, std::string_view id, std::string_view classes)
+        : node(&node), tag(tag), id(id), classes(classes)
+    {
+    }
+    explicit SvgStyleNode(const IXMLNode &node)
+        : SvgStyleNode(node, LookupSvgTag(node.getTagName()), node.getAttribute("id"), node.getAttribute("class"))
+    {
+    }
+
+    const IXMLNode *node;
+    SvgTag tag;
+    std::string_view id;
+    std::string_view classes;
+};
+
+// The rules of every <style> element of a document. Supported selectors are
+// type, universal, #id, .class and [attr], [attr=v], [attr~=v], [attr|=v],
+// [attr^=v], [attr$=v], [attr*=v], compounded and joined by descendant or
+// child combinators. A rule using anything else (pseudo-classes, sibling
+// combinators...) is dropped whole, as CSS requires, and at-rules are
+// skipped.
+//
+// Each selector is filed under the most specific part of its rightmost
+// compound: its id, else its first class, else its tag, else the universal
+// list. An element is then only tested against the rules filed under its
+// own id, classes and tag, so the cost of a match does not grow with the
+// size of the sheet.
+class SvgStyleSheet
+{
+public:
+    // Appends the rules of one <style> element.
+    void Parse(std::string_view css);
+
+    bool Empty() const { return m_selectors.empty(); }
+
+    // Runs the cascade for one element on top of its presentation
+    // attributes: matching rules in specificity and source order, then the
+    // style="" attribute, then !important rules. ancestors runs from the root
+    // down to the element's parent. Values point into this sheet, which must
+    // not change while attrs is in use.
+    void Apply(const SvgStyleNode &element, std::span<const SvgStyleNode> ancestors, SvgAttributeTable &attrs) const;
+
+private:
+    enum class AttrMatch : uint8_t
+    {
+        Exists,     // [a]
+        Equals,     // [a=v]
+        Includes,   // [a~=v]
+        DashMatch,  // [a|=v]
+        Prefix,     // [a^=v]
+        Suffix,     // [a$=v]
+        Substring   // [a*=v]
+    };
+
+    struct AttrTest
+    {
+        std::string name;
+        std::string value;
+        AttrMatch match;
+    };
+
+    // One compound selector, like rect.a#b[x]. Strings are ranges into the
+    // sheet's pools so a selector is a handful of integers.
+    struct Compound
+    {
+        SvgTag tag = SvgTag::Unknown;   // Unknown: any element
+        bool childOf = false;           // joined to the next compound by '>'
+        uint32_t id = kNone;            // index into m_strings
+        uint32_t classBegin = 0, classEnd = 0;
+        uint32_t attrBegin = 0, attrEnd = 0;
+    };
+
+    struct Selector
+    {
+        uint32_t compoundBegin, compoundEnd;
+        uint32_t declBegin, declEnd;
+        uint32_t specificity;
+    };
+
+    struct Declaration
+    {
+        SvgAttr attr;
+        bool important;
+        std::string value;
+    };
+
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return SvgNames::Hash(s, 0); }
+    };
+    using Buckets = std::unordered_map<std::string, std::vector<uint32_t>, StringHash, std::equal_to<>>;
+
+    static constexpr uint32_t kNone = 0xFFFFFFFF;
+    // Style is the last SvgTag.
+    static constexpr size_t kTagCount = static_cast<size_t>(SvgTag::Style) + 1;
+
+    bool ParseSelector(std::string_view text, uint32_t declBegin, uint32_t declEnd);
+    bool ParseCompound(std::string_view text, Compound &compound, uint32_t &specificity, bool &matchesNothing);
+    void ParseDeclarations(std::string_view block);
+
+    bool Matches(const Selector &selector, const SvgStyleNode &element, std::span<const SvgStyleNode> ancestors) const;
+    bool MatchesAncestors(uint32_t begin, uint32_t end, std::span<const SvgStyleNode> ancestors) const;
+    bool MatchesCompound(const Compound &compound, const SvgStyleNode &node) const;
+
+    std::vector<Selector> m_selectors;
+    std::vector<Compound> m_compounds;
+    std::vector<Declaration> m_declarations;
+    std::vector<std::string> m_strings;
+    std::vector<AttrTest> m_attrTests;
+
+    Buckets m_byId;
+    Buckets m_byClass;
+    std::vector<uint32_t> m_byTag[kTagCount];
+    std::vector<uint32_t> m_universal;
+};
+
+// What the cascade needs while a document is built: the document's style
+// sheet and the open elements above the one being created, root first.
+struct SvgStyleContext
+{
+    const SvgStyleSheet &sheet;
+    std::vector<SvgStyleNode> ancestors;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "stdafx.h"
+#include "SvgTransform.h"
+#include "SvgNumber.h"
+#include <cmath>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace
+{
+    bool IsSeparator(char c) { return c == ' ' || c == ',' || c == '\n' || c == '\t' || c == '\r'; }
+
+    SvgMatrix Translate(float tx, float ty) { return {1.0f, 0.0f, 0.0f, 1.0f, tx, ty}; }
+
+    SvgMatrix Rotate(float degrees)
+    {
+        const double rad = degrees * M_PI / 180.0;
+        const float cosA = static_cast<float>(std::cos(rad));
+        const float sinA = static_cast<float>(std::sin(rad));
+        return {cosA, sinA, -sinA, cosA, 0.0f, 0.0f};
+    }
+
+    float TanDegrees(float degrees)
+    {
+        return static_cast<float>(std::tan(degrees * M_PI / 180.0));
+    }
+
+    // Builds one transform function; false if its arguments do not fit.
+    bool MakeFunction(std::string_view name, const float *v, size_t n, SvgMatrix &out)
+    {
+        if (name == "matrix" && n == 6)
+            out = {v[0], v[1], v[2], v[3], v[4], v[5]};
+        else if (name == "translate" && (n == 1 || n == 2))
+            out = Translate(v[0], n == 2 ? v[1] : 0.0f);
+        else if (name == "scale" && (n == 1 || n == 2))
+            out = {v[0], 0.0f, 0.0f, n == 2 ? v[1] : v[0], 0.0f, 0.0f};
+        else if (name == "rotate" && n == 1)
+            out = Rotate(v[0]);
+        else if (name == "rotate" && n == 3)
+            out = Translate(v[1], v[2]) * Rotate(v[0]) * Translate(-v[1], -v[2]);
+        else if (name == "skewX" && n == 1)
+            out = {1.0f, 0.0f, TanDegrees(v[0]), 1.0f, 0.0f, 0.0f};
+        else if (name == "skewY" && n == 1)
+            out = {1.0f, TanDegrees(v[0]), 0.0f, 1.0f, 0.0f, 0.0f};
+        else
+            return false;
+        return true;
+    }
+}
+
+SvgMatrix SvgTransform::Parse(std::string_view text)
+{
+    SvgMatrix result;
+    while (true)
+    {
+        size_t i = 0;
+        while (i < text.size() && IsSeparator(text[i]))
+            ++i;
+        const size_t nameStart = i;
+        while (i < text.size() && ((text[i] >= 'a' && text[i] <= 'z') || (text[i] >= 'A' && text[i] <= 'Z')))
+            ++i;
+        const std::string_view name = text.substr(nameStart, i - nameStart);
+        while (i < text.size() && IsSeparator(text[i]) && text[i] != ',')
+            ++i;
+        if (name.empty() || i >= text.size() || text[i] != '(')
+            break;
+
+        const size_t close = text.find(')', i);
+        if (close == std::string_view::npos)
+            break;
+
+        // No transform function takes more than six arguments.
+        float args[7];
+        size_t count = 0;
+        SvgNumberList list(text.substr(i + 1, close - i - 1));
+        while (count < 7 && list.Next(args[count]))
+            ++count;
+
+        SvgMatrix m;
+        if (MakeFunction(name, args, count, m))
+            result = result * m;
+        text.remove_prefix(close + 1);
+    }
+    return result;
+}
+
+bool SvgViewBox::Parse(std::string_view viewBox, std::string_view preserveAspectRatio)
+{
+    float numbers[4];
+    size_t count = 0;
+    SvgNumberList list(viewBox);
+    while (count < 4 && list.Next(numbers[count]))
+        ++count;
+    if (count < 4 || !(numbers[2] > 0.0f) || !(numbers[3] > 0.0f))
+        return false;
+    x = numbers[0];
+    y = numbers[1];
+    width = numbers[2];
+    height = numbers[3];
+
+    // [defer] <align> [meet | slice]; anything unknown keeps the default,
+    // xMidYMid meet.
+    alignX = alignY = Align::Mid;
+    slice = false;
+    auto axis = [](std::string_view name) {
+        return name == "Min" ? Align::Min : name == "Max" ? Align::Max : Align::Mid;
+    };
+    size_t i = 0;
+    while (i < preserveAspectRatio.size())
+    {
+        while (i < preserveAspectRatio.size() && IsSeparator(preserveAspectRatio[i]))
+            ++i;
+        const size_t start = i;
+        while (i < preserveAspectRatio.size() && !IsSeparator(preserveAspectRatio[i]))
+            ++i;
+        const std::string_view word = preserveAspectRatio.substr(start, i - start);
+        if (word == "none")
+            alignX = alignY = Align::None;
+        else if (word == "slice")
+            slice = true;
+        else if (word.size() == 8 && word[0] == 'x' && word[4] == 'Y')
+        {
+            alignX = axis(word.substr(1, 3));
+            alignY = axis(word.substr(5, 3));
+        }
+    }
+    return true;
+}
+
+SvgMatrix SvgViewBox::Fit(float viewportWidth, float viewportHeight) const
+{
+    float sx = viewportWidth / width, sy = viewportHeight / height;
+    if (alignX != Align::None)
+        sx = sy = slice ? (std::max)(sx, sy) : (std::min)(sx, sy);
+    auto offset = [](Align align, float room) {
+        return align == Align::Mid ? room * 0.5f : align == Align::Max ? room : 0.0f;
+    };
+    const float tx = offset(alignX, viewportWidth - width * sx) - x * sx;
+    const float ty = offset(alignY, viewportHeight - height * sy) - y * sy;
+    return {sx, 0.0f, 0.0f, sy, tx, ty};
+}
@@ -0,0 +1,141 @@
+#ifndef _SVGTRANSFORM_H_
+#define _SVGTRANSFORM_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+// 2x3 affine matrix in SVG's matrix(a b c d e f) layout:
+//   x' = a*x + c*y + e
+//   y' = b*x + d*y + f
+// The same element order as a Gdiplus::Matrix, so the renderer can hand it
+// over as is.
+struct SvgMatrix
+{
+    float a = 1.0f, b = 0.0f;
+    float c = 0.0f, d = 1.0f;
+    float e = 0.0f, f = 0.0f;
+
+    bool IsIdentity() const
+    {
+        return a == 1.0f && b == 0.0f && c == 0.0f && d == 1.0f && e == 0.0f && f == 0.0f;
+    }
+
+    // this * rhs: rhs is applied to a point first, then this.
+    SvgMatrix operator*(const SvgMatrix &rhs) const
+    {
+        return {a * rhs.a + c * rhs.b, b * rhs.a + d * rhs.b,
+                a * rhs.c + c * rhs.d, b * rhs.c + d * rhs.d,
+                a * rhs.e + c * rhs.f + e, b * rhs.e + d * rhs.f + f};
+    }
+};
+
+// Axis-aligned box. A default one is empty and grows with Add and Union.
+struct SvgBounds
+{
+    float minX = std::numeric_limits<float>::infinity();
+    float minY = std::numeric_limits<float>::infinity();
+    float maxX = -std::numeric_limits<float>::infinity();
+    float maxY = -std::numeric_limits<float>::infinity();
+
+    // Covers everything; for content whose extent is not known.
+    static SvgBounds Infinite()
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        return {-inf, -inf, inf, inf};
+    }
+
+    bool operator==(const SvgBounds &) const = default;
+
+    bool Empty() const { return minX > maxX || minY > maxY; }
+    bool Finite() const { return std::isfinite(minX) && std::isfinite(minY) && std::isfinite(maxX) && std::isfinite(maxY); }
+
+    void Add(float x, float y)
+    {
+        minX = (std::min)(minX, x);
+        minY = (std::min)(minY, y);
+        maxX = (std::max)(maxX, x);
+        maxY = (std::max)(maxY, y);
+    }
+
+    void Union(const SvgBounds &other)
+    {
+        minX = (std::min)(minX, other.minX);
+        minY = (std::min)(minY, other.minY);
+        maxX = (std::max)(maxX, other.maxX);
+        maxY = (std::max)(maxY, other.maxY);
+    }
+
+    void Inflate(float amount)
+    {
+        if (Empty())
+            return;
+        minX -= amount;
+        minY -= amount;
+        maxX += amount;
+        maxY += amount;
+    }
+
+    bool Intersects(const SvgBounds &other) const
+    {
+        return !Empty() && !other.Empty() &&
+               minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+
+    // The box around this one's four corners after m.
+    SvgBounds Transformed(const SvgMatrix &m) const
+    {
+        if (Empty() || m.IsIdentity())
+            return *this;
+        if (!Finite())
+            return Infinite();
+        SvgBounds out;
+        for (float x : {minX, maxX})
+        {
+            for (float y : {minY, maxY})
+                out.Add(m.a * x + m.c * y + m.e, m.b * x + m.d * y + m.f);
+        }
+        return out;
+    }
+};
+
+// A viewBox and the preserveAspectRatio that goes with it: how the box is
+// fitted into a viewport, as for a <symbol> drawn through a <use>.
+struct SvgViewBox
+{
+    // Where the box's edges go, per axis: its low edge, its middle or its
+    // high edge against the viewport's. None stretches it to fill.
+    enum class Align : uint8_t
+    {
+        None,
+        Min,
+        Mid,
+        Max
+    };
+
+    float x = 0.0f, y = 0.0f, width = 0.0f, height = 0.0f;
+    Align alignX = Align::Mid, alignY = Align::Mid;
+    // Scale to cover the viewport rather than fit inside it.
+    bool slice = false;
+
+    // Reads viewBox and preserveAspectRatio (which may be empty); false if
+    // viewBox is not four numbers with a positive width and height.
+    bool Parse(std::string_view viewBox, std::string_view preserveAspectRatio);
+    // The matrix taking the box into a width x height viewport at the
+    // origin.
+    SvgMatrix Fit(float viewportWidth, float viewportHeight) const;
+};
+
+namespace SvgTransform
+{
+    // Parses a transform or gradientTransform attribute: a list of
+    // matrix(), translate(), scale(), rotate() (optionally about a centre),
+    // skewX() and skewY(), composed left to right as SVG specifies. A
+    // function with the wrong number of arguments or an unknown name is
+    // skipped; the list ends at the first thing that is not a function.
+    SvgMatrix Parse(std::string_view text);
+}
+
+#endif
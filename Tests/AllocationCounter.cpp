@@ -0,0 +1,82 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> g_allocations{0};
+    std::atomic<size_t> g_frees{0};
+    std::atomic<size_t> g_liveBytes{0};
+
+    // Each block carries its size in front, in a header as large as the
+    // strictest alignment asked for, so delete can count it back.
+    void *Allocate(size_t size, size_t alignment)
+    {
+        const size_t header = alignment > alignof(std::max_align_t) ? alignment : alignof(std::max_align_t);
+        void *block = nullptr;
+        if (header > alignof(std::max_align_t))
+        {
+            const size_t total = (size + header + alignment - 1) / alignment * alignment;
+            block = std::aligned_alloc(alignment, total);
+        }
+        else
+        {
+            block = std::malloc(size + header);
+        }
+        if (!block)
+            return nullptr;
+        char *user = static_cast<char *>(block) + header;
+        reinterpret_cast<size_t *>(user)[-1] = size;
+        reinterpret_cast<size_t *>(user)[-2] = header;
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_liveBytes.fetch_add(size, std::memory_order_relaxed);
+        return user;
+    }
+
+    void Free(void *pointer)
+    {
+        if (!pointer)
+            return;
+        char *user = static_cast<char *>(pointer);
+        const size_t size = reinterpret_cast<size_t *>(user)[-1];
+        const size_t header = reinterpret_cast<size_t *>(user)[-2];
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+        g_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        std::free(user - header);
+    }
+
+    void *AllocateOrThrow(size_t size, size_t alignment)
+    {
+        void *pointer = Allocate(size ? size : 1, alignment);
+        if (!pointer)
+            throw std::bad_alloc();
+        return pointer;
+    }
+}
+
+namespace AllocationCounter
+{
+    Totals Now()
+    {
+        return {g_allocations.load(std::memory_order_relaxed), g_frees.load(std::memory_order_relaxed),
+                g_liveBytes.load(std::memory_order_relaxed)};
+    }
+}
+
+void *operator new(size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void *operator new[](size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void *operator new(size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return Allocate(size ? size : 1, alignof(std::max_align_t)); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return Allocate(size ? size : 1, alignof(std::max_align_t)); }
+void operator delete(void *pointer) noexcept { Free(pointer); }
+void operator delete[](void *pointer) noexcept { Free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { Free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { Free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { Free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { Free(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { Free(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { Free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { Free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { Free(pointer); }
@@ -0,0 +1,21 @@
+#ifndef _ALLOCATIONCOUNTER_H_
+#define _ALLOCATIONCOUNTER_H_
+
+#include <cstddef>
+
+// Counts what goes through the global operator new and delete of the
+// program it is linked into, which it replaces. For tests that pin down
+// how much a piece of code allocates.
+namespace AllocationCounter
+{
+    struct Totals
+    {
+        size_t allocations = 0;     // calls to operator new, ever
+        size_t frees = 0;           // calls to operator delete, ever
+        size_t liveBytes = 0;       // allocated and not yet freed
+    };
+
+    Totals Now();
+}
+
+#endif
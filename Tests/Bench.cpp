@@ -0,0 +1,54 @@
+#include "Bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+namespace
+{
+    struct Entry
+    {
+        const char *usage;
+        Bench::Function function;
+    };
+
+    std::map<std::string, Entry> &Registry()
+    {
+        static std::map<std::string, Entry> registry;
+        return registry;
+    }
+}
+
+namespace Bench
+{
+    bool Register(const char *name, const char *usage, Function function)
+    {
+        Registry()[name] = Entry{usage, std::move(function)};
+        return true;
+    }
+
+    double Best(int runs, const std::function<void()> &f)
+    {
+        double best = 1e300;
+        for (int i = 0; i < runs; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            best = (std::min)(best, Seconds(start));
+        }
+        return best;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const auto &registry = Registry();
+    const auto found = argc > 1 ? registry.find(argv[1]) : registry.end();
+    if (found == registry.end())
+    {
+        std::printf("usage: svgreader_bench <benchmark> [args]\n");
+        for (const auto &[name, entry] : registry)
+            std::printf("  %-12s %s\n", name.c_str(), entry.usage);
+        return argc > 1 ? 1 : 0;
+    }
+    return found->second.function(std::vector<std::string>(argv + 2, argv + argc));
+}
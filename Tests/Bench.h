@@ -0,0 +1,32 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// svgreader_bench: timings that back the performance changes, each a named
+// benchmark run as "svgreader_bench <name> [args]" (no name lists them).
+// Numbers go to stdout, one result a line. They are not tests: nothing
+// checks them, and they mean something only against a run of the same
+// benchmark on the same machine.
+namespace Bench
+{
+    typedef std::function<int(const std::vector<std::string> &args)> Function;
+
+    // Adds a benchmark; returns true so a file can register from a static.
+    bool Register(const char *name, const char *usage, Function function);
+
+    // Seconds since start.
+    inline double Seconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // The fastest of runs calls of f, in seconds: the run least disturbed
+    // by the rest of the machine.
+    double Best(int runs, const std::function<void()> &f);
+}
+
+#endif
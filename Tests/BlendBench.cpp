@@ -0,0 +1,50 @@
+#include "Bench.h"
+#include "SoftwareBlend.h"
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    int BlendBench(const std::vector<std::string> &)
+    {
+        using namespace SoftwareBlend;
+        // One 4096-pixel row, mostly fully covered with every seventh pixel
+        // on an edge, as the spans of a filled shape are.
+        const int width = 4096, rows = 2000;
+        std::mt19937 random(1);
+        std::vector<uint32_t> dst(width), src(width);
+        std::vector<uint8_t> coverage(width);
+        for (int i = 0; i < width; ++i)
+        {
+            dst[i] = Premultiply(random(), random(), random(), random());
+            src[i] = Premultiply(random(), random(), random(), random());
+            coverage[i] = i % 7 == 0 ? static_cast<uint8_t>(random()) : 255;
+        }
+
+        std::printf("active: %s\n", IsaName(ActiveIsa()));
+        const double pixels = static_cast<double>(width) * rows;
+        for (Isa isa : {Isa::Scalar, Isa::Sse2, Isa::Sse41, Isa::Avx2, Isa::Avx512})
+        {
+            const Kernels *kernels = KernelsFor(isa);
+            if (!kernels)
+            {
+                std::printf("%-8s not available\n", IsaName(isa));
+                continue;
+            }
+            const double solid = Bench::Best(5, [&] {
+                for (int r = 0; r < rows; ++r)
+                    kernels->solidSpan(dst.data(), width, 0x80402010u, coverage.data());
+            });
+            const double span = Bench::Best(5, [&] {
+                for (int r = 0; r < rows; ++r)
+                    kernels->span(dst.data(), width, src.data(), coverage.data());
+            });
+            std::printf("%-8s solid %7.0f Mpixels/s  span %7.0f Mpixels/s\n", IsaName(isa),
+                        pixels / solid * 1e-6, pixels / span * 1e-6);
+        }
+        return 0;
+    }
+
+    const bool registered = Bench::Register("blend", "span compositing, Mpixels/s for each instruction set",
+                                            BlendBench);
+}
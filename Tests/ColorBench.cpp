@@ -0,0 +1,113 @@
+#include "Bench.h"
+#include "SvgColors.h"
+#include "SvgNumber.h"
+#include "SvgParser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    volatile uint32_t g_sink;
+
+    // The keyword lookup SvgColors replaced: a table read at startup into
+    // an unordered_map, searched with a lowercased, space-stripped copy.
+    // A few CSS names stand in for the table that was read from file.
+    Gdiplus::Color OldNamedColor(std::string value)
+    {
+        static const std::unordered_map<std::string, Gdiplus::Color> table = []
+        {
+            std::unordered_map<std::string, Gdiplus::Color> names;
+            for (const char *name : {"black", "white", "red", "green", "blue", "gray", "orange", "purple", "navy",
+                                     "teal", "cornflowerblue", "darkslategray", "lightgoldenrodyellow"})
+            {
+                Gdiplus::Color color;
+                SvgColors::FindNamedColor(name, color);
+                names[name] = color;
+            }
+            return names;
+        }();
+        for (char &c : value)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        std::string key;
+        for (char c : value)
+        {
+            if (c != ' ')
+                key += c;
+        }
+        const auto found = table.find(key);
+        return found != table.end() ? found->second : Gdiplus::Color(0, 0, 0, 0);
+    }
+
+    // SvgElementFactory::ParseColor as it was: stoi on substring copies
+    // for hex, a number list for rgb(), then the keyword table.
+    Gdiplus::Color OldParseColor(std::string_view value)
+    {
+        if (value.empty() || value == "none")
+            return Gdiplus::Color(0, 0, 0, 0);
+        if (value[0] == '#')
+        {
+            if (value.size() == 7)
+            {
+                const int r = std::stoi(std::string(value.substr(1, 2)), nullptr, 16);
+                const int g = std::stoi(std::string(value.substr(3, 2)), nullptr, 16);
+                const int b = std::stoi(std::string(value.substr(5, 2)), nullptr, 16);
+                return Gdiplus::Color(255, r, g, b);
+            }
+            if (value.size() == 4)
+            {
+                const int r = std::stoi(std::string(2, value[1]), nullptr, 16);
+                const int g = std::stoi(std::string(2, value[2]), nullptr, 16);
+                const int b = std::stoi(std::string(2, value[3]), nullptr, 16);
+                return Gdiplus::Color(255, r, g, b);
+            }
+        }
+        if (value.starts_with("rgb"))
+        {
+            const size_t start = value.find('('), end = value.find(')');
+            if (start == std::string_view::npos || end == std::string_view::npos || end < start)
+                return Gdiplus::Color(0, 0, 0, 0);
+            SvgNumberList channels(value.substr(start + 1, end - start - 1));
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            if (channels.Next(r) && channels.Next(g))
+                channels.Next(b);
+            auto clamp = [](float c) { return static_cast<uint8_t>(std::clamp(static_cast<int>(c), 0, 255)); };
+            return Gdiplus::Color(255, clamp(r), clamp(g), clamp(b));
+        }
+        return OldNamedColor(std::string(value));
+    }
+
+    // ParseColor throughput on each form of colour, against the parsing it
+    // replaced where that understood the form.
+    int ColorBench(const std::vector<std::string> &args)
+    {
+        const int calls = args.size() > 0 ? std::stoi(args[0]) : 1000000;
+        const SvgElementFactory factory;
+        std::printf("%d calls each, ns per call\n", calls);
+        std::printf("%-22s %8s %8s\n", "value", "before", "after");
+        for (const char *value : {"#1a2b3c", "#abc", "#1a2b3c80", "red", "cornflowerblue", "LightGoldenrodYellow",
+                                  "rgb(12, 34, 56)", "rgba(12, 34, 56, 0.5)", "rgb(10% 20% 30%)",
+                                  "hsl(200, 50%, 40%)", "none"})
+        {
+            const std::string_view text(value);
+            uint32_t sink = 0;
+            const double before = Bench::Best(3, [&] {
+                for (int i = 0; i < calls; ++i)
+                    sink += OldParseColor(text).GetValue();
+            });
+            const double after = Bench::Best(3, [&] {
+                for (int i = 0; i < calls; ++i)
+                    sink += factory.ParseColor(text).GetValue();
+            });
+            g_sink = sink;
+            std::printf("%-22s %8.1f %8.1f\n", value, before * 1e9 / calls, after * 1e9 / calls);
+        }
+        std::printf("(before: #RRGGBBAA, percentages and hsl() were not understood)\n");
+        return 0;
+    }
+
+    const bool registered = Bench::Register("colors", "[calls]: SvgElementFactory::ParseColor, ns per call",
+                                            ColorBench);
+}
@@ -0,0 +1,54 @@
+#include "AllocationCounter.h"
+#include "Bench.h"
+#include "SvgParser.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    // Load and destroy time of each ms2/ms3 document, and the allocations
+    // a load makes and the frees its destruction makes.
+    int DocumentBench(const std::vector<std::string> &args)
+    {
+        const int runs = args.size() > 0 ? std::stoi(args[0]) : 200;
+        SvgParser parser;
+        parser.SetMaxThreads(1);
+        std::printf("%-26s %9s %9s %8s %8s\n", "file", "load us", "free us", "allocs", "frees");
+        double loadTotal = 0.0, destroyTotal = 0.0;
+        size_t allocationTotal = 0, freeTotal = 0;
+        for (const auto &path : TestSupport::Fixtures())
+        {
+            const std::string text = TestSupport::ReadFile(path);
+            double load = 1e300, destroy = 1e300;
+            size_t allocations = 0, frees = 0;
+            for (int i = 0; i < runs; ++i)
+            {
+                auto document = std::make_unique<SvgDocument>();
+                const AllocationCounter::Totals before = AllocationCounter::Now();
+                auto start = std::chrono::steady_clock::now();
+                parser.Parse(text, *document);
+                load = (std::min)(load, Bench::Seconds(start));
+                const AllocationCounter::Totals loaded = AllocationCounter::Now();
+                start = std::chrono::steady_clock::now();
+                document.reset();
+                destroy = (std::min)(destroy, Bench::Seconds(start));
+                const AllocationCounter::Totals destroyed = AllocationCounter::Now();
+                allocations = loaded.allocations - before.allocations;
+                frees = destroyed.frees - loaded.frees;
+            }
+            std::printf("%-26s %9.1f %9.2f %8zu %8zu\n", TestSupport::FixtureName(path).c_str(), load * 1e6,
+                        destroy * 1e6, allocations, frees);
+            loadTotal += load;
+            destroyTotal += destroy;
+            allocationTotal += allocations;
+            freeTotal += frees;
+        }
+        std::printf("%-26s %9.1f %9.2f %8zu %8zu\n", "total", loadTotal * 1e6, destroyTotal * 1e6, allocationTotal,
+                    freeTotal);
+        return 0;
+    }
+
+    const bool registered = Bench::Register("documents", "[runs]: load and destroy time and allocations, ms2 and ms3",
+                                            DocumentBench);
+}
@@ -0,0 +1,122 @@
+#include "Bench.h"
+#include "MappedFile.h"
+#include "SvgParser.h"
+#include "SvgStreamParser.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // What SvgRenderer::Load did before the file was mapped: ifstream into
+    // a stringstream, out to a string, which Parse copies once more.
+    bool LoadThroughCopies(const std::filesystem::path &path, SvgDocument &document)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        const std::string xml = stream.str();
+        return SvgParser().Parse(xml, document);
+    }
+
+    bool LoadMapped(const std::filesystem::path &path, SvgDocument &document)
+    {
+        MappedFile file;
+        return file.Open(path) && SvgParser().Parse(file.GetBuffer(), document);
+    }
+
+    // What SvgRenderer::Load does with files this large.
+    bool LoadMappedStreamed(const std::filesystem::path &path, SvgDocument &document)
+    {
+        MappedFile file;
+        if (!file.Open(path))
+            return false;
+        SvgParser parser;
+        SvgStreamParser stream(parser);
+        return stream.Feed(std::string_view(file.GetBuffer().data(), file.GetSize())) && stream.Finish(document);
+    }
+
+    // The resident set now and at its highest, in MiB; 0 where /proc is
+    // not there to ask.
+    void Resident(double &now, double &peak)
+    {
+        now = peak = 0.0;
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        double kib;
+        while (status >> key)
+        {
+            if (key == "VmRSS:" && status >> kib)
+                now = kib / 1024.0;
+            else if (key == "VmHWM:" && status >> kib)
+                peak = kib / 1024.0;
+        }
+    }
+
+    void Measure(const char *name, bool (*load)(const std::filesystem::path &, SvgDocument &),
+                 const std::filesystem::path &path)
+    {
+        double start, unused;
+        Resident(start, unused);
+        bool loaded = true;
+        const double seconds = Bench::Best(3, [&] {
+            SvgDocument document;
+            loaded = load(path, document) && loaded;
+        });
+        double now, peak;
+        Resident(now, peak);
+        std::printf("%-18s %8.1f ms  peak RSS %7.1f MiB (+%.1f)%s\n", name, seconds * 1e3, peak, peak - start,
+                    loaded ? "" : "  FAILED");
+    }
+
+    // Each way of loading on its own, as the peak only ever goes up. On
+    // Linux each runs in a child process of its own.
+    void MeasureApart(const char *name, bool (*load)(const std::filesystem::path &, SvgDocument &),
+                      const std::filesystem::path &path)
+    {
+        std::fflush(stdout);
+#ifdef __linux__
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            Measure(name, load, path);
+            std::fflush(stdout);
+            _exit(0);
+        }
+        if (child > 0)
+        {
+            int status;
+            waitpid(child, &status, 0);
+            return;
+        }
+#endif
+        Measure(name, load, path);
+    }
+
+    // Peak memory and load time of a generated file of the given size,
+    // mapped against read through stream copies.
+    int LoadBench(const std::vector<std::string> &args)
+    {
+        const double megabytes = args.size() > 0 ? std::stod(args[0]) : 50.0;
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "svgreader_bench_load.svg";
+        {
+            const std::string xml = TestSupport::GenerateDocument(static_cast<size_t>(megabytes * 1e6 / 50));
+            std::ofstream(path, std::ios::binary) << xml;
+            std::printf("%s: %.1f MB\n", path.string().c_str(), xml.size() / 1e6);
+        }
+        MeasureApart("stream copies", LoadThroughCopies, path);
+        MeasureApart("mapped", LoadMapped, path);
+        MeasureApart("mapped, streamed", LoadMappedStreamed, path);
+        std::filesystem::remove(path);
+        return 0;
+    }
+
+    const bool registered = Bench::Register("load", "[megabytes]: peak RSS and load time, mapped against copied",
+                                            LoadBench);
+}
@@ -0,0 +1,90 @@
+#include "MappedFile.h"
+#include "SvgParser.h"
+#include "TestSupport.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace
+{
+    // A file of the given contents in the temp directory, removed again
+    // when the test is done with it.
+    class TempFile
+    {
+    public:
+        explicit TempFile(const std::string &contents)
+            : m_path(std::filesystem::temp_directory_path() /
+                     ("svgreader_" + std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) + ".svg"))
+        {
+            std::ofstream(m_path, std::ios::binary) << contents;
+        }
+        ~TempFile() { std::filesystem::remove(m_path); }
+
+        const std::filesystem::path &Path() const { return m_path; }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    std::string Contents(MappedFile &file)
+    {
+        return std::string(file.GetBuffer().data(), file.GetSize());
+    }
+}
+
+// A file that ends inside a page is mapped, and the rest of that page
+// gives the terminating '\0'.
+TEST(MappedFile, MapsFileEndingInsidePage)
+{
+    const std::string text = TestSupport::ReadFile(TestSupport::TestCasesDir() / "ms3" / "khtn.svg");
+    ASSERT_NE(text.size() % 65536, 0u);
+    const TempFile temp(text);
+    MappedFile file;
+    ASSERT_TRUE(file.Open(temp.Path()));
+    EXPECT_TRUE(file.IsMapped());
+    EXPECT_EQ(file.GetSize(), text.size());
+    EXPECT_EQ(file.GetBuffer().size(), text.size() + 1);
+    EXPECT_EQ(file.GetBuffer().back(), '\0');
+    EXPECT_EQ(Contents(file), text);
+}
+
+// A file filling whole pages has no spare byte, so it is read into the
+// heap instead; 64 KiB is whole pages on every platform.
+TEST(MappedFile, ReadsPageAlignedFileIntoHeap)
+{
+    const std::string text(65536, 'x');
+    const TempFile temp(text);
+    MappedFile file;
+    ASSERT_TRUE(file.Open(temp.Path()));
+    EXPECT_FALSE(file.IsMapped());
+    EXPECT_EQ(file.GetBuffer().back(), '\0');
+    EXPECT_EQ(Contents(file), text);
+}
+
+TEST(MappedFile, FailsOnMissingFile)
+{
+    MappedFile file;
+    EXPECT_FALSE(file.Open(TestSupport::TestCasesDir() / "missing.svg"));
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_TRUE(file.GetBuffer().empty());
+}
+
+// Parsing the mapped buffer in place gives the document parsing a copy
+// gives, and what rapidxml writes into the buffer never reaches the file.
+TEST(MappedFile, ParsesInPlaceWithoutTouchingFile)
+{
+    for (const auto &path : TestSupport::Fixtures())
+    {
+        const std::string text = TestSupport::ReadFile(path);
+        const TempFile temp(text);
+        MappedFile file;
+        ASSERT_TRUE(file.Open(temp.Path())) << path;
+        SvgParser parser;
+        SvgDocument mapped, copied;
+        ASSERT_TRUE(parser.Parse(file.GetBuffer(), mapped)) << path;
+        ASSERT_TRUE(parser.Parse(text, copied)) << path;
+        file.Close();
+
+        EXPECT_EQ(TestSupport::ReadFile(temp.Path()), text) << path;
+        EXPECT_EQ(TestSupport::Draw(mapped, 256).pixels, TestSupport::Draw(copied, 256).pixels) << path;
+    }
+}
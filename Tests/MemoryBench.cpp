@@ -0,0 +1,78 @@
+#include "AllocationCounter.h"
+#include "Bench.h"
+#include "SvgElement.h"
+#include "SvgParser.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    size_t CountElements(const ISvgElement &element)
+    {
+        size_t count = 1;
+        if (auto group = dynamic_cast<const SvgGroup *>(&element))
+        {
+            for (const ISvgElement *child : group->children)
+                count += CountElements(*child);
+        }
+        return count;
+    }
+
+    struct Usage
+    {
+        size_t elements = 0;
+        size_t arena = 0;   // taken from the arenas
+        size_t heap = 0;    // live heap after the load, parser gone
+        size_t styles = 0;  // of which the style table
+    };
+
+    void Load(const std::string &text, Usage &usage)
+    {
+        auto document = std::make_unique<SvgDocument>();
+        const size_t before = AllocationCounter::Now().liveBytes;
+        {
+            SvgParser parser;
+            parser.SetMaxThreads(1);
+            parser.Parse(text, *document);
+        }
+        usage.heap += AllocationCounter::Now().liveBytes - before;
+        usage.arena += document->ArenaBytes();
+        usage.styles += document->GetStyles().MemoryUsage();
+        for (const ISvgElement *element : document->GetElements())
+            usage.elements += CountElements(*element);
+    }
+
+    void Row(const char *what, const Usage &usage)
+    {
+        const double elements = static_cast<double>(usage.elements);
+        std::printf("%-16s %9zu %10.1f %10.1f %11zu\n", what, usage.elements, usage.arena / elements,
+                    usage.heap / elements, usage.styles);
+    }
+
+    // Bytes a loaded document keeps per element, on the fixtures and a
+    // generated file, and the element sizes behind them. The heap figure
+    // includes the arenas' blocks, which grow geometrically, so it moves in
+    // steps; the arena figure is what the elements actually took of them.
+    int MemoryBench(const std::vector<std::string> &args)
+    {
+        const size_t elements = args.size() > 0 ? std::stoul(args[0]) : 200000;
+        std::printf("sizeof: group %zu, rect %zu, circle %zu, line %zu, path %zu, text %zu\n", sizeof(SvgGroup),
+                    sizeof(SvgRect), sizeof(SvgCircle), sizeof(SvgLine), sizeof(SvgPath), sizeof(SvgText));
+        std::printf("%-16s %9s %10s %10s %11s\n", "document", "elements", "arena/el", "heap/el", "style table");
+        for (const char *set : {"ms2", "ms3"})
+        {
+            Usage usage;
+            for (const auto &path : TestSupport::Fixtures(set))
+                Load(TestSupport::ReadFile(path), usage);
+            Row(set, usage);
+        }
+        Usage generated;
+        Load(TestSupport::GenerateDocument(elements), generated);
+        Row("generated", generated);
+        return 0;
+    }
+
+    const bool registered = Bench::Register("memory", "[elements]: heap bytes a loaded document keeps per element",
+                                            MemoryBench);
+}
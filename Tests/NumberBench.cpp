@@ -0,0 +1,116 @@
+#include "Bench.h"
+#include "SvgNumber.h"
+#include <algorithm>
+#include <cstdio>
+#include <locale>
+#include <random>
+#include <regex>
+#include <sstream>
+
+namespace
+{
+    // Where the results go, so the loops are not optimized away.
+    volatile float g_sink;
+
+    // The per-value parse SvgNumber replaced (ParseFloat, AttrOrFloat): a
+    // classic-locale stringstream over a copy of the value.
+    float StreamParse(std::string_view text, float def)
+    {
+        std::stringstream ss{std::string(text)};
+        ss.imbue(std::locale::classic());
+        float value = def;
+        ss >> value;
+        return value;
+    }
+
+    // The per-list parse it replaced (viewBox, transform arguments): commas
+    // to spaces in a copy, then one stringstream over the list.
+    size_t StreamParseList(std::string_view text, std::vector<float> &out)
+    {
+        std::string copy(text);
+        std::replace(copy.begin(), copy.end(), ',', ' ');
+        std::stringstream ss(copy);
+        ss.imbue(std::locale::classic());
+        float value;
+        while (ss >> value)
+            out.push_back(value);
+        return out.size();
+    }
+
+    // The old ParsePoints: a regex for each number and stof on its copy.
+    size_t RegexParseList(std::string_view text, std::vector<float> &out)
+    {
+        static const std::regex number("[-+]?[0-9]*\\.?[0-9]+");
+        for (auto it = std::cregex_iterator(text.data(), text.data() + text.size(), number);
+             it != std::cregex_iterator(); ++it)
+            out.push_back(std::stof(it->str()));
+        return out.size();
+    }
+
+    size_t ScanList(std::string_view text, std::vector<float> &out)
+    {
+        SvgNumberList list(text);
+        float value;
+        while (list.Next(value))
+            out.push_back(value);
+        return out.size();
+    }
+
+    // Single values as attributes hold them, and a points list, against
+    // the stream and regex parsing SvgNumber replaced.
+    int NumberBench(const std::vector<std::string> &args)
+    {
+        const size_t count = args.size() > 0 ? std::stoul(args[0]) : 200000;
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> coordinate(-2000.0f, 2000.0f);
+        const char *const kUnits[] = {"", "", "px", "%"};
+        std::vector<std::string> values;
+        std::string points;
+        char text[64];
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::snprintf(text, sizeof text, "%.*f%s", static_cast<int>(i % 4), coordinate(random), kUnits[i % 4]);
+            values.push_back(text);
+            std::snprintf(text, sizeof text, "%.2f,%.2f ", coordinate(random), coordinate(random));
+            points += text;
+        }
+
+        float sink = 0.0f;
+        const double streamed = Bench::Best(3, [&] {
+            for (const std::string &value : values)
+                sink += StreamParse(value, 0.0f);
+        });
+        const double scanned = Bench::Best(3, [&] {
+            for (const std::string &value : values)
+                sink += SvgNumber::ParseOr(value, 0.0f);
+        });
+        std::printf("%zu single values\n", count);
+        std::printf("  stringstream   %8.1f ms  %6.1f ns/value\n", streamed * 1e3, streamed * 1e9 / count);
+        std::printf("  SvgNumber      %8.1f ms  %6.1f ns/value  %5.1fx\n", scanned * 1e3, scanned * 1e9 / count,
+                    streamed / scanned);
+
+        std::vector<float> out;
+        out.reserve(count * 2);
+        size_t read = 0;
+        auto list = [&](size_t (*parse)(std::string_view, std::vector<float> &))
+        {
+            return Bench::Best(3, [&] {
+                out.clear();
+                read = parse(points, out);
+            });
+        };
+        const double regexed = list(RegexParseList);
+        const double streamedList = list(StreamParseList);
+        const double scannedList = list(ScanList);
+        std::printf("points list of %zu numbers, %.1f MB\n", read, points.size() / 1e6);
+        std::printf("  regex + stof   %8.1f ms  %6.1f ns/number\n", regexed * 1e3, regexed * 1e9 / read);
+        std::printf("  stringstream   %8.1f ms  %6.1f ns/number\n", streamedList * 1e3, streamedList * 1e9 / read);
+        std::printf("  SvgNumberList  %8.1f ms  %6.1f ns/number  %5.1fx stringstream\n", scannedList * 1e3,
+                    scannedList * 1e9 / read, streamedList / scannedList);
+        g_sink = sink;
+        return 0;
+    }
+
+    const bool registered = Bench::Register("numbers", "[count]: SvgNumber against the stringstream parsing it replaced",
+                                            NumberBench);
+}
@@ -0,0 +1,72 @@
+#include "Bench.h"
+#include "SvgParser.h"
+#include "TestSupport.h"
+#include "rapidxml.hpp"
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    // Seconds to parse xml with the given thread cap, best of runs. Only
+    // the parse is timed, not copying the buffer that rapidxml parses in
+    // place or freeing the document.
+    double TimeParse(const std::string &xml, unsigned threads, int runs)
+    {
+        SvgParser parser;
+        parser.SetMaxThreads(threads);
+        double best = 1e300;
+        for (int i = 0; i < runs; ++i)
+        {
+            std::vector<char> buffer(xml.begin(), xml.end());
+            buffer.push_back('\0');
+            auto document = std::make_unique<SvgDocument>();
+            const auto start = std::chrono::steady_clock::now();
+            parser.Parse(std::span<char>(buffer), *document);
+            best = (std::min)(best, Bench::Seconds(start));
+        }
+        return best;
+    }
+
+    // rapidxml building the DOM, which stays on one thread.
+    double TimeDom(const std::string &xml, int runs)
+    {
+        double best = 1e300;
+        for (int i = 0; i < runs; ++i)
+        {
+            std::vector<char> buffer(xml.begin(), xml.end());
+            buffer.push_back('\0');
+            rapidxml::xml_document<> dom;
+            const auto start = std::chrono::steady_clock::now();
+            dom.parse<0>(buffer.data());
+            best = (std::min)(best, Bench::Seconds(start));
+        }
+        return best;
+    }
+
+    // Parse time of a generated document by thread cap. Only the elements
+    // are built on several threads, so rapidxml's time bounds what n cores
+    // can give; that bound is printed alongside.
+    int ParseBench(const std::vector<std::string> &args)
+    {
+        const size_t elements = args.size() > 0 ? std::stoul(args[0]) : 500000;
+        const std::string xml = TestSupport::GenerateDocument(elements);
+        std::printf("%zu elements, %.1f MB, %u hardware threads\n", elements, xml.size() / 1e6,
+                    std::thread::hardware_concurrency());
+        const double serial = TimeParse(xml, 1, 3);
+        const double dom = TimeDom(xml, 3);
+        std::printf("rapidxml   %8.1f ms\n", dom * 1e3);
+        std::printf(" 1 thread   %8.1f ms\n", serial * 1e3);
+        for (unsigned threads : {2u, 4u, 8u, 16u})
+        {
+            const double parallel = TimeParse(xml, threads, 3);
+            const double bound = serial / (dom + (serial - dom) / threads);
+            std::printf("%2u threads  %8.1f ms  %5.2fx  (at most %.2fx on %u cores)\n", threads, parallel * 1e3,
+                        serial / parallel, bound, threads);
+        }
+        return 0;
+    }
+
+    const bool registered = Bench::Register("parse", "[elements]: DOM parse time of a generated file by thread count",
+                                            ParseBench);
+}
@@ -0,0 +1,162 @@
+#include "Bench.h"
+#include "IRenderer.h"
+#include "SvgElement.h"
+#include "SvgParser.h"
+#include "SvgScene.h"
+#include "TestSupport.h"
+#include <cstdio>
+
+namespace
+{
+    volatile float g_sink;
+
+    // Does only what every renderer does whatever it draws with: follows
+    // the groups' transforms and works out each leaf's matrix. What is left
+    // to time is the traversal.
+    class CountingRenderer : public IRenderer
+    {
+    public:
+        size_t drawn = 0;
+        float sum = 0.0f;
+
+        void SetGradients(const std::unordered_map<std::string, std::shared_ptr<SvgGradient>> &) override {}
+        void SetStyles(const SvgStyleTable &) override {}
+        void DrawLine(const SvgLine &line) override { Leaf(line); }
+        void DrawRect(const SvgRect &rect) override { Leaf(rect); }
+        void DrawCircle(const SvgCircle &circle) override { Leaf(circle); }
+        void DrawEllipse(const SvgEllipse &ellipse) override { Leaf(ellipse); }
+        void DrawPolyline(const SvgPolyline &polyline) override { Leaf(polyline); }
+        void DrawPolygon(const SvgPolygon &polygon) override { Leaf(polygon); }
+        void DrawText(const SvgText &text) override { Leaf(text); }
+        void DrawPath(const SvgPath &path) override { Leaf(path); }
+        void DrawGroup(const SvgGroup &group) override
+        {
+            PushTransform(group.transform);
+            for (const ISvgElement *child : group.children)
+                child->Draw(*this);
+            PopTransform();
+        }
+        void DrawUse(const SvgUse &use) override
+        {
+            if (!use.target)
+                return;
+            PushTransform(use.transform);
+            use.target->Draw(*this);
+            PopTransform();
+        }
+        void PushTransform(const SvgMatrix &transform) override { m_stack.push_back(m_stack.back() * transform); }
+        void PopTransform() override { m_stack.pop_back(); }
+        const SvgMatrix &BeginResolved() override { return m_stack.back(); }
+        void SetResolved(const SvgMatrix &, const SvgStyle &, const SvgGradient *) override {}
+        void EndResolved() override {}
+
+    private:
+        std::vector<SvgMatrix> m_stack = std::vector<SvgMatrix>(1);
+
+        void Leaf(const ISvgElement &element)
+        {
+            ++drawn;
+            sum += (m_stack.back() * element.transform).e;
+        }
+    };
+
+    // What the tree offers for bounds: each element's cached fillBox, put
+    // into document space through the transforms on the way down.
+    void TreeBounds(const ISvgElement &element, const SvgMatrix &parent, SvgBounds &out)
+    {
+        const SvgMatrix world = parent * element.transform;
+        if (auto group = dynamic_cast<const SvgGroup *>(&element))
+        {
+            for (const ISvgElement *child : group->children)
+                TreeBounds(*child, world, out);
+        }
+        else
+        {
+            out.Union(element.fillBox.Transformed(world));
+        }
+    }
+
+    void TreeQuery(const ISvgElement &element, const SvgMatrix &parent, const SvgBounds &area,
+                   std::vector<const ISvgElement *> &found)
+    {
+        const SvgMatrix world = parent * element.transform;
+        if (auto group = dynamic_cast<const SvgGroup *>(&element))
+        {
+            for (const ISvgElement *child : group->children)
+                TreeQuery(*child, world, area, found);
+        }
+        else if (element.fillBox.Transformed(world).Intersects(area))
+        {
+            found.push_back(&element);
+        }
+    }
+
+    void Row(const char *what, double tree, double scene)
+    {
+        std::printf("%-28s %9.2f ms %9.2f ms  %6.1fx\n", what, tree * 1e3, scene * 1e3, tree / scene);
+    }
+
+    // Traversals of the element tree against the same on SvgScene, on a
+    // generated document.
+    int SceneBench(const std::vector<std::string> &args)
+    {
+        const size_t elements = args.size() > 0 ? std::stoul(args[0]) : 1000000;
+        SvgDocument document;
+        {
+            SvgParser parser;
+            parser.Parse(TestSupport::GenerateDocument(elements), document);
+        }
+        std::unique_ptr<SvgScene> scene;
+        const double build = Bench::Best(1, [&] { scene = std::make_unique<SvgScene>(document); });
+        std::printf("%zu elements, %zu items; scene built in %.1f ms\n", elements, scene->Size(), build * 1e3);
+        std::printf("%-28s %12s %12s\n", "", "tree walk", "scene");
+
+        SvgBounds treeBox, sceneBox;
+        const double treeBounds = Bench::Best(5, [&] {
+            treeBox = SvgBounds();
+            for (const ISvgElement *element : document.GetElements())
+                TreeBounds(*element, SvgMatrix(), treeBox);
+        });
+        const double sceneBounds = Bench::Best(5, [&] {
+            sceneBox = SvgBounds();
+            for (uint32_t item = scene->GetFirstDrawn(); item < scene->Size(); ++item)
+            {
+                if (scene->GetKind(item) != SvgScene::Kind::Group)
+                    sceneBox.Union(scene->GetFillBounds(item));
+            }
+        });
+        Row("bounds of everything", treeBounds, sceneBounds);
+
+        // A sixteenth of the document, in its middle.
+        const SvgBounds area{1536.0f, 1536.0f, 2560.0f, 2560.0f};
+        std::vector<const ISvgElement *> treeFound;
+        std::vector<uint32_t> sceneFound;
+        const double treeQuery = Bench::Best(5, [&] {
+            treeFound.clear();
+            for (const ISvgElement *element : document.GetElements())
+                TreeQuery(*element, SvgMatrix(), area, treeFound);
+        });
+        const double sceneQuery = Bench::Best(5, [&] {
+            sceneFound.clear();
+            scene->Query(area, sceneFound);
+        });
+        Row("query a 1/16 area", treeQuery, sceneQuery);
+
+        CountingRenderer treeAll, sceneAll, treeCulled, sceneCulled;
+        const double treeRender = Bench::Best(5, [&] { document.Render(treeAll); });
+        const double sceneRender = Bench::Best(5, [&] { scene->Render(sceneAll); });
+        Row("render everything", treeRender, sceneRender);
+        // The walk has no bounds to cull with, so it visits everything and
+        // leaves the rest to the renderer's clipping.
+        const double treeCull = Bench::Best(5, [&] { document.Render(treeCulled); });
+        const double sceneCull = Bench::Best(5, [&] { scene->Render(sceneCulled, area); });
+        Row("render a 1/16 viewport", treeCull, sceneCull);
+        std::printf("drawn: everything %zu / %zu, viewport %zu / %zu; found %zu / %zu\n", treeAll.drawn / 5,
+                    sceneAll.drawn / 5, treeCulled.drawn / 5, sceneCulled.drawn / 5, treeFound.size(), sceneFound.size());
+        g_sink = treeAll.sum + sceneAll.sum + treeBox.maxX + sceneBox.maxX;
+        return 0;
+    }
+
+    const bool registered = Bench::Register("scene", "[elements]: tree walk against SvgScene scans on a generated file",
+                                            SceneBench);
+}
@@ -0,0 +1,98 @@
+#include "SoftwareBlend.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace SoftwareBlend;
+
+namespace
+{
+    // Mostly any value, with opaque and transparent ones common, as they
+    // are in real drawings.
+    uint32_t RandomPixel(std::mt19937 &random)
+    {
+        uint32_t a = random() % 256;
+        if (random() % 4 == 0)
+            a = 255;
+        if (random() % 8 == 0)
+            a = 0;
+        return Premultiply(random(), random(), random(), static_cast<uint8_t>(a));
+    }
+
+    class SoftwareBlendKernels : public testing::TestWithParam<Isa>
+    {
+    };
+}
+
+// Every vector kernel has to compute exactly what the scalar one does.
+TEST_P(SoftwareBlendKernels, MatchScalar)
+{
+    const Kernels *kernels = KernelsFor(GetParam());
+    if (!kernels)
+        GTEST_SKIP() << IsaName(GetParam()) << " is not available on this CPU or in this build";
+    const Kernels *scalar = KernelsFor(Isa::Scalar);
+    ASSERT_NE(scalar, nullptr);
+
+    // Random spans of every length up to a few vectors, so each kernel's
+    // head, body and tail all run.
+    std::mt19937 random(1);
+    for (int run = 0; run < 20000; ++run)
+    {
+        const int count = static_cast<int>(random() % 70);
+        const int mode = static_cast<int>(random() % 4);
+        std::vector<uint32_t> dst(count), src(count);
+        std::vector<uint8_t> coverage(count);
+        for (int i = 0; i < count; ++i)
+        {
+            dst[i] = RandomPixel(random);
+            src[i] = RandomPixel(random);
+            const uint8_t partial = static_cast<uint8_t>(random());
+            coverage[i] = mode == 0 ? partial : mode == 1 ? 255 : mode == 2 ? 0 : (random() % 2 ? 255 : partial);
+        }
+        const uint32_t color = RandomPixel(random);
+
+        std::vector<uint32_t> expected = dst, actual = dst;
+        scalar->solidSpan(expected.data(), count, color, coverage.data());
+        kernels->solidSpan(actual.data(), count, color, coverage.data());
+        ASSERT_EQ(expected, actual) << "solidSpan, run " << run;
+
+        expected = actual = dst;
+        scalar->span(expected.data(), count, src.data(), coverage.data());
+        kernels->span(actual.data(), count, src.data(), coverage.data());
+        ASSERT_EQ(expected, actual) << "span, run " << run;
+    }
+
+    // Every source alpha and coverage over destinations of every alpha.
+    std::vector<uint32_t> dst(256);
+    for (uint32_t i = 0; i < 256; ++i)
+        dst[i] = i << 24 | i | (i / 2) << 8;
+    for (uint32_t a = 0; a < 256; ++a)
+    {
+        const uint32_t color = a << 24 | a | (a / 2) << 16;
+        for (uint32_t c = 0; c < 256; ++c)
+        {
+            const std::vector<uint8_t> coverage(256, static_cast<uint8_t>(c));
+            std::vector<uint32_t> expected = dst, actual = dst;
+            scalar->solidSpan(expected.data(), 256, color, coverage.data());
+            kernels->solidSpan(actual.data(), 256, color, coverage.data());
+            ASSERT_EQ(expected, actual) << "alpha " << a << ", coverage " << c;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Isa, SoftwareBlendKernels,
+                         testing::Values(Isa::Sse2, Isa::Sse41, Isa::Avx2, Isa::Avx512),
+                         [](const testing::TestParamInfo<Isa> &info) {
+                             // IsaName without what test names cannot hold.
+                             std::string name;
+                             for (const char *c = IsaName(info.param); *c; ++c)
+                             {
+                                 if (isalnum(static_cast<unsigned char>(*c)))
+                                     name += *c;
+                             }
+                             return name;
+                         });
+
+TEST(SoftwareBlend, ActiveIsaHasKernels)
+{
+    EXPECT_NE(KernelsFor(ActiveIsa()), nullptr);
+}
@@ -0,0 +1,124 @@
+#include "SoftwarePaint.h"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace
+{
+    const SvgBounds kBox{10.0f, 20.0f, 110.0f, 70.0f};
+    // A turn and a shear on the way to the pixels.
+    const SvgMatrix kToDevice{1.5f, 0.4f, -0.3f, 1.2f, 7.0f, -3.0f};
+
+    void AddStops(SvgGradient &gradient, const char *spread)
+    {
+        gradient.spreadMethod = spread;
+        gradient.stops = {{0.0f, Gdiplus::Color(255, 255, 0, 0)},
+                          {0.6f, Gdiplus::Color(200, 0, 128, 255)},
+                          {1.0f, Gdiplus::Color(255, 20, 220, 40)}};
+    }
+
+    std::unique_ptr<SvgGradient> Linear(const char *spread)
+    {
+        auto gradient = std::make_unique<SvgLinearGradient>();
+        gradient->x1 = 0.2f;
+        gradient->y1 = 0.1f;
+        gradient->x2 = 0.6f;
+        gradient->y2 = 0.7f;
+        AddStops(*gradient, spread);
+        return gradient;
+    }
+
+    // Its focal point well off the centre.
+    std::unique_ptr<SvgGradient> Radial(const char *spread)
+    {
+        auto gradient = std::make_unique<SvgRadialGradient>();
+        gradient->cx = 0.5f;
+        gradient->cy = 0.5f;
+        gradient->r = 0.3f;
+        gradient->fx = 0.65f;
+        gradient->fy = 0.4f;
+        gradient->hasFx = gradient->hasFy = true;
+        AddStops(*gradient, spread);
+        return gradient;
+    }
+
+    void Apply(const SvgMatrix &m, float x, float y, float &outX, float &outY)
+    {
+        outX = m.a * x + m.c * y + m.e;
+        outY = m.b * x + m.d * y + m.f;
+    }
+
+    int Distance(uint32_t a, uint32_t b)
+    {
+        int most = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+            most = (std::max)(most, std::abs(static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF)));
+        return most;
+    }
+}
+
+// What brush backends read, t at a point and its colour, is what Shade
+// fills the pixel with.
+TEST(SoftwarePaint, ColorOfTMatchesShade)
+{
+    for (const char *spread : {"pad", "reflect", "repeat"})
+    {
+        for (const auto &gradient : {Linear(spread), Radial(spread)})
+        {
+            const SoftwarePaint paint = SoftwarePaint::FromGradient(*gradient, kBox, kToDevice, 0.8f);
+            ASSERT_FALSE(paint.IsSolid());
+            int worst = 0;
+            for (int y = 0; y < 120; y += 3)
+            {
+                for (int x = -10; x < 200; x += 3)
+                {
+                    uint32_t shaded;
+                    paint.Shade(x, y, 1, &shaded);
+                    const uint32_t looked = paint.GetColor(paint.GetT(x + 0.5f, y + 0.5f));
+                    // The radial t is solved in doubles by Shade, so the two
+                    // may land on neighbouring table entries; a repeat's wrap
+                    // makes those far apart, so it is left to the linear case.
+                    if (!paint.IsRadial())
+                        EXPECT_EQ(looked, shaded) << spread << " at " << x << ", " << y;
+                    else if (gradient->spreadMethod != "repeat")
+                        worst = (std::max)(worst, Distance(looked, shaded));
+                }
+            }
+            EXPECT_LE(worst, 4) << spread;
+        }
+    }
+}
+
+// The frame puts t along its x for a linear gradient, and for a radial one
+// at 0 on the origin and 1 on the unit circle around the centre.
+TEST(SoftwarePaint, FrameMapsTheGradientOntoPixels)
+{
+    const auto linearGradient = Linear("pad"), radialGradient = Radial("pad");
+    const SoftwarePaint linear = SoftwarePaint::FromGradient(*linearGradient, kBox, kToDevice, 1.0f);
+    float x, y;
+    for (float t : {-0.5f, 0.0f, 0.3f, 1.0f, 2.0f})
+    {
+        for (float across : {-1.0f, 0.0f, 0.7f})
+        {
+            Apply(linear.GetFrame(), t, across, x, y);
+            EXPECT_NEAR(linear.GetT(x, y), t, 1e-4f);
+        }
+    }
+
+    const SoftwarePaint radial = SoftwarePaint::FromGradient(*radialGradient, kBox, kToDevice, 1.0f);
+    ASSERT_TRUE(radial.IsRadial());
+    Apply(radial.GetFrame(), 0.0f, 0.0f, x, y);
+    EXPECT_NEAR(radial.GetT(x, y), 0.0f, 1e-4f);
+    for (int k = 0; k < 16; ++k)
+    {
+        const float angle = k * 0.3927f;
+        const float cx = radial.GetCenterX() + std::cos(angle), cy = radial.GetCenterY() + std::sin(angle);
+        Apply(radial.GetFrame(), cx, cy, x, y);
+        EXPECT_NEAR(radial.GetT(x, y), 1.0f, 1e-3f);
+        // And t rises in proportion along the ray from the focal point,
+        // which is how a path gradient blends.
+        Apply(radial.GetFrame(), 0.4f * cx, 0.4f * cy, x, y);
+        EXPECT_NEAR(radial.GetT(x, y), 0.4f, 1e-3f);
+    }
+}
@@ -0,0 +1,145 @@
+#include "SoftwareRenderer.h"
+#include "SvgParser.h"
+#include "SvgScene.h"
+#include "TestSupport.h"
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+namespace
+{
+    // Golden images are drawn this many pixels along the longer side.
+    constexpr int kGoldenSize = 512;
+    // A channel may be off by this much, and this share of pixels by more,
+    // before a render counts as changed: room for another compiler's
+    // floating point, not for a visible difference.
+    constexpr int kTolerance = 2;
+    constexpr double kMaxDifferentShare = 0.001;
+
+    class SoftwareRendererGolden : public testing::TestWithParam<std::filesystem::path>
+    {
+    };
+}
+
+// Each fixture against TestCases/expected/<set>/<name>.png. The images
+// were drawn by this renderer and looked over, not taken from a reference
+// implementation: they catch changes to what it draws, not mistakes it
+// always made. Run with SVGREADER_UPDATE_GOLDENS=1 to write the images
+// instead, after a change meant to alter what is drawn.
+TEST_P(SoftwareRendererGolden, MatchesExpectedImage)
+{
+    const std::filesystem::path &path = GetParam();
+    SvgDocument document;
+    ASSERT_TRUE(TestSupport::Load(path, document));
+    int width, height;
+    const SvgMatrix view = TestSupport::FitView(document, kGoldenSize, width, height);
+    SoftwarePixmap pixmap(width, height);
+    SoftwareRenderer renderer(pixmap, view);
+    document.Render(renderer);
+    const TestSupport::Image image = TestSupport::ToImage(pixmap);
+
+    const std::filesystem::path golden = TestSupport::TestCasesDir() / "expected" /
+                                         path.parent_path().filename() / (path.stem().string() + ".png");
+    const char *update = std::getenv("SVGREADER_UPDATE_GOLDENS");
+    if (update && *update == '1')
+    {
+        ASSERT_TRUE(TestSupport::WritePng(golden, image));
+        return;
+    }
+    TestSupport::Image expected;
+    ASSERT_TRUE(TestSupport::ReadPng(golden, expected)) << golden;
+    ASSERT_EQ(expected.width, image.width);
+    ASSERT_EQ(expected.height, image.height);
+    const size_t differences = TestSupport::CountDifferences(image, expected, kTolerance);
+    EXPECT_LE(static_cast<double>(differences), kMaxDifferentShare * width * height)
+        << differences << " pixels differ from " << golden;
+}
+
+INSTANTIATE_TEST_SUITE_P(TestCases, SoftwareRendererGolden, testing::ValuesIn(TestSupport::Fixtures()),
+                         [](const auto &info) { return TestSupport::FixtureName(info.param); });
+
+namespace
+{
+    // The box around every pixel with some alpha; empty if there is none.
+    SvgBounds Ink(const SoftwarePixmap &pixmap)
+    {
+        SvgBounds ink;
+        for (int y = 0; y < pixmap.height; ++y)
+        {
+            for (int x = 0; x < pixmap.width; ++x)
+            {
+                if (pixmap.Row(y)[x] >> 24)
+                    ink.Union(SvgBounds{float(x), float(y), float(x + 1), float(y + 1)});
+            }
+        }
+        return ink;
+    }
+
+    SoftwarePixmap DrawText(const std::string &text, int width, int height)
+    {
+        SvgDocument document;
+        SvgParser parser;
+        parser.Parse("<svg xmlns='http://www.w3.org/2000/svg' width='" + std::to_string(width) + "' height='" +
+                         std::to_string(height) + "'>" + text + "</svg>",
+                     document);
+        SoftwarePixmap pixmap(width, height);
+        SoftwareRenderer renderer(pixmap);
+        document.Render(renderer);
+        return pixmap;
+    }
+}
+
+// Text is drawn from its baseline up, in its fill, placed by its anchor.
+TEST(SoftwareRenderer, DrawsText)
+{
+    // Capitals stand 0.7 em high on the baseline at y = 30.
+    const SoftwarePixmap start = DrawText("<text x='10' y='30' font-size='20' fill='#00f'>HI</text>", 100, 40);
+    const SvgBounds ink = Ink(start);
+    EXPECT_GE(ink.minX, 10.0f);
+    EXPECT_LE(ink.minX, 13.0f);
+    EXPECT_NEAR(ink.minY, 16.0f, 1.0f);
+    EXPECT_NEAR(ink.maxY, 31.0f, 1.0f);
+    // Inside the H's left stem.
+    EXPECT_EQ(start.Row(23)[11], 0xFFFF0000u);
+
+    // The same text ending at x = 90 and centred on it.
+    const SvgBounds end = Ink(DrawText("<text x='90' y='30' font-size='20' text-anchor='end'>HI</text>", 100, 40));
+    EXPECT_LE(end.maxX, 90.0f);
+    EXPECT_GE(end.maxX, 87.0f);
+    EXPECT_NEAR(end.maxX - end.minX, ink.maxX - ink.minX, 1.0f);
+    const SvgBounds middle =
+        Ink(DrawText("<text x='50' y='30' font-size='20' text-anchor='middle'>HI</text>", 100, 40));
+    EXPECT_NEAR((middle.minX + middle.maxX) * 0.5f, 50.0f, 1.0f);
+}
+
+// Every glyph, stroked, stays inside the bounds the scene culls and the
+// tiler bins text by (from SvgText::UpdateFillBox); a second line too.
+TEST(SoftwareRenderer, TextStaysInsideItsBox)
+{
+    std::string all;
+    for (char ch = ' '; ch <= '~'; ++ch)
+    {
+        if (ch != '<' && ch != '&')
+            all += ch;
+    }
+    all += "&lt;&amp;\n\u00e9";
+    for (const char *anchor : {"start", "middle", "end"})
+    {
+        const std::string text = std::string("<text x='1200' y='50' font-size='24' stroke='red' stroke-width='3' ") +
+                                 "text-anchor='" + anchor + "'>" + all + "</text>";
+        SvgDocument document;
+        SvgParser parser;
+        parser.Parse("<svg xmlns='http://www.w3.org/2000/svg' width='2400' height='120'>" + text + "</svg>",
+                     document);
+        ASSERT_EQ(document.GetElements().size(), 1u);
+        SoftwarePixmap pixmap(2400, 120);
+        SoftwareRenderer renderer(pixmap);
+        document.Render(renderer);
+        // A pixel more each way for anti-aliasing, as the tiler allows.
+        SvgBounds box = SvgScene(document).GetBounds();
+        box.Inflate(1.0f);
+        const SvgBounds ink = Ink(pixmap);
+        ASSERT_FALSE(ink.Empty()) << anchor;
+        EXPECT_TRUE(box.minX <= ink.minX && box.minY <= ink.minY && box.maxX >= ink.maxX && box.maxY >= ink.maxY)
+            << anchor;
+    }
+}
@@ -0,0 +1,42 @@
+#include "SoftwareTiler.h"
+#include "SvgScene.h"
+#include "TestSupport.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    class SoftwareTilerFixture : public testing::TestWithParam<std::filesystem::path>
+    {
+    };
+}
+
+// Tiled rendering on any number of threads gives exactly the pixels of one
+// SoftwareRenderer drawing the document. 1000 pixels makes 16 tiles, the
+// last one partial, at a scale that is not a round number for any fixture.
+TEST_P(SoftwareTilerFixture, MatchesSerialOnAnyThreadCount)
+{
+    SvgDocument document;
+    ASSERT_TRUE(TestSupport::Load(GetParam(), document));
+    int width, height;
+    const SvgMatrix view = TestSupport::FitView(document, 1000, width, height);
+    SoftwarePixmap serial(width, height);
+    SoftwareRenderer renderer(serial, view);
+    document.Render(renderer);
+
+    const SvgScene scene(document);
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u})
+    {
+        SoftwarePixmap tiled(width, height);
+        SoftwareTiler tiler;
+        tiler.SetMaxThreads(threads);
+        tiler.Render(scene, tiled, view);
+        size_t differences = 0;
+        for (size_t i = 0; i < serial.pixels.size(); ++i)
+            differences += serial.pixels[i] != tiled.pixels[i];
+        EXPECT_EQ(differences, 0u) << threads << " threads";
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestCases, SoftwareTilerFixture,
+                         testing::ValuesIn(TestSupport::Fixtures()),
+                         [](const auto &info) { return TestSupport::FixtureName(info.param); });
@@ -0,0 +1,66 @@
+#include "SoftwareRenderer.h"
+#include "SvgDisplayList.h"
+#include "SvgScene.h"
+#include "TestSupport.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    class SvgDisplayListFixture : public testing::TestWithParam<std::filesystem::path>
+    {
+    };
+
+    size_t CountDifferences(const SoftwarePixmap &a, const SoftwarePixmap &b)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < a.pixels.size(); ++i)
+            count += a.pixels[i] != b.pixels[i];
+        return count;
+    }
+}
+
+// Replaying the display list, and drawing the scene, gives exactly the
+// pixels of walking the element tree, at scales that leave the products
+// of the transforms rounded: fitted to 800 pixels as the viewer fits, and
+// a few others.
+TEST_P(SvgDisplayListFixture, ReplayMatchesTreeWalk)
+{
+    SvgDocument document;
+    ASSERT_TRUE(TestSupport::Load(GetParam(), document));
+    const SvgScene scene(document);
+    const SvgDisplayList list(scene);
+    int fittedWidth, fittedHeight;
+    const float fitted = TestSupport::FitView(document, 800, fittedWidth, fittedHeight).a;
+    float width, height;
+    TestSupport::DocumentSize(document, width, height);
+
+    for (float scale : {fitted, 1.0f, 0.37f, 2.5f})
+    {
+        const int w = (std::min)(2048, static_cast<int>(std::ceil(width * scale)));
+        const int h = (std::min)(2048, static_cast<int>(std::ceil(height * scale)));
+        const SvgMatrix view{scale, 0.0f, 0.0f, scale, 0.0f, 0.0f};
+
+        SoftwarePixmap walked(w, h);
+        SoftwareRenderer walker(walked, view);
+        document.Render(walker);
+
+        SoftwarePixmap replayed(w, h);
+        SoftwareRenderer replayer(replayed, view);
+        list.Replay(replayer);
+        EXPECT_EQ(CountDifferences(walked, replayed), 0u) << "display list, scale " << scale;
+
+        // The view given to Replay instead of the renderer.
+        SoftwarePixmap rooted(w, h);
+        SoftwareRenderer rootedReplayer(rooted);
+        list.Replay(rootedReplayer, view);
+        EXPECT_EQ(CountDifferences(walked, rooted), 0u) << "display list under root, scale " << scale;
+
+        SoftwarePixmap flat(w, h);
+        SoftwareRenderer flatRenderer(flat, view);
+        scene.Render(flatRenderer);
+        EXPECT_EQ(CountDifferences(walked, flat), 0u) << "scene, scale " << scale;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestCases, SvgDisplayListFixture, testing::ValuesIn(TestSupport::Fixtures()),
+                         [](const auto &info) { return TestSupport::FixtureName(info.param); });
@@ -0,0 +1,204 @@
+#include "AllocationCounter.h"
+#include "SoftwareRenderer.h"
+#include "SvgEditor.h"
+#include "SvgParser.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    SvgEditor Open(const char *xml)
+    {
+        SvgDocument document;
+        SvgParser parser;
+        EXPECT_TRUE(parser.Parse(std::string(xml), document));
+        return SvgEditor(std::move(document));
+    }
+
+    bool Covers(const SvgBounds &outer, const SvgBounds &inner)
+    {
+        return outer.minX <= inner.minX && outer.minY <= inner.minY && outer.maxX >= inner.maxX &&
+               outer.maxY >= inner.maxY;
+    }
+
+    uint32_t PixelAt(const SvgEditor &editor, int x, int y)
+    {
+        SoftwarePixmap pixmap(100, 100);
+        SoftwareRenderer renderer(pixmap);
+        editor.GetDocument().Render(renderer);
+        return pixmap.pixels[y * 100 + x];
+    }
+}
+
+// Editing what a symbol holds damages every use of it, before and after.
+TEST(SvgEditor, SymbolEditDamagesEveryInstance)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<symbol id='s'><rect id='r' width='10' height='10'/></symbol>"
+                            "<use href='#s' x='0' y='0'/>"
+                            "<use href='#s' x='50' y='60'/></svg>");
+    auto rect = dynamic_cast<SvgRect *>(editor.Find("r"));
+    ASSERT_NE(rect, nullptr);
+    const SvgBounds damage = editor.SetRect(*rect, 2, 2, 20, 20);
+    EXPECT_TRUE(Covers(damage, SvgBounds{0, 0, 22, 22}));
+    EXPECT_TRUE(Covers(damage, SvgBounds{50, 60, 72, 82}));
+    // The scene's bounds follow.
+    EXPECT_TRUE(Covers(editor.GetScene().GetBounds(), SvgBounds{50, 60, 72, 82}));
+
+    const SvgBounds fill = editor.SetFill(*rect, Gdiplus::Color(255, 0, 0));
+    EXPECT_TRUE(Covers(fill, SvgBounds{52, 62, 72, 82}));
+    EXPECT_EQ(PixelAt(editor, 10, 10), 0xFF0000FFu);
+    EXPECT_EQ(PixelAt(editor, 60, 70), 0xFF0000FFu);
+}
+
+// A use inside a symbol passes the damage on to the uses of that symbol.
+TEST(SvgEditor, NestedUseEditReachesOuterInstances)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<defs><circle id='c' r='5'/>"
+                            "<g id='pair'><use href='#c' x='5' y='5'/><use href='#c' x='25' y='5'/></g></defs>"
+                            "<use href='#pair' y='70'/></svg>");
+    auto circle = dynamic_cast<SvgCircle *>(editor.Find("c"));
+    ASSERT_NE(circle, nullptr);
+    const SvgBounds damage = editor.SetCircle(*circle, 0, 0, 8);
+    EXPECT_TRUE(Covers(damage, SvgBounds{-3, 67, 33, 83}));
+}
+
+// Definitions nothing draws have nothing to repaint.
+TEST(SvgEditor, UnusedDefinitionDamagesNothing)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<defs><rect id='r' width='10' height='10'/></defs>"
+                            "<symbol id='s'><rect id='q' width='10' height='10'/></symbol></svg>");
+    for (const char *id : {"r", "q"})
+    {
+        auto rect = dynamic_cast<SvgRect *>(editor.Find(id));
+        ASSERT_NE(rect, nullptr);
+        EXPECT_TRUE(editor.SetRect(*rect, 1, 1, 5, 5).Empty()) << id;
+        EXPECT_TRUE(editor.SetFill(*rect, Gdiplus::Color(0, 0, 255)).Empty()) << id;
+    }
+}
+
+// A drawn element that a use also draws damages both places.
+TEST(SvgEditor, DrawnAndUsedElement)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<rect id='r' width='10' height='10'/><use href='#r' x='80' y='80'/></svg>");
+    auto rect = dynamic_cast<SvgRect *>(editor.Find("r"));
+    ASSERT_NE(rect, nullptr);
+    const SvgBounds damage = editor.SetRect(*rect, 0, 0, 5, 5);
+    EXPECT_TRUE(Covers(damage, SvgBounds{0, 0, 10, 10}));
+    EXPECT_TRUE(Covers(damage, SvgBounds{80, 80, 90, 90}));
+}
+
+// Editing the same elements over and over settles into reusing memory:
+// once the buffers have grown to the largest size asked for, further
+// edits neither allocate more nor grow the style table.
+TEST(SvgEditor, RepeatedEditsReuseMemory)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<polyline id='l' points='0,0 10,10'/><path id='p' d='M0 0 L10 10'/>"
+                            "<text id='t' x='0' y='20'>a</text></svg>");
+    auto polyline = dynamic_cast<SvgPolyline *>(editor.Find("l"));
+    auto path = dynamic_cast<SvgPath *>(editor.Find("p"));
+    auto text = dynamic_cast<SvgText *>(editor.Find("t"));
+    ASSERT_TRUE(polyline && path && text);
+
+    auto edit = [&](int round)
+    {
+        // Sizes that go up and down, and a colour never used before.
+        const int count = 10 + (round * 7) % 50;
+        std::vector<Gdiplus::PointF> points;
+        std::string d = "M0 0";
+        for (int i = 0; i < count; ++i)
+        {
+            points.emplace_back(static_cast<float>(i), static_cast<float>(round % 90));
+            d += " L" + std::to_string(i) + " " + std::to_string(round % 90);
+        }
+        editor.SetPoints(*polyline, points);
+        editor.SetPath(*path, d);
+        editor.SetText(*text, std::wstring(static_cast<size_t>(count), L'x'));
+        editor.SetFill(*path, Gdiplus::Color(static_cast<uint8_t>(round), static_cast<uint8_t>(round >> 8), 0));
+        editor.SetStrokeWidth(*polyline, 1.0f + static_cast<float>(round));
+    };
+
+    for (int round = 0; round < 200; ++round)
+        edit(round);
+    const size_t styles = editor.GetDocument().GetStyles().Size();
+    const AllocationCounter::Totals before = AllocationCounter::Now();
+    for (int round = 200; round < 2200; ++round)
+        edit(round);
+    const AllocationCounter::Totals after = AllocationCounter::Now();
+
+    EXPECT_EQ(editor.GetDocument().GetStyles().Size(), styles);
+    // A little slack for the hash tables' buckets.
+    EXPECT_LE(after.liveBytes, before.liveBytes + 4096);
+}
+
+// A record freed by one edit and taken up again through an existing style
+// is not handed out as free: the next new colour must not rewrite it.
+TEST(SvgEditor, RestyleKeepsRecordsTakenBackInUse)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<rect id='a' width='10' height='10' fill='gray'/>"
+                            "<rect id='b' width='10' height='10' fill='blue'/>"
+                            "<rect id='c' width='10' height='10' fill='black'/>"
+                            "<rect id='d' width='10' height='10' fill='yellow'/>"
+                            "<rect width='10' height='10' fill='yellow'/>"
+                            "<rect width='10' height='10' fill='blue'/></svg>");
+    ISvgElement *a = editor.Find("a"), *b = editor.Find("b"), *c = editor.Find("c"), *d = editor.Find("d");
+    ASSERT_TRUE(a && b && c && d);
+    const SvgStyleTable &styles = editor.GetDocument().GetStyles();
+
+    // a and c own their records, which become red and green.
+    editor.SetFill(*a, Gdiplus::Color(255, 0, 0));
+    editor.SetFill(*c, Gdiplus::Color(0, 255, 0));
+    // a moves to green, freeing red; b takes red back.
+    editor.SetFill(*a, Gdiplus::Color(0, 255, 0));
+    EXPECT_EQ(a->style, c->style);
+    editor.SetFill(*b, Gdiplus::Color(255, 0, 0));
+    // d shares its record, so a new colour needs another one.
+    editor.SetFill(*d, Gdiplus::Color(1, 2, 3));
+
+    EXPECT_EQ(styles[b->style].fillColor.GetValue(), 0xFFFF0000u);
+    EXPECT_EQ(styles[d->style].fillColor.GetValue(), 0xFF010203u);
+    EXPECT_EQ(styles[a->style].fillColor.GetValue(), 0xFF00FF00u);
+}
+
+// Edits that grow, shrink and move shapes inside nested groups, and move
+// the groups themselves, leave every box where a scene built afresh from
+// the edited document puts it.
+TEST(SvgEditor, SceneBoundsMatchARebuild)
+{
+    SvgEditor editor = Open("<svg xmlns='http://www.w3.org/2000/svg' width='100' height='100'>"
+                            "<g id='outer'><rect id='a' x='10' y='10' width='10' height='10'/>"
+                            "<g id='inner' transform='translate(5 5)'>"
+                            "<rect id='b' x='30' y='30' width='10' height='10' stroke='black' stroke-width='2'/>"
+                            "<rect id='c' x='50' y='20' width='5' height='5'/></g></g>"
+                            "<rect id='d' x='70' y='70' width='20' height='20'/></svg>");
+    SvgRect *rects[] = {dynamic_cast<SvgRect *>(editor.Find("a")), dynamic_cast<SvgRect *>(editor.Find("b")),
+                        dynamic_cast<SvgRect *>(editor.Find("c")), dynamic_cast<SvgRect *>(editor.Find("d"))};
+    ISvgElement *groups[] = {editor.Find("outer"), editor.Find("inner")};
+    for (SvgRect *rect : rects)
+        ASSERT_NE(rect, nullptr);
+    ASSERT_TRUE(groups[0] && groups[1]);
+
+    for (int round = 0; round < 60; ++round)
+    {
+        // Out past the others and back in, so edges both grow and shrink.
+        const float size = static_cast<float>((round * 37) % 90 + 1);
+        const float at = static_cast<float>((round * 53) % 120) - 10.0f;
+        if (round % 5 == 4)
+            editor.SetTransform(*groups[round % 2], SvgMatrix{1.0f, 0.0f, 0.0f, 1.0f, at / 4.0f, -at / 8.0f});
+        else
+            editor.SetRect(*rects[round % 4], at, 100.0f - at - size, size, size / 2.0f);
+
+        const SvgScene &scene = editor.GetScene();
+        const SvgScene rebuilt(editor.GetDocument());
+        ASSERT_EQ(scene.GetBounds(), rebuilt.GetBounds()) << "round " << round;
+        for (uint32_t item = 0; item < scene.Size(); ++item)
+        {
+            ASSERT_EQ(scene.GetBounds(item), rebuilt.GetBounds(item)) << "round " << round << ", item " << item;
+            ASSERT_EQ(scene.GetFillBounds(item), rebuilt.GetFillBounds(item)) << "round " << round;
+        }
+    }
+}
@@ -0,0 +1,221 @@
+#include "AllocationCounter.h"
+#include "RapidXmlNodeAdapter.h"
+#include "SvgParser.h"
+#include "SvgScene.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    class SvgParserFixture : public testing::TestWithParam<std::filesystem::path>
+    {
+    };
+
+    // Reads what the parser reads of every element: the tag, the
+    // attributes it looks up by name, all of them in turn, the text and
+    // the children. Adds up the bytes seen and returns the elements.
+    size_t Walk(const IXMLNode &node, size_t &bytes)
+    {
+        size_t elements = 1;
+        bytes += node.getTagName().size() + node.getTextContent().size();
+        for (const char *name : {"id", "transform", "style", "class", "fill", "d", "points"})
+            bytes += node.getAttribute(name).size();
+        node.forEachAttribute([&](std::string_view name, std::string_view value)
+        {
+            bytes += name.size() + value.size();
+        });
+        node.forEachChild([&](const IXMLNode &child)
+        {
+            elements += Walk(child, bytes);
+        });
+        return elements;
+    }
+
+    size_t Allocations(const std::string &xml)
+    {
+        SvgParser parser;
+        parser.SetMaxThreads(1);
+        std::vector<char> buffer(xml.begin(), xml.end());
+        buffer.push_back('\0');
+        const size_t before = AllocationCounter::Now().allocations;
+        SvgDocument document;
+        EXPECT_TRUE(parser.Parse(std::span<char>(buffer), document));
+        return AllocationCounter::Now().allocations - before;
+    }
+
+    // Every file under TestCases, read once.
+    std::vector<std::string> AllTestCases()
+    {
+        std::vector<std::string> texts;
+        for (const char *set : {"ms2", "ms3", "symbol"})
+        {
+            for (const auto &path : TestSupport::Fixtures(set))
+                texts.push_back(TestSupport::ReadFile(path));
+        }
+        return texts;
+    }
+
+    // Small, as the stress test draws every file many times.
+    constexpr int kStressSize = 96;
+
+    std::vector<uint32_t> ParseAndDraw(const SvgParser &parser, const std::string &text, bool streamed)
+    {
+        SvgDocument document;
+        if (streamed)
+        {
+            std::istringstream input(text);
+            parser.Parse(input, document);
+        }
+        else
+        {
+            parser.Parse(text, document);
+        }
+        return TestSupport::Draw(document, kStressSize).pixels;
+    }
+}
+
+// Walking the DOM through IXMLNode hands out views into the buffer and
+// stack adapters, and allocates nothing at all.
+TEST_P(SvgParserFixture, WalkAllocatesNothing)
+{
+    std::string text = TestSupport::ReadFile(GetParam());
+    ASSERT_FALSE(text.empty());
+    rapidxml::xml_document<> dom;
+    dom.parse<0>(text.data());
+    const RapidXmlNodeAdapter root(dom.first_node("svg"));
+
+    size_t bytes = 0;
+    const size_t before = AllocationCounter::Now().allocations;
+    const size_t elements = Walk(root, bytes);
+    EXPECT_EQ(AllocationCounter::Now().allocations - before, 0u) << elements << " elements";
+    EXPECT_GT(bytes, 0u);
+}
+
+// Loading allocates nothing per element: 63 more copies of everything the
+// file draws add only the arena's few, growing blocks. Gradients are left
+// out of the copies, as they are shared paint servers on the heap.
+TEST_P(SvgParserFixture, LoadDoesNotAllocatePerElement)
+{
+    const std::string text = TestSupport::ReadFile(GetParam());
+    const size_t open = text.find('>', text.find("<svg")) + 1, close = text.rfind("</svg>");
+    ASSERT_NE(close, std::string::npos);
+    const std::string body = text.substr(open, close - open);
+    const std::regex gradients(R"(<(linear|radial)Gradient[^>]*/>|<(linear|radial)Gradient[\s\S]*?</(linear|radial)Gradient>)");
+    const std::string copy = std::regex_replace(body, gradients, "");
+
+    std::string repeated = text.substr(0, open) + body;
+    for (int i = 1; i < 64; ++i)
+        repeated += copy;
+    repeated += text.substr(close);
+
+    // The first load sets up what is kept per thread.
+    Allocations(text);
+    const size_t once = Allocations(text);
+    const size_t many = Allocations(repeated);
+    EXPECT_LE(many, once + 32) << once << " allocations once, " << many << " with 63 more copies";
+}
+
+// One shared parser loads every file under TestCases on eight threads at
+// once, through both the DOM and the streaming parser, and each document
+// draws as the one loaded alone does. Build with SVGREADER_TSAN to have
+// ThreadSanitizer watch it.
+TEST(SvgParser, ConcurrentLoadsMatchSerial)
+{
+    const std::vector<std::string> texts = AllTestCases();
+    SvgParser parser;
+    parser.SetMaxThreads(1);
+    std::vector<std::vector<uint32_t>> expected[2];
+    for (int streamed = 0; streamed < 2; ++streamed)
+    {
+        for (const std::string &text : texts)
+            expected[streamed].push_back(ParseAndDraw(parser, text, streamed));
+    }
+
+    constexpr int kThreads = 8, kRounds = 2;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            // Each thread starts at a different file and alternates
+            // parsers, so different work overlaps.
+            for (size_t n = 0; n < texts.size() * kRounds; ++n)
+            {
+                const size_t i = (n + t * 3) % texts.size();
+                const bool streamed = (n + t) % 2 != 0;
+                if (ParseAndDraw(parser, texts[i], streamed) != expected[streamed][i])
+                    ++mismatches;
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    EXPECT_EQ(mismatches, 0);
+}
+
+// A document big enough to be built on worker threads comes out the same
+// whatever the thread count: the same items in the same order, drawn the
+// same. It has a group bigger than any piece, so that is split too, a
+// stylesheet, a gradient defined twice, which the last definition wins,
+// and ids given twice, which the first element in the document keeps: one
+// that the split group repeats, and one at each end of that group.
+TEST(SvgParser, ParallelBuildMatchesSerial)
+{
+    const std::string generated = TestSupport::GenerateDocument(20000);
+    const size_t open = generated.find('>') + 1, close = generated.rfind("</svg>");
+    const std::string xml =
+        generated.substr(0, open) +
+        "<style>circle { stroke: #0a0; } .hot { fill: red; }</style>"
+        "<linearGradient id='paint'><stop offset='0' stop-color='blue'/></linearGradient>"
+        "<rect id='outer' width='7' height='7'/>"
+        "<g id='outer' transform='scale(0.5)'>"
+        "<rect id='twin' width='9' height='9'/>" + generated.substr(open, close - open) + "<circle id='twin' r='9'/>"
+        "</g>"
+        "<rect class='hot' width='500' height='500'/>"
+        "<rect width='400' height='400' fill='url(#paint)'/>"
+        "<linearGradient id='paint'><stop offset='0' stop-color='yellow'/></linearGradient>"
+        "</svg>";
+
+    auto load = [&](unsigned threads, SvgDocument &document)
+    {
+        SvgParser parser;
+        parser.SetMaxThreads(threads);
+        ASSERT_TRUE(parser.Parse(xml, document));
+    };
+    SvgDocument serial;
+    load(1, serial);
+    const SvgScene serialScene(serial);
+    const std::vector<uint32_t> serialPixels = TestSupport::Draw(serial, 512).pixels;
+    for (const char *id : {"outer", "twin"})
+        ASSERT_NE(dynamic_cast<const SvgRect *>(serial.FindElement(id)), nullptr) << id;
+
+    for (unsigned threads : {2u, 3u, 8u, 16u})
+    {
+        SvgDocument parallel;
+        load(threads, parallel);
+        const SvgScene scene(parallel);
+        ASSERT_EQ(scene.Size(), serialScene.Size()) << threads << " threads";
+        for (uint32_t item = 0; item < scene.Size(); ++item)
+        {
+            ASSERT_EQ(scene.GetKind(item), serialScene.GetKind(item)) << threads << " threads, item " << item;
+            ASSERT_EQ(scene.GetBounds(item).minX, serialScene.GetBounds(item).minX) << threads << " threads";
+            ASSERT_EQ(scene.GetBounds(item).maxY, serialScene.GetBounds(item).maxY) << threads << " threads";
+        }
+        EXPECT_EQ(TestSupport::Draw(parallel, 512).pixels, serialPixels) << threads << " threads";
+        for (const char *id : {"outer", "twin"})
+        {
+            const ISvgElement *found = parallel.FindElement(id);
+            ASSERT_NE(found, nullptr) << id;
+            EXPECT_NE(dynamic_cast<const SvgRect *>(found), nullptr) << threads << " threads, #" << id;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Ms3, SvgParserFixture, testing::ValuesIn(TestSupport::Fixtures("ms3")),
+                         [](const testing::TestParamInfo<std::filesystem::path> &info)
+                         { return TestSupport::FixtureName(info.param); });
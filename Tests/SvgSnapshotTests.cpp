@@ -0,0 +1,70 @@
+#include "SoftwareRenderer.h"
+#include "SvgSnapshot.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace
+{
+    class SvgSnapshotFixture : public testing::TestWithParam<std::filesystem::path>
+    {
+    };
+
+    constexpr int kSize = 256;
+
+    // The ways a viewer draws a snapshot: the scene, the display list, and
+    // the scene culled to what the view shows.
+    std::vector<uint32_t> Draw(const SvgSnapshot &snapshot, int way)
+    {
+        int width, height;
+        const SvgMatrix view = TestSupport::FitView(snapshot.GetDocument(), kSize, width, height);
+        SoftwarePixmap pixmap(width, height);
+        if (way == 1)
+        {
+            SoftwareRenderer renderer(pixmap);
+            snapshot.GetDisplayList().Replay(renderer, view);
+            return pixmap.pixels;
+        }
+        SoftwareRenderer renderer(pixmap, view);
+        if (way == 0)
+            snapshot.Render(renderer);
+        else
+            snapshot.Render(renderer, SvgBounds{0.0f, 0.0f, width / view.a, height / view.d});
+        return pixmap.pixels;
+    }
+}
+
+// One snapshot drawn by sixteen threads at once, each with its own pixmap
+// and renderer and all three ways in turn, gives every time the pixels of
+// the document drawn alone before it was frozen. Build with SVGREADER_TSAN
+// to have ThreadSanitizer watch it.
+TEST_P(SvgSnapshotFixture, SixteenThreadsDrawLikeOne)
+{
+    SvgDocument document;
+    ASSERT_TRUE(TestSupport::Load(GetParam(), document));
+    const std::vector<uint32_t> expected = TestSupport::Draw(document, kSize).pixels;
+    const std::shared_ptr<const SvgSnapshot> snapshot = SvgSnapshot::Freeze(std::move(document));
+
+    constexpr int kThreads = 16, kRounds = 6;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        // Each thread holds the snapshot through a shared_ptr of its own.
+        threads.emplace_back([&mismatches, &expected, shared = snapshot, t]
+        {
+            for (int round = 0; round < kRounds; ++round)
+            {
+                if (Draw(*shared, (round + t) % 3) != expected)
+                    ++mismatches;
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    EXPECT_EQ(mismatches, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(TestCases, SvgSnapshotFixture, testing::ValuesIn(TestSupport::Fixtures()),
+                         [](const auto &info) { return TestSupport::FixtureName(info.param); });
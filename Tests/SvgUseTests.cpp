@@ -0,0 +1,100 @@
+#include "SoftwareRenderer.h"
+#include "SvgParser.h"
+#include "TestSupport.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace
+{
+    void ExpectMatrix(const SvgMatrix &m, float a, float b, float c, float d, float e, float f)
+    {
+        EXPECT_FLOAT_EQ(m.a, a);
+        EXPECT_FLOAT_EQ(m.b, b);
+        EXPECT_FLOAT_EQ(m.c, c);
+        EXPECT_FLOAT_EQ(m.d, d);
+        EXPECT_FLOAT_EQ(m.e, e);
+        EXPECT_FLOAT_EQ(m.f, f);
+    }
+
+    // Parsed whole, or streamed when stream is set.
+    SoftwarePixmap Render(const std::filesystem::path &path, bool stream = false)
+    {
+        SvgDocument document;
+        if (stream)
+        {
+            std::ifstream in(path, std::ios::binary);
+            EXPECT_TRUE(SvgParser().Parse(in, document));
+        }
+        else
+        {
+            EXPECT_TRUE(TestSupport::Load(path, document));
+        }
+        SoftwarePixmap pixmap(400, 200);
+        SoftwareRenderer renderer(pixmap, SvgMatrix{2.0f, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f});
+        document.Render(renderer);
+        return pixmap;
+    }
+}
+
+TEST(SvgViewBox, Parse)
+{
+    SvgViewBox box;
+    EXPECT_FALSE(box.Parse("0 0 10", ""));
+    EXPECT_FALSE(box.Parse("0 0 10 0", ""));
+    ASSERT_TRUE(box.Parse("1,2 30 40", "xMaxYMin slice"));
+    EXPECT_EQ(box.x, 1.0f);
+    EXPECT_EQ(box.height, 40.0f);
+    EXPECT_EQ(box.alignX, SvgViewBox::Align::Max);
+    EXPECT_EQ(box.alignY, SvgViewBox::Align::Min);
+    EXPECT_TRUE(box.slice);
+    ASSERT_TRUE(box.Parse("0 0 1 1", "defer none"));
+    EXPECT_EQ(box.alignX, SvgViewBox::Align::None);
+    ASSERT_TRUE(box.Parse("0 0 1 1", ""));
+    EXPECT_EQ(box.alignX, SvgViewBox::Align::Mid);
+    EXPECT_FALSE(box.slice);
+}
+
+TEST(SvgViewBox, Fit)
+{
+    SvgViewBox box;
+    ASSERT_TRUE(box.Parse("10 20 10 10", ""));
+    // Meet: the smaller scale, centred along the other axis.
+    ExpectMatrix(box.Fit(40, 20), 2, 0, 0, 2, 10 - 20, -40);
+    ASSERT_TRUE(box.Parse("10 20 10 10", "xMinYMax slice"));
+    // Slice: the larger scale, overflowing at the high end of y.
+    ExpectMatrix(box.Fit(40, 20), 4, 0, 0, 4, -40, 20 - 40 - 80);
+    ASSERT_TRUE(box.Parse("10 20 10 10", "none"));
+    ExpectMatrix(box.Fit(40, 20), 4, 0, 0, 2, -40, -40);
+}
+
+// Symbols fitted into their uses' viewports draw what the same content
+// does under the transforms those viewports make, written out by hand.
+TEST(SvgUse, SymbolViewportMatchesExplicitTransforms)
+{
+    const std::filesystem::path dir = TestSupport::TestCasesDir() / "symbol";
+    const SoftwarePixmap actual = Render(dir / "viewbox.svg");
+    const SoftwarePixmap expected = Render(dir / "viewbox-expected.svg");
+    size_t differences = 0;
+    for (size_t i = 0; i < actual.pixels.size(); ++i)
+        differences += actual.pixels[i] != expected.pixels[i];
+    EXPECT_EQ(differences, 0u);
+    EXPECT_EQ(Render(dir / "viewbox.svg", true).pixels, actual.pixels) << "streamed";
+    // Something was drawn: the full-size badge fills the middle.
+    EXPECT_EQ(actual.pixels[100 * 400 + 200] >> 24, 0xFFu);
+}
+
+// A use of zero width draws nothing.
+TEST(SvgUse, EmptyViewportDrawsNothing)
+{
+    SvgDocument document;
+    SvgParser parser;
+    parser.Parse(std::string("<svg xmlns='http://www.w3.org/2000/svg' width='20' height='20'>"
+                             "<symbol id='s' viewBox='0 0 1 1'><rect width='1' height='1'/></symbol>"
+                             "<use href='#s' width='0' height='20'/></svg>"),
+                 document);
+    SoftwarePixmap pixmap(20, 20);
+    SoftwareRenderer renderer(pixmap);
+    document.Render(renderer);
+    for (uint32_t pixel : pixmap.pixels)
+        ASSERT_EQ(pixel, 0u);
+}
@@ -0,0 +1,217 @@
+#include "TestSupport.h"
+#include "SvgParser.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <png.h>
+
+namespace TestSupport
+{
+    std::filesystem::path TestCasesDir()
+    {
+        return SVGREADER_TESTCASES_DIR;
+    }
+
+    std::vector<std::filesystem::path> Fixtures(const std::string &set)
+    {
+        std::vector<std::filesystem::path> paths;
+        for (const auto &entry : std::filesystem::directory_iterator(TestCasesDir() / set))
+        {
+            if (entry.path().extension() == ".svg")
+                paths.push_back(entry.path());
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::vector<std::filesystem::path> Fixtures()
+    {
+        std::vector<std::filesystem::path> paths = Fixtures("ms2");
+        for (const auto &path : Fixtures("ms3"))
+            paths.push_back(path);
+        return paths;
+    }
+
+    std::string FixtureName(const std::filesystem::path &path)
+    {
+        std::string name = path.parent_path().filename().string() + "_" + path.stem().string();
+        for (char &c : name)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(c)))
+                c = '_';
+        }
+        return name;
+    }
+
+    std::string ReadFile(const std::filesystem::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::string GenerateDocument(size_t elements)
+    {
+        static const char *const kFills[] = {"#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b"};
+        uint32_t seed = 12345;
+        auto next = [&seed](int range)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<int>((seed >> 8) % static_cast<uint32_t>(range));
+        };
+
+        std::string xml = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"4096\" height=\"4096\">\n";
+        xml.reserve(elements * 110);
+        char line[256];
+        for (size_t i = 0; i < elements; ++i)
+        {
+            if (i % 64 == 0)
+            {
+                if (i)
+                    xml += "</g>\n";
+                std::snprintf(line, sizeof line, "<g transform=\"translate(%d %d)\" fill=\"%s\">\n", next(3968),
+                              next(3968), kFills[next(6)]);
+                xml += line;
+            }
+            const int x = next(128), y = next(128);
+            switch (i % 6)
+            {
+            case 0:
+                std::snprintf(line, sizeof line, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\"/>\n", x, y,
+                              next(20) + 1, next(20) + 1);
+                break;
+            case 1:
+                std::snprintf(line, sizeof line, "<circle cx=\"%d\" cy=\"%d\" r=\"%d\" stroke=\"#000\"/>\n", x, y,
+                              next(10) + 1);
+                break;
+            case 2:
+                std::snprintf(line, sizeof line, "<ellipse cx=\"%d\" cy=\"%d\" rx=\"%d\" ry=\"%d\"/>\n", x, y,
+                              next(10) + 1, next(10) + 1);
+                break;
+            case 3:
+                std::snprintf(line, sizeof line, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\" stroke=\"#333\"/>\n", x,
+                              y, x + next(20), y + next(20));
+                break;
+            case 4:
+                std::snprintf(line, sizeof line, "<polyline points=\"%d,%d %d,%d %d,%d %d,%d\" fill=\"none\" stroke=\"#000\"/>\n",
+                              x, y, x + next(16), y + next(16), x + next(16), y + next(16), x + next(16), y + next(16));
+                break;
+            default:
+                std::snprintf(line, sizeof line, "<path d=\"M%d %dl%d %dq%d %d %d %dz\" opacity=\"0.8\"/>\n", x, y,
+                              next(16), next(16), next(16), next(16), next(16), next(16));
+                break;
+            }
+            xml += line;
+        }
+        if (elements)
+            xml += "</g>\n";
+        xml += "</svg>\n";
+        return xml;
+    }
+
+    bool Load(const std::filesystem::path &path, SvgDocument &document)
+    {
+        const std::string text = ReadFile(path);
+        if (text.empty())
+            return false;
+        SvgParser parser;
+        parser.Parse(text, document);
+        return true;
+    }
+
+    void DocumentSize(const SvgDocument &document, float &width, float &height)
+    {
+        width = document.GetWidth() > 0.0f ? document.GetWidth() : 800.0f;
+        height = document.GetHeight() > 0.0f ? document.GetHeight() : 600.0f;
+    }
+
+    SvgMatrix FitView(const SvgDocument &document, int longest, int &width, int &height)
+    {
+        float w, h;
+        DocumentSize(document, w, h);
+        const float scale = static_cast<float>(longest) / (std::max)(w, h);
+        width = (std::max)(1, static_cast<int>(std::ceil(w * scale)));
+        height = (std::max)(1, static_cast<int>(std::ceil(h * scale)));
+        return SvgMatrix{scale, 0.0f, 0.0f, scale, 0.0f, 0.0f};
+    }
+
+    SoftwarePixmap Draw(const SvgDocument &document, int longest)
+    {
+        int width, height;
+        const SvgMatrix view = FitView(document, longest, width, height);
+        SoftwarePixmap pixmap(width, height);
+        SoftwareRenderer renderer(pixmap, view);
+        document.Render(renderer);
+        return pixmap;
+    }
+
+    Image ToImage(const SoftwarePixmap &pixmap)
+    {
+        Image image;
+        image.width = pixmap.width;
+        image.height = pixmap.height;
+        image.rgba.resize(pixmap.pixels.size() * 4);
+        uint8_t *out = image.rgba.data();
+        for (uint32_t pixel : pixmap.pixels)
+        {
+            const uint32_t a = pixel >> 24;
+            for (int shift = 0; shift < 24; shift += 8)
+            {
+                const uint32_t c = (pixel >> shift) & 0xFF;
+                *out++ = static_cast<uint8_t>(a ? (std::min)(255u, (c * 255 + a / 2) / a) : 0);
+            }
+            *out++ = static_cast<uint8_t>(a);
+        }
+        return image;
+    }
+
+    bool ReadPng(const std::filesystem::path &path, Image &image)
+    {
+        png_image png{};
+        png.version = PNG_IMAGE_VERSION;
+        if (!png_image_begin_read_from_file(&png, path.string().c_str()))
+            return false;
+        png.format = PNG_FORMAT_RGBA;
+        image.width = static_cast<int>(png.width);
+        image.height = static_cast<int>(png.height);
+        image.rgba.resize(PNG_IMAGE_SIZE(png));
+        if (!png_image_finish_read(&png, nullptr, image.rgba.data(), 0, nullptr))
+        {
+            png_image_free(&png);
+            return false;
+        }
+        return true;
+    }
+
+    bool WritePng(const std::filesystem::path &path, const Image &image)
+    {
+        png_image png{};
+        png.version = PNG_IMAGE_VERSION;
+        png.width = static_cast<png_uint_32>(image.width);
+        png.height = static_cast<png_uint_32>(image.height);
+        png.format = PNG_FORMAT_RGBA;
+        std::filesystem::create_directories(path.parent_path());
+        return png_image_write_to_file(&png, path.string().c_str(), 0, image.rgba.data(), 0, nullptr) != 0;
+    }
+
+    size_t CountDifferences(const Image &a, const Image &b, int tolerance)
+    {
+        if (a.width != b.width || a.height != b.height || a.rgba.size() != b.rgba.size())
+            return static_cast<size_t>((std::max)(a.width * a.height, b.width * b.height));
+        size_t count = 0;
+        for (size_t i = 0; i < a.rgba.size(); i += 4)
+        {
+            for (size_t c = 0; c < 4; ++c)
+            {
+                if (std::abs(a.rgba[i + c] - b.rgba[i + c]) > tolerance)
+                {
+                    ++count;
+                    break;
+                }
+            }
+        }
+        return count;
+    }
+}
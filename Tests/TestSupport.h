@@ -0,0 +1,58 @@
+#ifndef _TESTSUPPORT_H_
+#define _TESTSUPPORT_H_
+
+#include "SoftwareRenderer.h"
+#include "SvgDocument.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// What the tests and benchmarks share: finding the fixtures, loading them,
+// drawing them the way the golden images were drawn, and reading and
+// writing those images.
+namespace TestSupport
+{
+    // TestCases/ in the source tree.
+    std::filesystem::path TestCasesDir();
+    // Every .svg under TestCases/set, sorted by name.
+    std::vector<std::filesystem::path> Fixtures(const std::string &set);
+    // Those of ms2, then of ms3.
+    std::vector<std::filesystem::path> Fixtures();
+    // "<set>_<name>" for a fixture, with what a test name cannot hold
+    // turned into '_'.
+    std::string FixtureName(const std::filesystem::path &path);
+    std::string ReadFile(const std::filesystem::path &path);
+
+    // A document of about elements shapes of every kind, in groups of 64
+    // with a transform and a fill each, spread over 4096 x 4096. The same
+    // count always gives the same bytes, about 50 of them per element.
+    std::string GenerateDocument(size_t elements);
+
+    // Parses path into document; false if it cannot be read.
+    bool Load(const std::filesystem::path &path, SvgDocument &document);
+
+    // The document's size, or the viewer's 800 x 600 if it gives none.
+    void DocumentSize(const SvgDocument &document, float &width, float &height);
+    // The view that fits the document into longest pixels on its longer
+    // side, and the pixmap it needs.
+    SvgMatrix FitView(const SvgDocument &document, int longest, int &width, int &height);
+    // The document drawn by one SoftwareRenderer under that view.
+    SoftwarePixmap Draw(const SvgDocument &document, int longest);
+
+    // Straight (not premultiplied) RGBA, four bytes a pixel, R first.
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> rgba;
+    };
+    Image ToImage(const SoftwarePixmap &pixmap);
+    bool ReadPng(const std::filesystem::path &path, Image &image);
+    bool WritePng(const std::filesystem::path &path, const Image &image);
+
+    // Pixels where some channel of a and b differs by more than tolerance;
+    // every pixel if their sizes differ.
+    size_t CountDifferences(const Image &a, const Image &b, int tolerance);
+}
+
+#endif
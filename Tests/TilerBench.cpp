@@ -0,0 +1,50 @@
+#include "Bench.h"
+#include "SoftwareTiler.h"
+#include "SvgScene.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+    // Thread scaling of SoftwareTiler against one SoftwareRenderer drawing
+    // the same view.
+    int TilerBench(const std::vector<std::string> &args)
+    {
+        const std::filesystem::path path =
+            args.size() > 0 ? std::filesystem::path(args[0]) : TestSupport::TestCasesDir() / "ms3" / "khtn.svg";
+        const int longest = args.size() > 1 ? std::stoi(args[1]) : 2048;
+        SvgDocument document;
+        if (!TestSupport::Load(path, document))
+        {
+            std::fprintf(stderr, "cannot read %s\n", path.string().c_str());
+            return 1;
+        }
+        int width, height;
+        const SvgMatrix view = TestSupport::FitView(document, longest, width, height);
+        const SvgScene scene(document);
+
+        std::printf("%s, %d x %d, %u hardware threads\n", path.filename().string().c_str(), width, height,
+                    std::thread::hardware_concurrency());
+        const double serial = Bench::Best(3, [&] {
+            SoftwarePixmap pixmap(width, height);
+            SoftwareRenderer renderer(pixmap, view);
+            document.Render(renderer);
+        });
+        std::printf("serial      %8.1f ms\n", serial * 1e3);
+        for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u})
+        {
+            SoftwareTiler tiler;
+            tiler.SetMaxThreads(threads);
+            const double tiled = Bench::Best(3, [&] {
+                SoftwarePixmap pixmap(width, height);
+                tiler.Render(scene, pixmap, view);
+            });
+            std::printf("%2u threads  %8.1f ms  %5.2fx serial\n", threads, tiled * 1e3, serial / tiled);
+        }
+        return 0;
+    }
+
+    const bool registered = Bench::Register("tiler", "[file.svg] [pixels]: tiled render time by thread count",
+                                            TilerBench);
+}